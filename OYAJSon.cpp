@@ -25,41 +25,419 @@
 #include "OYAJSon.h"
 #include <stdexcept>
 #include <regex>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <locale.h>
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+#include "OYAJSon_NumberTables.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace OYAJSon {
 
-    // ------------------------
-    // Couple of private function prototypes
-    void _ParseArray(const string_type &src, JSonValue& jval);
-    void _ParseObject(const string_type &src, JSonValue& jval);
-    inline string_type _trim(const string_type &s);
-    JSonType _DetermineType(const string_type &src);
-    string_type _StripCharacters(string_type s, string_type characters);
-    // ------------------------ Now back to the show.
-
-
-    JSonValue::JSonValue() : mDataType(JSonType_Null), mNumberInt(false){_ClearData();}
-    JSonValue::JSonValue(std::nullptr_t) : mDataType(JSonType_Null), mNumberInt(false){_ClearData();}
-    JSonValue::JSonValue(const JSonValue &value) : mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
-    JSonValue::JSonValue(const Object &value) : mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
-    JSonValue::JSonValue(const Array &value) : mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
-    JSonValue::JSonValue(const string_type& value) : mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
-    JSonValue::JSonValue(double value) : mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
-    JSonValue::JSonValue(int value) : mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
-    JSonValue::JSonValue(unsigned int value) : mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
-    JSonValue::JSonValue(long value) : mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
-    JSonValue::JSonValue(unsigned long value) : mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
-    JSonValue::JSonValue(long long value) : mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
-    JSonValue::JSonValue(float value) : mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
-    JSonValue::JSonValue(bool value) : mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
-    JSonValue::JSonValue(JSonType type) : mDataType(JSonType_Null), mNumberInt(false){
+/* --------------------------------------------------------------------------------------------
+ *  Number conversion support functions.
+ -------------------------------------------------------------------------------------------- */
+
+    inline unsigned int _LeadingZeros(std::uint64_t v){
+#if defined(__GNUC__)
+        return static_cast<unsigned int>(__builtin_clzll(v));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long idx;
+        _BitScanReverse64(&idx, v);
+        return 63 - static_cast<unsigned int>(idx);
+#else
+        unsigned int n = 0;
+        while ((v & (static_cast<std::uint64_t>(1) << 63)) == 0){
+            v <<= 1;
+            n++;
+        }
+        return n;
+#endif
+    }
+
+    // The full 128 bit product of a and b.
+    inline void _Multiply128(std::uint64_t a, std::uint64_t b, std::uint64_t &high, std::uint64_t &low){
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+        high = static_cast<std::uint64_t>(r >> 64);
+        low = static_cast<std::uint64_t>(r);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        low = _umul128(a, b, &high);
+#else
+        std::uint64_t aLo = a & 0xFFFFFFFF, aHi = a >> 32;
+        std::uint64_t bLo = b & 0xFFFFFFFF, bHi = b >> 32;
+        std::uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+        std::uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+        high = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+        low = (mid << 32) | (ll & 0xFFFFFFFF);
+#endif
+    }
+
+    // "00" through "99", so integers can be written two digits at a time.
+    static const char_type DIGIT_PAIRS[] =
+        "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+        "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+    // Writes value to out (which needs room for 20 characters), returning the end of what was written.
+    char_type* _FormatInt(long long value, char_type* out){
+        unsigned long long v = static_cast<unsigned long long>(value);
+        if (value < 0){
+            *out++ = '-';
+            v = 0 - v;
+        }
+
+        char_type digits[20];
+        char_type* head = digits + sizeof(digits);
+        while (v >= 100){
+            const char_type* pair = DIGIT_PAIRS + (v % 100) * 2;
+            v /= 100;
+            head -= 2;
+            head[0] = pair[0];
+            head[1] = pair[1];
+        }
+        if (v >= 10){
+            head -= 2;
+            head[0] = DIGIT_PAIRS[v * 2];
+            head[1] = DIGIT_PAIRS[v * 2 + 1];
+        } else {
+            *--head = static_cast<char_type>('0' + v);
+        }
+
+        size_type len = digits + sizeof(digits) - head;
+        std::memcpy(out, head, len);
+        return out + len;
+    }
+
+    /* Grisu2 (Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers", 2010).
+     *
+     * Finds the shortest run of digits that lies strictly between the neighbours of a double (more precisely, halfway
+     * to its neighbours), so that parsing those digits always gives back the very same double. Works entirely in 64 bit
+     * integers; the _DiyFp f * 2^e being a "do it yourself" floating point number with a 64 bit significand.
+     */
+    struct _DiyFp{
+        std::uint64_t f;
+        int e;
+    };
+
+    inline _DiyFp _DiyFpMul(const _DiyFp &x, const _DiyFp &y){
+        std::uint64_t high, low;
+        _Multiply128(x.f, y.f, high, low);
+        _DiyFp r = {high + (low >> 63), x.e + y.e + 64}; // Rounding the dropped half.
+        return r;
+    }
+
+    inline _DiyFp _DiyFpNormalize(_DiyFp x){
+        int shift = static_cast<int>(_LeadingZeros(x.f));
+        x.f <<= shift;
+        x.e -= shift;
+        return x;
+    }
+
+    // Grisu2 digit generation. Writes the digits of w (somewhere in (low, high)) to digits, and returns how many.
+    // The decimal exponent is adjusted so that w ~= digits * 10^decExp.
+    int _Grisu2Digits(char_type* digits, int &decExp, const _DiyFp &low, const _DiyFp &w, const _DiyFp &high){
+        std::uint64_t delta = high.f - low.f;
+        std::uint64_t dist = high.f - w.f;
+        const int shift = -high.e;
+        const std::uint64_t one = static_cast<std::uint64_t>(1) << shift;
+
+        // high = p1 + p2 * 2^e... the integral and fractional parts.
+        std::uint32_t p1 = static_cast<std::uint32_t>(high.f >> shift);
+        std::uint64_t p2 = high.f & (one - 1);
+
+        std::uint32_t pow10 = 1000000000;
+        int n = 10;
+        while (n > 1 && pow10 > p1){
+            pow10 /= 10;
+            n--;
+        }
+
+        int len = 0;
+        std::uint64_t rest;
+        std::uint64_t unit;
+        while (true){
+            if (n <= 0){
+                // The integral part is exhausted, so digits continue from the fractional part.
+                int m = 0;
+                do{
+                    p2 *= 10;
+                    digits[len++] = static_cast<char_type>('0' + (p2 >> shift));
+                    p2 &= one - 1;
+                    delta *= 10;
+                    dist *= 10;
+                    m++;
+                } while (p2 > delta);
+                decExp -= m;
+                rest = p2;
+                unit = one;
+                break;
+            }
+
+            digits[len++] = static_cast<char_type>('0' + p1 / pow10);
+            p1 %= pow10;
+            n--;
+            rest = (static_cast<std::uint64_t>(p1) << shift) + p2;
+            if (rest <= delta){
+                decExp += n;
+                unit = static_cast<std::uint64_t>(pow10) << shift;
+                break;
+            }
+            pow10 /= 10;
+        }
+
+        // Nudges the last digit down while that brings the digits closer to w without leaving (low, high).
+        while (rest < dist && delta - rest >= unit && (rest + unit < dist || dist - rest > rest + unit - dist)){
+            digits[len - 1]--;
+            rest += unit;
+        }
+        return len;
+    }
+
+    // Writes the shortest digits that parse back to value (which must be finite and positive) to digits, returning how
+    // many were written. value ~= digits * 10^decExp
+    int _Grisu2(double value, char_type* digits, int &decExp){
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const std::uint64_t hiddenBit = static_cast<std::uint64_t>(1) << 52;
+        std::uint64_t fraction = bits & (hiddenBit - 1);
+        int exponent = static_cast<int>(bits >> 52);
+
+        _DiyFp v;
+        if (exponent == 0){
+            v.f = fraction;
+            v.e = 1 - 1075;
+        } else {
+            v.f = fraction + hiddenBit;
+            v.e = exponent - 1075;
+        }
+
+        // The halfway points to the neighbouring doubles. The one below is closer should value be a power of two.
+        _DiyFp plus = {(v.f << 1) + 1, v.e - 1};
+        _DiyFp minus;
+        if (fraction == 0 && exponent > 1){
+            minus.f = (v.f << 2) - 1;
+            minus.e = v.e - 2;
+        } else {
+            minus.f = (v.f << 1) - 1;
+            minus.e = v.e - 1;
+        }
+        plus = _DiyFpNormalize(plus);
+        minus.f <<= minus.e - plus.e;
+        minus.e = plus.e;
+        v = _DiyFpNormalize(v);
+
+        // Scales everything by a cached power of ten, bringing the exponent into [-60, -32] where the integral part
+        // fits in 32 bits.
+        int f = -60 - plus.e - 1;
+        int k = (f * 78913) / (1 << 18) + (f > 0);
+        const _CachedPower &cached = CACHED_POW10[(-CACHED_POW10_MIN + k + (CACHED_POW10_STEP - 1)) / CACHED_POW10_STEP];
+        _DiyFp c = {cached.f, cached.e};
+
+        _DiyFp w = _DiyFpMul(v, c);
+        _DiyFp low = _DiyFpMul(minus, c);
+        _DiyFp high = _DiyFpMul(plus, c);
+        // The products may be off by one either way, so the range is narrowed to stay safe.
+        low.f++;
+        high.f--;
+
+        decExp = -cached.k;
+        return _Grisu2Digits(digits, decExp, low, w, high);
+    }
+
+    // Writes the shortest string that parses back to exactly value, returning the end of what was written. out needs
+    // room for 32 characters. Whole numbers keep a ".0" so they parse back as doubles. NaN and infinity have no JSon
+    // representation, and are written as null.
+    char_type* _FormatDouble(double value, char_type* out){
+        if (value != value || value - value != 0){
+            std::memcpy(out, "null", 4);
+            return out + 4;
+        }
+        if (std::signbit(value)){
+            *out++ = '-';
+            value = -value;
+        }
+        if (value == 0){
+            std::memcpy(out, "0.0", 3);
+            return out + 3;
+        }
+
+        char_type digits[20];
+        int decExp = 0;
+        int len = _Grisu2(value, digits, decExp);
+        // The decimal point falls after the first point digits.
+        int point = len + decExp;
+
+        if (len <= point && point <= 15){
+            // 1234000.0
+            std::memcpy(out, digits, len);
+            out += len;
+            std::memset(out, '0', point - len);
+            out += point - len;
+            std::memcpy(out, ".0", 2);
+            return out + 2;
+        }
+        if (0 < point && point <= 15){
+            // 12.34
+            std::memcpy(out, digits, point);
+            out += point;
+            *out++ = '.';
+            std::memcpy(out, digits + point, len - point);
+            return out + len - point;
+        }
+        if (-4 < point && point <= 0){
+            // 0.001234
+            *out++ = '0';
+            *out++ = '.';
+            std::memset(out, '0', -point);
+            out += -point;
+            std::memcpy(out, digits, len);
+            return out + len;
+        }
+
+        // 1.234e-56
+        *out++ = digits[0];
+        if (len > 1){
+            *out++ = '.';
+            std::memcpy(out, digits + 1, len - 1);
+            out += len - 1;
+        }
+        *out++ = 'e';
+        return _FormatInt(point - 1, out);
+    }
+
+
+/* --------------------------------------------------------------------------------------------
+ *  JSonMemoryResource
+ -------------------------------------------------------------------------------------------- */
+
+    class _HeapResource : public JSonMemoryResource{
+    protected:
+        void* do_allocate(size_type size, size_type alignment){return ::operator new(size);}
+        void do_deallocate(void* p, size_type size, size_type alignment){::operator delete(p);}
+    };
+
+    JSonMemoryResource* JSonHeapResource(){
+        static _HeapResource resource;
+        return &resource;
+    }
+
+    // Allocates a T from the given resource and constructs it in place.
+    template <typename T, typename... Args> inline T* _Create(JSonMemoryResource* resource, Args&&... args){
+        void* p = resource->allocate(sizeof(T), alignof(T));
+        try{
+            return new (p) T(std::forward<Args>(args)...);
+        } catch (...){
+            resource->deallocate(p, sizeof(T), alignof(T));
+            throw;
+        }
+    }
+
+    // Destroys a T created by _Create(), returning its memory to the given resource.
+    template <typename T> inline void _Destroy(T* obj, JSonMemoryResource* resource){
+        obj->~T();
+        resource->deallocate(obj, sizeof(T), alignof(T));
+    }
+
+
+/* --------------------------------------------------------------------------------------------
+ *  JSonValue
+ -------------------------------------------------------------------------------------------- */
+
+    JSonValue::JSonValue() : mData(), mDataType(JSonType_Null), mNumberInt(false){}
+    JSonValue::JSonValue(std::nullptr_t) : mData(), mDataType(JSonType_Null), mNumberInt(false){}
+    JSonValue::JSonValue(const JSonValue &value) : mData(), mDataType(JSonType_Null), mNumberInt(false){_CopyFrom(value);}
+    JSonValue::JSonValue(JSonValue &&value) noexcept : mData(value.mData), mDataType(value.mDataType), mNumberInt(value.mNumberInt){
+        value.mDataType = JSonType_Null;
+        value.mNumberInt = false;
+    }
+    JSonValue::JSonValue(const Object &value) : mData(), mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
+    JSonValue::JSonValue(const Array &value) : mData(), mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
+    JSonValue::JSonValue(Object &&value) : mData(), mDataType(JSonType_Null), mNumberInt(false){operator=(std::move(value));}
+    JSonValue::JSonValue(Array &&value) : mData(), mDataType(JSonType_Null), mNumberInt(false){operator=(std::move(value));}
+    JSonValue::JSonValue(const string_type& value) : mData(), mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
+    JSonValue::JSonValue(double value) : mData(), mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
+    JSonValue::JSonValue(int value) : mData(), mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
+    JSonValue::JSonValue(unsigned int value) : mData(), mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
+    JSonValue::JSonValue(long value) : mData(), mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
+    JSonValue::JSonValue(unsigned long value) : mData(), mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
+    JSonValue::JSonValue(long long value) : mData(), mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
+    JSonValue::JSonValue(float value) : mData(), mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
+    JSonValue::JSonValue(bool value) : mData(), mDataType(JSonType_Null), mNumberInt(false){operator=(value);}
+    JSonValue::JSonValue(const JSonValue &value, JSonMemoryResource* resource) : mData(), mDataType(JSonType_Null), mNumberInt(false){
+        if (resource == nullptr)
+            resource = JSonHeapResource();
+        switch(value.mDataType){
+        case JSonType_Object:{
+            // An Object already in the resource is shared, until either side changes it (see _Detach()) or lends it out.
+            _Shared<Object>* rep = value.mData._object;
+            if (!rep->pinned && !rep->lent && rep->value.get_allocator() == Object::allocator_type(resource)){
+                rep->refs.fetch_add(1, std::memory_order_relaxed);
+                mData._object = rep;
+                mDataType = JSonType_Object;
+                break;
+            }
+            _SetContainer(JSonType_Object, resource);
+            Object& members = mData._object->value;
+            const Object& from = value.mData._object->value;
+            members.reserve(from.size());
+            for (Object::const_iterator i = from.begin(); i != from.end(); i++)
+                members.emplace(i->first, i->second);
+            break;
+        }
+        case JSonType_Array:{
+            _Shared<Array>* rep = value.mData._array;
+            if (!rep->pinned && !rep->lent && rep->value.get_allocator() == Array::allocator_type(resource)){
+                rep->refs.fetch_add(1, std::memory_order_relaxed);
+                mData._array = rep;
+                mDataType = JSonType_Array;
+                break;
+            }
+            _SetContainer(JSonType_Array, resource);
+            Array& elements = mData._array->value;
+            const Array& from = value.mData._array->value;
+            elements.reserve(from.size());
+            for (Array::const_iterator i = from.begin(); i != from.end(); i++)
+                elements.emplace_back(*i, resource);
+            break;
+        }
+        case JSonType_String:
+            _SetString(value.mData._string->data, value.mData._string->size, resource); break;
+        default:
+            mData = value.mData;
+            mDataType = value.mDataType;
+            mNumberInt = value.mNumberInt;
+        }
+    }
+    JSonValue::JSonValue(JSonType type) : JSonValue(type, JSonHeapResource()){}
+    JSonValue::JSonValue(JSonType type, JSonMemoryResource* resource) : mData(), mDataType(JSonType_Null), mNumberInt(false){
+        if (resource == nullptr)
+            resource = JSonHeapResource();
         switch(type){
         case JSonType_Object:
-            operator=(Object()); break;
         case JSonType_Array:
-            operator=(Array()); break;
+            _SetContainer(type, resource); break;
         case JSonType_String:
-            operator=(""); break;
+            _SetString("", 0, resource); break;
         case JSonType_Number:
             operator=(0); break;
         case JSonType_Bool:
@@ -67,9 +445,7 @@ namespace OYAJSon {
         default: break;
         }
     }
-    JSonValue::~JSonValue(){
-        _ClearData();
-    }
+    JSonValue::~JSonValue(){_Release();}
 
     bool JSonValue::is(JSonType t) const{return mDataType == t;}
     bool JSonValue::is(const std::map<string_type, JSonType> &tmap) const{
@@ -78,7 +454,7 @@ namespace OYAJSon {
         for (std::map<string_type, JSonType>::const_iterator i = tmap.begin(); i != tmap.end(); i++){
             if (!has_key(i->first))
                 return false;
-            if (!mData->_object->at(i->first).is(i->second))
+            if (!mData._object->value.at(i->first).is(i->second))
                 return false;
         }
         return true;
@@ -87,10 +463,10 @@ namespace OYAJSon {
     bool JSonValue::is(const std::vector<JSonType> &tvec) const{
         if (mDataType != JSonType_Array)
             throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
-        if (tvec.size() != mData->_array->size())
+        if (tvec.size() != mData._array->value.size())
             return false;
         for (size_type i = 0; i != tvec.size(); i++){
-            if (!mData->_array->at(i).is(tvec[i]))
+            if (!mData._array->value.at(i).is(tvec[i]))
                 return false;
         }
         return true;
@@ -103,111 +479,174 @@ namespace OYAJSon {
 
 
     void JSonValue::set(const JSonValue& value){
-        switch(value.mDataType){
-        case JSonType_Object:
-        case JSonType_Array:
-        case JSonType_String:
-            mData = value.mData;
-            mDataType = value.mDataType;
-            break;
-        case JSonType_Number:
-            if (value.mNumberInt){
-                operator=(value.mData->_numberi);
-            } else {
-                operator=(value.mData->_number);
-            }
-            break;
-        case JSonType_Bool:
-            operator=(value.mData->_bool); break;
-        default:
-            _ClearData(); // It's now a null type
-        }
+        _CopyFrom(value);
+    }
+
+    void JSonValue::set(JSonValue&& value){
+        operator=(std::move(value));
     }
 
     void JSonValue::set(const std::initializer_list<std::pair<string_type, JSonValue> > &ol){
-        _ClearData();
+        _Shared<Object>* rep = _Create<_Shared<Object> >(JSonHeapResource(), Object(ol));
+        _Release();
+        mData._object = rep;
         mDataType = JSonType_Object;
-        mData->_object = new Object(ol.begin(), ol.end());
     }
 
     void JSonValue::set(const std::initializer_list<JSonValue> &al){
-        _ClearData();
+        _Shared<Array>* rep = _Create<_Shared<Array> >(JSonHeapResource(), Array(al.begin(), al.end()));
+        _Release();
+        mData._array = rep;
         mDataType = JSonType_Array;
-        mData->_array = new Array(al.begin(), al.end());
     }
 
     Object& JSonValue::get_object(){
-        if (mDataType == JSonType_Object)
-            return *(mData->_object);
+        if (mDataType == JSonType_Object){
+            _Lend();
+            return mData._object->value;
+        }
         throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
     }
 
     Array& JSonValue::get_array(){
-        if (mDataType == JSonType_Array)
-            return *(mData->_array);
+        if (mDataType == JSonType_Array){
+            _Lend();
+            return mData._array->value;
+        }
+        throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
+    }
+
+    const Object& JSonValue::get_object() const{
+        if (mDataType == JSonType_Object)
+            return mData._object->value;
         throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
     }
 
-    void JSonValue::insert(const string_type &key, JSonValue &value){
+    const Array& JSonValue::get_array() const{
+        if (mDataType == JSonType_Array)
+            return mData._array->value;
+        throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
+    }
+
+    void JSonValue::insert(const string_type &key, const JSonValue &value){
+        if (mDataType != JSonType_Object)
+            throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
+        _Detach();
+        if (!mData._object->value.emplace(key, value).second)
+            throw std::runtime_error("Key already exists in JSon Object.");
+    }
+
+    void JSonValue::insert(const string_type &key, JSonValue &&value){
         if (mDataType != JSonType_Object)
             throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
-        if (mData->_object->find(key) != mData->_object->end())
+        _Detach();
+        if (!mData._object->value.emplace(key, std::move(value)).second)
             throw std::runtime_error("Key already exists in JSon Object.");
-        mData->_object->insert({key, value});
     }
 
-    void JSonValue::insert(size_type pos, JSonValue &value){
+    void JSonValue::insert(size_type pos, const JSonValue &value){
         if (mDataType != JSonType_Array)
             throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
-        if (pos >= mData->_array->size()){
-            mData->_array->push_back(value);
+        _Detach();
+        if (pos >= mData._array->value.size()){
+            mData._array->value.push_back(value);
         } else {
-            mData->_array->insert(mData->_array->begin()+pos, value);
+            mData._array->value.insert(mData._array->value.begin()+pos, value);
         }
     }
 
-    void JSonValue::insert(Array::iterator i, JSonValue &value){
+    void JSonValue::insert(size_type pos, JSonValue &&value){
+        if (mDataType != JSonType_Array)
+            throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
+        _Detach();
+        if (pos >= mData._array->value.size()){
+            mData._array->value.push_back(std::move(value));
+        } else {
+            mData._array->value.insert(mData._array->value.begin()+pos, std::move(value));
+        }
+    }
+
+    void JSonValue::insert(Array::iterator i, const JSonValue &value){
+        if (mDataType != JSonType_Array)
+            throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
+        size_type pos = i - mData._array->value.begin();
+        _Detach();
+        mData._array->value.insert(mData._array->value.begin() + pos, value);
+    }
+
+    void JSonValue::insert(Array::iterator i, JSonValue &&value){
+        if (mDataType != JSonType_Array)
+            throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
+        size_type pos = i - mData._array->value.begin();
+        _Detach();
+        mData._array->value.insert(mData._array->value.begin() + pos, std::move(value));
+    }
+
+    void JSonValue::push_back(const JSonValue &value){
         if (mDataType != JSonType_Array)
             throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
-        mData->_array->insert(i, value);
+        _Detach();
+        mData._array->value.push_back(value);
     }
 
-    void JSonValue::push_back(JSonValue &value){
+    void JSonValue::push_back(JSonValue &&value){
         if (mDataType != JSonType_Array)
             throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
-        mData->_array->push_back(value);
+        _Detach();
+        mData._array->value.push_back(std::move(value));
     }
 
-    JSonValue& JSonValue::at(const string_type &key){
+    JSonValue& JSonValue::at(const StringView &key){
         if (mDataType == JSonType_Object){
-            Object::iterator i = mData->_object->find(key);
-            if (i != mData->_object->end())
+            _Lend();
+            Object::iterator i = mData._object->value.find(key);
+            if (i != mData._object->value.end())
                 return i->second;
-            throw JSonException::MissingKey(key);
+            throw JSonException::MissingKey(key.str());
         }
         throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
     }
 
     JSonValue& JSonValue::at(size_type index){
         if (mDataType == JSonType_Array){
-            if (index >= mData->_array->size())
+            if (index >= mData._array->value.size())
+                throw JSonException::IndexOutOfBounds(index);
+            _Lend();
+            return mData._array->value.at(index);
+        }
+        throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
+    }
+
+    const JSonValue& JSonValue::at(const StringView &key) const{
+        if (mDataType == JSonType_Object){
+            Object::const_iterator i = mData._object->value.find(key);
+            if (i != mData._object->value.end())
+                return i->second;
+            throw JSonException::MissingKey(key.str());
+        }
+        throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
+    }
+
+    const JSonValue& JSonValue::at(size_type index) const{
+        if (mDataType == JSonType_Array){
+            if (index >= mData._array->value.size())
                 throw JSonException::IndexOutOfBounds(index);
-            return mData->_array->at(index);
+            return mData._array->value[index];
         }
         throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
     }
 
-    bool JSonValue::has_key(const string_type &key) const{
+    bool JSonValue::has_key(const StringView &key) const{
         if (mDataType != JSonType_Object)
             throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
-        return mData->_object->find(key) != mData->_object->end();
+        return mData._object->value.find(key) != mData._object->value.end();
     }
 
     bool JSonValue::has_keys(const std::vector<string_type> &keys) const{
         if (mDataType != JSonType_Object)
             throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
         for (std::vector<string_type>::const_iterator i = keys.begin(); i != keys.end(); i++){
-            if (mData->_object->find(*i) == mData->_object->end())
+            if (mData._object->value.find(*i) == mData._object->value.end())
                 return false;
         }
         return true;
@@ -216,11 +655,11 @@ namespace OYAJSon {
     size_type JSonValue::size() const{
         switch(mDataType){
         case JSonType_Object:
-            return mData->_object->size();
+            return mData._object->value.size();
         case JSonType_Array:
-            return mData->_array->size();
+            return mData._array->value.size();
         case JSonType_String:
-            return mData->_string->size();
+            return mData._string->size;
         case JSonType_Number:
         case JSonType_Bool:
             return 1;
@@ -229,29 +668,6 @@ namespace OYAJSon {
         return 0;
     }
 
-    JSonValue& JSonValue::parse(const string_type &jsonstr){
-        string_type jsrc = _StripCharacters(_trim(jsonstr), "\r\n\t\f\v");
-        JSonType jtype = JSonType_Null;
-        try{
-            jtype = _DetermineType(jsrc);
-        } catch(JSonException e) {
-            throw e;
-        }
-
-        switch(jtype){
-        case JSonType_Object:
-            _ParseObject(jsrc, *this);
-            break;
-        case JSonType_Array:
-            _ParseArray(jsrc, *this);
-            break;
-        default:
-            throw JSonException::ParseInvalidJsonContainer();
-        }
-
-        return *this;
-    }
-
     string_type JSonValue::to_str() const{
         switch(mDataType){
         case JSonType_Object:
@@ -261,140 +677,118 @@ namespace OYAJSon {
         case JSonType_Null:
             return "null";
         case JSonType_String:
-            return *(mData->_string);
+            return string_type(mData._string->data, mData._string->size);
         case JSonType_Bool:
-            return mData->_bool ? "true" : "false";
+            return mData._bool ? "true" : "false";
         }
         return std::string();
     }
 
     string_type JSonValue::serialize(const string_type& indentStr, size_type depth) const{
-        string_type serial = "";
-        string_type eol = ""; // eol = End of Line (symbol, only used when serializing Arrays and Objects)
-        bool past_first_element = false;
-
-        string_type ind = ""; // ind = Indent Spacing (Used only once, unless serializing Objects or Arrays)
-        for (size_type d = 0; d < depth; d++)
-            ind += indentStr;
-        //serial = ind;
-
-        if (indentStr.size() > 0){
-            eol = "\n";
-        }
-
-        switch(mDataType){
-        case JSonType_Null:
-        case JSonType_Bool:
-            serial += to_str();
-            break;
-        case JSonType_Number:
-            {
-                char buf[256];
-                if (mNumberInt){
-                    snprintf(buf, sizeof(buf), "%lld", mData->_numberi);
-                } else {
-                    snprintf(buf, sizeof(buf), "%g", mData->_number);
-                }
-                serial += buf;
-            }
-            break;
-        case JSonType_Object:
-            serial += "{" + eol;
-            for (Object::iterator i = mData->_object->begin(); i != mData->_object->end(); i++){
-                if (past_first_element){serial += "," + eol;}
-                serial += ind + indentStr + string_type("\"") + i->first + string_type("\" : ") + i->second.serialize(indentStr, depth+1);
-                past_first_element = true;
-            }
-            serial += eol + ind + "}";
-            break;
-        case JSonType_Array:
-            serial += "[" + eol;
-            for (Array::iterator i = mData->_array->begin(); i != mData->_array->end(); i++){
-                if (past_first_element){serial += "," + eol;}
-                serial += ind + indentStr + (*i).serialize(indentStr, depth+1);
-                past_first_element = true;
-            }
-            serial += eol + ind + "]";
-            break;
-        case JSonType_String:
-            serial += Serialize_str(*(mData->_string));
-        }
-
+        string_type serial;
+        JSonStringSink sink(serial);
+        JSonWriter writer(sink, indentStr, depth);
+        writer.write(*this);
+        writer.flush();
         return serial;
     }
 
 
     JSonValue JSonValue::copy() const{
-        JSonValue v(mDataType);
+        return JSonValue(*this);
+    }
 
+    JSonValue JSonValue::share(){
+        JSonValue v;
+        // Copies of this JSonValue mustn't see the changes made through the JSonValue returned, so they're left behind.
+        _Detach();
         switch(mDataType){
         case JSonType_Object:
-            for (Object::iterator i = mData->_object->begin(); i != mData->_object->end(); i++){
-                v.mData->_object->insert({i->first, i->second.copy()});
-            }
+            mData._object->pinned = true;
+            mData._object->refs.fetch_add(1, std::memory_order_relaxed);
             break;
         case JSonType_Array:
-            for (Array::iterator i = mData->_array->begin(); i != mData->_array->end(); i++){
-                v.mData->_array->push_back(i->copy());
-            }
-            break;
-        case JSonType_String:
-            (*v.mData->_string) = (*mData->_string);
-            break;
-        case JSonType_Number:
-            if (mNumberInt){
-                v.mNumberInt = true;
-                v.mData->_numberi = mData->_numberi;
-            } else {
-                v.mData->_number = mData->_number;
-            }
-            break;
-        case JSonType_Bool:
-            v.mData->_bool = mData->_bool;
+            mData._array->pinned = true;
+            mData._array->refs.fetch_add(1, std::memory_order_relaxed);
             break;
         default:
-            break;
+            v._CopyFrom(*this);
+            return v;
         }
-
+        v.mData = mData;
+        v.mDataType = mDataType;
         return v;
     }
 
     JSonValue& JSonValue::operator=(const JSonValue &rhs){
-        set(rhs);
+        _CopyFrom(rhs);
+        return *this;
+    }
+
+    JSonValue& JSonValue::operator=(JSonValue &&rhs) noexcept{
+        if (this != &rhs){
+            // rhs may live within the Array or Object being released, so it's emptied before anything is released.
+            _data data = rhs.mData;
+            JSonType type = rhs.mDataType;
+            bool numberInt = rhs.mNumberInt;
+            rhs.mDataType = JSonType_Null;
+            rhs.mNumberInt = false;
+
+            _Release();
+            mData = data;
+            mDataType = type;
+            mNumberInt = numberInt;
+        }
         return *this;
     }
 
     JSonValue& JSonValue::operator=(const Object &rhs){
-        _ClearData();
-        mData->_object = new Object(rhs.begin(), rhs.end());
+        _Shared<Object>* rep = _Create<_Shared<Object> >(JSonHeapResource(), rhs);
+        _Release();
+        mData._object = rep;
         mDataType = JSonType_Object;
         return *this;
     }
 
     JSonValue& JSonValue::operator=(const Array &rhs){
-        _ClearData();
-        mData->_array = new Array(rhs.begin(), rhs.end());
+        _Shared<Array>* rep = _Create<_Shared<Array> >(JSonHeapResource(), rhs);
+        _Release();
+        mData._array = rep;
+        mDataType = JSonType_Array;
+        return *this;
+    }
+
+    // The moved Object and Array keep their allocator, so the _Shared holding them is allocated from the same resource.
+    JSonValue& JSonValue::operator=(Object &&rhs){
+        _Shared<Object>* rep = _Create<_Shared<Object> >(rhs.get_allocator().resource(), std::move(rhs));
+        _Release();
+        mData._object = rep;
+        mDataType = JSonType_Object;
+        return *this;
+    }
+
+    JSonValue& JSonValue::operator=(Array &&rhs){
+        _Shared<Array>* rep = _Create<_Shared<Array> >(rhs.get_allocator().resource(), std::move(rhs));
+        _Release();
+        mData._array = rep;
         mDataType = JSonType_Array;
         return *this;
     }
 
     JSonValue& JSonValue::operator=(const string_type &rhs){
-        _ClearData();
-        mData->_string = new string_type(rhs.begin(), rhs.end());
-        mDataType = JSonType_String;
+        _SetString(rhs.data(), rhs.size(), JSonHeapResource());
         return *this;
     }
 
     JSonValue& JSonValue::operator=(std::nullptr_t rhs){
-        _ClearData(); // This method sets mDataType to JSonType_Null for me already. No need to do that explicitly.
+        _Release(); // This method sets mDataType to JSonType_Null for me already. No need to do that explicitly.
         return *this;
     }
 
     JSonValue& JSonValue::operator=(double rhs){
-        _ClearData();
-        mData->_number = rhs;
+        _Release();
+        mData._number = rhs;
         mDataType = JSonType_Number;
-        mNumberInt = false;
         return *this;
     }
 
@@ -415,8 +809,8 @@ namespace OYAJSon {
     }
 
     JSonValue& JSonValue::operator=(long long rhs){
-        _ClearData();
-        mData->_numberi = rhs;
+        _Release();
+        mData._numberi = rhs;
         mDataType = JSonType_Number;
         mNumberInt = true;
         return *this;
@@ -427,8 +821,8 @@ namespace OYAJSon {
     }
 
     JSonValue& JSonValue::operator=(bool rhs){
-        _ClearData();
-        mData->_bool = rhs;
+        _Release();
+        mData._bool = rhs;
         mDataType = JSonType_Bool;
         return *this;
     }
@@ -437,15 +831,18 @@ namespace OYAJSon {
         if (mDataType == rhs.type()){
             switch(mDataType){
             case JSonType_Array:
-                return *(mData->_array) == *(rhs.mData->_array);
+                return mData._array->value == rhs.mData._array->value;
             case JSonType_Object:
-                return *(mData->_object) == *(rhs.mData->_object);
+                return mData._object->value == rhs.mData._object->value;
             case JSonType_String:
-                return *(mData->_string) == *(rhs.mData->_string);
+                return mData._string->size == rhs.mData._string->size &&
+                       std::memcmp(mData._string->data, rhs.mData._string->data, mData._string->size) == 0;
             case JSonType_Number:
-                return mData->_number == rhs.mData->_number;
+                if (mNumberInt && rhs.mNumberInt)
+                    return mData._numberi == rhs.mData._numberi;
+                return get<double>() == rhs.get<double>();
             case JSonType_Bool:
-                return mData->_bool == rhs.mData->_bool;
+                return mData._bool == rhs.mData._bool;
             default: break;
             }
             return true; // Should only get here is the type is NULL... and is both are null, then they're equal.
@@ -457,498 +854,2994 @@ namespace OYAJSon {
         return !operator==(rhs);
     }
 
-    JSonValue& JSonValue::operator[](const string_type &key){
+    JSonValue& JSonValue::operator[](const StringView &key){
         if (mDataType != JSonType_Object)
             throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
-        Object::iterator val = mData->_object->find(key);
-        if (val == mData->_object->end()){
-            mData->_object->insert({key, JSonValue()});
-            val = mData->_object->find(key);
-            //throw JSonException::KeyNotInObject(key);
-        }
-        return val->second;
+        _Lend();
+        return mData._object->value[key];
     }
 
     JSonValue& JSonValue::operator[](size_type index){
         if (mDataType != JSonType_Array)
             throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
-        if (index >= mData->_array->size())
+        if (index >= mData._array->value.size())
             throw JSonException::IndexOutOfBounds(index);
-        return mData->_array->at(index);
+        _Lend();
+        return mData._array->value[index];
     }
 
+    const JSonValue& JSonValue::operator[](const StringView &key) const{
+        return at(key);
+    }
 
-    void JSonValue::_ClearData(){
-        mData = std::shared_ptr<_data>(new _data, [=](_data* d){
-            switch (mDataType){
-            case JSonType_Array:
-                delete d->_array; break;
-            case JSonType_Object:
-                delete d->_object; break;
-            case JSonType_String:
-                delete d->_string; break;
-            default: break;
-            }
-            delete d;
-            d = nullptr;
-        });
+    const JSonValue& JSonValue::operator[](size_type index) const{
+        return at(index);
+    }
+
+
+    /* Releases one reference to a _Shared Array or Object, deleting it with the last. A JSonValue that was never
+     * copied or share()d holds the only reference, and skips the atomic decrement altogether.
+     */
+    template <typename T> inline void _ReleaseShared(T* rep){
+        if (rep->refs.load(std::memory_order_acquire) == 1 || rep->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            _Destroy(rep, rep->value.get_allocator().resource());
+    }
+
+    /* Gives a JSonValue about to be changed an Array or Object of its own, should it share one with copies of itself.
+     * The new Array or Object is allocated from the same resource. Its elements are copies too, sharing their own Arrays
+     * and Objects until they're changed in turn... so only the path that's changed is ever copied.
+     */
+    template <typename T> inline T* _DetachShared(T* rep){
+        if (rep->refs.load(std::memory_order_acquire) == 1 || rep->pinned)
+            return rep;
+        JSonMemoryResource* resource = rep->value.get_allocator().resource();
+        T* copy = _Create<T>(resource, rep->value, resource);
+        _ReleaseShared(rep);
+        return copy;
+    }
+
+    void JSonValue::_Detach(){
+        if (mDataType == JSonType_Object)
+            mData._object = _DetachShared(mData._object);
+        else if (mDataType == JSonType_Array)
+            mData._array = _DetachShared(mData._array);
+    }
+
+    /* Detaches a JSonValue about to hand out a reference, or iterator, into its Array or Object, and marks that Array or
+     * Object lent. The reference may be written through at any time after, so from then on copies get one of their own
+     * rather than sharing it (see the JSonValue copy constructor).
+     */
+    void JSonValue::_Lend(){
+        if (mDataType == JSonType_Object){
+            mData._object = _DetachShared(mData._object);
+            mData._object->lent = true;
+        } else if (mDataType == JSonType_Array){
+            mData._array = _DetachShared(mData._array);
+            mData._array->lent = true;
+        }
+    }
+
+    void JSonValue::_CopyFrom(const JSonValue& value){
+        // value may live within the Array or Object being released... so nothing is read from it after _Release().
+        JSonType type = value.mDataType;
+        switch(type){
+        case JSonType_Object:
+        case JSonType_Array:
+            operator=(JSonValue(value, JSonHeapResource()));
+            return;
+        case JSonType_String:
+            _SetString(value.mData._string->data, value.mData._string->size, JSonHeapResource());
+            return;
+        default:{
+            _data data = value.mData;
+            bool numberInt = value.mNumberInt;
+            _Release();
+            mData = data;
+            mNumberInt = numberInt;
+        }
+        }
+        mDataType = type;
+    }
+
+    void JSonValue::_Release(){
+        switch (mDataType){
+        case JSonType_Array:
+            _ReleaseShared(mData._array); break;
+        case JSonType_Object:
+            _ReleaseShared(mData._object); break;
+        case JSonType_String:
+            mData._string->resource->deallocate(mData._string, offsetof(_String, data) + mData._string->size + 1, alignof(_String));
+            break;
+        default: break;
+        }
         mDataType = JSonType_Null;
+        mNumberInt = false;
     }
 
-    string_type JSonValue::Serialize_str(const string_type& s) const{
-        string_type serial = "";
-        for (string_type::const_iterator i = s.begin(); i != s.end(); i++){
-            switch (*i){
-            case '"':
-                serial += "\\\""; break;
-            case '\\':
-                serial += "\\\\"; break;
-            case '/':
-                serial += "\\/"; break;
-            case '\b':
-                serial += "\\b"; break;
-            case '\f':
-                serial += "\\f"; break;
-            case '\n':
-                serial += "\\n"; break;
-            case '\r':
-                serial += "\\r"; break;
-            case '\t':
-                serial += "\\t"; break;
-            default:
-                serial += *i;
-            }
+    void JSonValue::_SetString(const char_type* str, size_type size, JSonMemoryResource* resource){
+        _String* rep = static_cast<_String*>(resource->allocate(offsetof(_String, data) + size + 1, alignof(_String)));
+        rep->resource = resource;
+        rep->size = size;
+        std::memcpy(rep->data, str, size);
+        rep->data[size] = '\0';
+        _Release();
+        mData._string = rep;
+        mDataType = JSonType_String;
+    }
+
+    void JSonValue::_SetContainer(JSonType type, JSonMemoryResource* resource){
+        if (type == JSonType_Object){
+            _Shared<Object>* rep = _Create<_Shared<Object> >(resource, resource);
+            _Release();
+            mData._object = rep;
+        } else {
+            _Shared<Array>* rep = _Create<_Shared<Array> >(resource, resource);
+            _Release();
+            mData._array = rep;
         }
-        serial.insert(0, "\"");
-        serial.insert(serial.size(), "\"");
-        return serial;
+        mDataType = type;
     }
 
+    void JSonValue::_SetArray(JSonValue* values, size_type count, JSonMemoryResource* resource){
+        _Shared<Array>* rep = _Create<_Shared<Array> >(resource, resource);
+        rep->value.reserve(count);
+        for (size_type i = 0; i < count; i++)
+            rep->value.push_back(std::move(values[i]));
+        _Release();
+        mData._array = rep;
+        mDataType = JSonType_Array;
+    }
 
+    void JSonValue::_Forget(){
+        mDataType = JSonType_Null;
+        mNumberInt = false;
+    }
 
 /* --------------------------------------------------------------------------------------------
- *  Parsing methods and support functions.
+ *  JSonKey and JSonObject
  -------------------------------------------------------------------------------------------- */
 
-    //inline string_type _ltrim(string_type s){
-    //    s.erase(s.begin(), std::find_if(s.begin(), s.end(), std::not1(std::ptr_fun<int, int>(std::isspace))));
-    //    return s;
-    //}
-
-    inline string_type _ltrim(const string_type &s){
-        string_type ns(s);
-        ns.erase(ns.begin(), std::find_if(ns.begin(), ns.end(), std::not1(std::ptr_fun<int, int>(std::isspace))));
-        return ns;
+    // Hashes the given characters eight at a time.
+    static std::uint32_t _HashKey(const char_type* key, size_type size){
+        const std::uint64_t MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+        std::uint64_t h = MULTIPLIER ^ size;
+        std::uint64_t word;
+        for (; size >= 8; key += 8, size -= 8){
+            std::memcpy(&word, key, 8);
+            h = (h ^ word) * MULTIPLIER;
+            h ^= h >> 29;
+        }
+        if (size > 0){
+            word = 0;
+            std::memcpy(&word, key, size);
+            h = (h ^ word) * MULTIPLIER;
+            h ^= h >> 29;
+        }
+        return static_cast<std::uint32_t>((h * MULTIPLIER) >> 32);
     }
 
-    //inline string_type _rtrim(string_type s){
-    //    s.erase(std::find_if(s.rbegin(), s.rend(), std::not1(std::ptr_fun<int, int>(std::isspace))).base(), s.end());
-    //    return s;
-    //}
+    static const std::uint32_t EMPTY_KEY_HASH = _HashKey("", 0);
 
-    inline string_type _rtrim(const string_type &s){
-        string_type ns(s);
-        ns.erase(std::find_if(ns.rbegin(), ns.rend(), std::not1(std::ptr_fun<int, int>(std::isspace))).base(), ns.end());
-        return ns;
-    }
+    JSonKey::JSonKey() : mRep(0){}
 
-    //inline string_type _trim(string_type s){
-    //    return _ltrim(_rtrim(s));
-    //}
+    JSonKey::JSonKey(const StringView &key, JSonMemoryResource* resource) : mRep(0){
+        _Assign(key.data(), key.size(), _HashKey(key.data(), key.size()), resource);
+    }
 
-    inline string_type _trim(const string_type &s){
-        string_type ns(s);
-        return _ltrim(_rtrim(ns));
+    JSonKey::JSonKey(const JSonKey &key) : mRep(0){
+        if (key.mRep != 0)
+            _Assign(key._Get()->data, key._Get()->size, key._Get()->hash, nullptr);
     }
 
-    inline string_type _strtolower(string_type s){
-        for (string_type::iterator i = s.begin(); i != s.end(); i++){
-            (*i) = std::tolower(*i);
-        }
-        return s;
+    JSonKey::JSonKey(const JSonKey &key, JSonMemoryResource* resource) : mRep(0){
+        if (key.mRep != 0)
+            _Assign(key._Get()->data, key._Get()->size, key._Get()->hash, resource);
     }
 
-    // A dead simple caseless equality check.
-    bool _icaseeq(const string_type s1, const string_type s2){
-        if (s1.size() != s2.size()){return false;}
-        for (size_type i = 0; i < s1.size(); i++){
-            if (tolower(s1[i]) != tolower(s2[i]))
-                return false;
-        }
-        return true;
+    JSonKey::JSonKey(JSonKey &&key) noexcept : mRep(key.mRep){
+        key.mRep = 0;
     }
 
-    string_type _deserializeChars(string_type s){
-        bool escaped = false;
-        size_t i = 0;
+    JSonKey::~JSonKey(){_Release();}
 
-        // Stripping the head and tail quotations from the string.
-        s = s.substr(1, s.size()-2);
+    JSonKey& JSonKey::operator=(const JSonKey &rhs){
+        if (rhs.mRep == 0)
+            _Release();
+        else if (this != &rhs)
+            _Assign(rhs._Get()->data, rhs._Get()->size, rhs._Get()->hash, (mRep & INTERNED) == 0 && mRep != 0 ? _Get()->resource : nullptr);
+        return *this;
+    }
 
-        while (i != s.size()){
-            switch (s[i]){
-            case '\\':
-                if (escaped){
-                    s.replace(i-1, 2, "\\");
-                    escaped = false;
+    JSonKey& JSonKey::operator=(JSonKey &&rhs) noexcept{
+        if (this != &rhs){
+            _Release();
+            mRep = rhs.mRep;
+            rhs.mRep = 0;
+        }
+        return *this;
+    }
+
+    const char_type* JSonKey::data() const{return mRep != 0 ? _Get()->data : "";}
+    const char_type* JSonKey::c_str() const{return data();}
+    size_type JSonKey::size() const{return mRep != 0 ? _Get()->size : 0;}
+    bool JSonKey::empty() const{return size() == 0;}
+    std::uint32_t JSonKey::hash() const{return mRep != 0 ? _Get()->hash : EMPTY_KEY_HASH;}
+    string_type JSonKey::str() const{return string_type(data(), size());}
+    StringView JSonKey::view() const{return StringView(data(), size());}
+
+    bool JSonKey::operator==(const JSonKey &rhs) const{
+        if (_Get() == rhs._Get())
+            return true;
+        return hash() == rhs.hash() && size() == rhs.size() && std::memcmp(data(), rhs.data(), size()) == 0;
+    }
+
+    bool JSonKey::operator==(const StringView &rhs) const{
+        return size() == rhs.size() && std::memcmp(data(), rhs.data(), rhs.size()) == 0;
+    }
+
+    void JSonKey::_Assign(const char_type* key, size_type size, std::uint32_t hash, JSonMemoryResource* resource){
+        if (size > std::numeric_limits<std::uint32_t>::max())
+            throw std::length_error("JSon Object key is too long.");
+        if (resource == nullptr)
+            resource = JSonHeapResource();
+        _Rep* rep = static_cast<_Rep*>(resource->allocate(offsetof(_Rep, data) + size + 1, alignof(_Rep)));
+        rep->resource = resource;
+        rep->size = static_cast<std::uint32_t>(size);
+        rep->hash = hash;
+        std::memcpy(rep->data, key, size);
+        rep->data[size] = '\0';
+        _Release();
+        mRep = reinterpret_cast<std::uintptr_t>(rep);
+    }
+
+    void JSonKey::_Release(){
+        // An interned key's _Rep belongs to its JSonKeyPool, and may already be gone.
+        if (mRep != 0 && (mRep & INTERNED) == 0)
+            _Get()->resource->deallocate(_Get(), offsetof(_Rep, data) + _Get()->size + 1, alignof(_Rep));
+        mRep = 0;
+    }
+
+    std::ostream& operator<<(std::ostream& os, const JSonKey &key){
+        return os.write(key.data(), key.size());
+    }
+
+
+    JSonObject::JSonObject() : mIndex(nullptr), mIndexSize(0){}
+    JSonObject::JSonObject(const allocator_type &alloc) : mMembers(alloc), mIndex(nullptr), mIndexSize(0){}
+
+    JSonObject::JSonObject(std::initializer_list<std::pair<string_type, JSonValue> > members, const allocator_type &alloc) :
+        mMembers(alloc), mIndex(nullptr), mIndexSize(0){
+        reserve(members.size());
+        for (std::initializer_list<std::pair<string_type, JSonValue> >::const_iterator i = members.begin(); i != members.end(); i++)
+            insert(*i);
+    }
+
+    JSonObject::JSonObject(const JSonObject &obj) : mMembers(obj.mMembers), mIndex(nullptr), mIndexSize(0){
+        _Reindex(mMembers.size());
+    }
+
+    JSonObject::JSonObject(const JSonObject &obj, const allocator_type &alloc) : mMembers(obj.mMembers, alloc), mIndex(nullptr), mIndexSize(0){
+        _Reindex(mMembers.size());
+    }
+
+    JSonObject::JSonObject(JSonObject &&obj) noexcept : mMembers(std::move(obj.mMembers)), mIndex(obj.mIndex), mIndexSize(obj.mIndexSize){
+        obj.mIndex = nullptr;
+        obj.mIndexSize = 0;
+    }
+
+    JSonObject::~JSonObject(){_ReleaseIndex();}
+
+    JSonObject& JSonObject::operator=(const JSonObject &rhs){
+        if (this != &rhs)
+            operator=(JSonObject(rhs, get_allocator()));
+        return *this;
+    }
+
+    JSonObject& JSonObject::operator=(JSonObject &&rhs){
+        if (this == &rhs)
+            return *this;
+        // rhs may live within one of this Object's members, so it's emptied into from before anything is released.
+        JSonObject from(get_allocator());
+        if (get_allocator() == rhs.get_allocator()){
+            from._Swap(rhs);
+        } else {
+            from.mMembers.reserve(rhs.mMembers.size());
+            for (iterator i = rhs.mMembers.begin(); i != rhs.mMembers.end(); i++)
+                from.mMembers.push_back(std::move(*i));
+            from._Reindex(from.mMembers.size());
+            rhs.clear();
+        }
+        _Swap(from);
+        return *this;
+    }
+
+    JSonObject::allocator_type JSonObject::get_allocator() const{return mMembers.get_allocator();}
+
+    JSonObject::iterator JSonObject::begin(){return mMembers.begin();}
+    JSonObject::iterator JSonObject::end(){return mMembers.end();}
+    JSonObject::const_iterator JSonObject::begin() const{return mMembers.begin();}
+    JSonObject::const_iterator JSonObject::end() const{return mMembers.end();}
+    JSonObject::const_iterator JSonObject::cbegin() const{return mMembers.begin();}
+    JSonObject::const_iterator JSonObject::cend() const{return mMembers.end();}
+
+    size_type JSonObject::size() const{return mMembers.size();}
+    bool JSonObject::empty() const{return mMembers.empty();}
+
+    void JSonObject::reserve(size_type count){
+        mMembers.reserve(count);
+        if (count > INDEX_THRESHOLD && count * 2 > mIndexSize)
+            _Reindex(count);
+    }
+
+    void JSonObject::clear(){
+        mMembers.clear();
+        _ReleaseIndex();
+    }
+
+    JSonObject::iterator JSonObject::find(const StringView &key){
+        return mMembers.begin() + _Find(key.data(), key.size(), _HashKey(key.data(), key.size()));
+    }
+
+    JSonObject::const_iterator JSonObject::find(const StringView &key) const{
+        return mMembers.begin() + _Find(key.data(), key.size(), _HashKey(key.data(), key.size()));
+    }
+
+    JSonObject::iterator JSonObject::find(const JSonKey &key){
+        return mMembers.begin() + _Find(key.data(), key.size(), key.hash(), key._Get());
+    }
+
+    JSonObject::const_iterator JSonObject::find(const JSonKey &key) const{
+        return mMembers.begin() + _Find(key.data(), key.size(), key.hash(), key._Get());
+    }
+
+    size_type JSonObject::count(const StringView &key) const{
+        return find(key) != mMembers.end() ? 1 : 0;
+    }
+
+    JSonValue& JSonObject::at(const StringView &key){
+        iterator i = find(key);
+        if (i == mMembers.end())
+            throw JSonException::MissingKey(key.str());
+        return i->second;
+    }
+
+    const JSonValue& JSonObject::at(const StringView &key) const{
+        const_iterator i = find(key);
+        if (i == mMembers.end())
+            throw JSonException::MissingKey(key.str());
+        return i->second;
+    }
+
+    JSonValue& JSonObject::operator[](const StringView &key){
+        return emplace(key, JSonValue()).first->second;
+    }
+
+    std::pair<JSonObject::iterator, bool> JSonObject::insert(const std::pair<string_type, JSonValue> &member){
+        return emplace(StringView(member.first), member.second);
+    }
+
+    std::pair<JSonObject::iterator, bool> JSonObject::emplace(const StringView &key, const JSonValue &value){
+        std::uint32_t hash = _HashKey(key.data(), key.size());
+        size_type pos = _Find(key.data(), key.size(), hash);
+        if (pos != mMembers.size())
+            return std::make_pair(mMembers.begin() + pos, false);
+        // Both are copied before the members grow, as either may refer to a member of this Object.
+        JSonMemoryResource* resource = get_allocator().resource();
+        JSonKey k;
+        k._Assign(key.data(), key.size(), hash, resource);
+        mMembers.emplace_back(std::move(k), JSonValue(value, resource));
+        _Added();
+        return std::make_pair(mMembers.end() - 1, true);
+    }
+
+    std::pair<JSonObject::iterator, bool> JSonObject::emplace(const StringView &key, JSonValue &&value){
+        std::uint32_t hash = _HashKey(key.data(), key.size());
+        size_type pos = _Find(key.data(), key.size(), hash);
+        if (pos != mMembers.size())
+            return std::make_pair(mMembers.begin() + pos, false);
+        JSonKey k;
+        k._Assign(key.data(), key.size(), hash, get_allocator().resource());
+        mMembers.emplace_back(std::move(k), std::move(value));
+        _Added();
+        return std::make_pair(mMembers.end() - 1, true);
+    }
+
+    std::pair<JSonObject::iterator, bool> JSonObject::emplace(JSonKey &&key, JSonValue &&value){
+        size_type pos = _Find(key.data(), key.size(), key.hash(), key._Get());
+        if (pos != mMembers.size())
+            return std::make_pair(mMembers.begin() + pos, false);
+        mMembers.emplace_back(std::move(key), std::move(value));
+        _Added();
+        return std::make_pair(mMembers.end() - 1, true);
+    }
+
+    JSonObject::iterator JSonObject::erase(const_iterator pos){
+        size_type index = pos - mMembers.cbegin();
+        mMembers.erase(mMembers.begin() + index);
+        if (mIndexSize != 0)
+            _Reindex(mMembers.size());
+        return mMembers.begin() + index;
+    }
+
+    size_type JSonObject::erase(const StringView &key){
+        const_iterator i = find(key);
+        if (i == mMembers.end())
+            return 0;
+        erase(i);
+        return 1;
+    }
+
+    bool JSonObject::operator==(const JSonObject &rhs) const{
+        if (mMembers.size() != rhs.mMembers.size())
+            return false;
+        for (const_iterator i = mMembers.begin(); i != mMembers.end(); i++){
+            size_type pos = rhs._Find(i->first.data(), i->first.size(), i->first.hash());
+            if (pos == rhs.mMembers.size() || rhs.mMembers[pos].second != i->second)
+                return false;
+        }
+        return true;
+    }
+
+    bool JSonObject::operator!=(const JSonObject &rhs) const{return !operator==(rhs);}
+
+    // Returns true if k holds the given key. Keys sharing the given _Rep (interned in the same pool) match by pointer.
+    static inline bool _KeyMatches(const JSonKey &k, const char_type* key, size_type size, std::uint32_t hash, const void* rep, const void* krep){
+        return (krep == rep && rep != nullptr) || (k.hash() == hash && k.size() == size && std::memcmp(k.data(), key, size) == 0);
+    }
+
+    // Returns the position of the member with the given key, or size() if there is none.
+    size_type JSonObject::_Find(const char_type* key, size_type size, std::uint32_t hash, const JSonKey::_Rep* rep) const{
+        if (mIndexSize != 0){
+            size_type mask = mIndexSize - 1;
+            for (size_type slot = hash & mask; mIndex[slot] != 0; slot = (slot + 1) & mask){
+                const JSonKey &k = mMembers[mIndex[slot] - 1].first;
+                if (_KeyMatches(k, key, size, hash, rep, k._Get()))
+                    return mIndex[slot] - 1;
+            }
+            return mMembers.size();
+        }
+        for (size_type pos = 0; pos < mMembers.size(); pos++){
+            const JSonKey &k = mMembers[pos].first;
+            if (_KeyMatches(k, key, size, hash, rep, k._Get()))
+                return pos;
+        }
+        return mMembers.size();
+    }
+
+    // Indexes the member just added to the end, building or growing the index as needed.
+    void JSonObject::_Added(){
+        size_type count = mMembers.size();
+        if (mIndexSize == 0 && count <= INDEX_THRESHOLD)
+            return;
+        if (count * 2 > mIndexSize){
+            _Reindex(count * 2);
+            return;
+        }
+        size_type mask = mIndexSize - 1;
+        size_type slot = mMembers.back().first.hash() & mask;
+        while (mIndex[slot] != 0)
+            slot = (slot + 1) & mask;
+        mIndex[slot] = static_cast<std::uint32_t>(count);
+    }
+
+    // Rebuilds the index with room for the given number of members, or drops it if that many don't need one.
+    void JSonObject::_Reindex(size_type count){
+        if (count <= INDEX_THRESHOLD){
+            _ReleaseIndex();
+            return;
+        }
+        if (mMembers.size() >= std::numeric_limits<std::uint32_t>::max())
+            throw std::length_error("JSon Object has too many members to index.");
+        size_type indexSize = 64;
+        while (indexSize < count * 2)
+            indexSize *= 2;
+        if (indexSize != mIndexSize){
+            JSonMemoryResource* resource = get_allocator().resource();
+            std::uint32_t* index = static_cast<std::uint32_t*>(resource->allocate(indexSize * sizeof(std::uint32_t), alignof(std::uint32_t)));
+            _ReleaseIndex();
+            mIndex = index;
+            mIndexSize = indexSize;
+        }
+        std::memset(mIndex, 0, mIndexSize * sizeof(std::uint32_t));
+        size_type mask = mIndexSize - 1;
+        for (size_type pos = 0; pos < mMembers.size(); pos++){
+            size_type slot = mMembers[pos].first.hash() & mask;
+            while (mIndex[slot] != 0)
+                slot = (slot + 1) & mask;
+            mIndex[slot] = static_cast<std::uint32_t>(pos + 1);
+        }
+    }
+
+    void JSonObject::_ReleaseIndex(){
+        if (mIndex != nullptr){
+            get_allocator().resource()->deallocate(mIndex, mIndexSize * sizeof(std::uint32_t), alignof(std::uint32_t));
+            mIndex = nullptr;
+            mIndexSize = 0;
+        }
+    }
+
+    void JSonObject::_Swap(JSonObject &other) noexcept{
+        mMembers.swap(other.mMembers);
+        std::swap(mIndex, other.mIndex);
+        std::swap(mIndexSize, other.mIndexSize);
+    }
+
+
+    JSonKeyPool::JSonKeyPool(JSonMemoryResource* resource) : mResource(resource != nullptr ? resource : JSonHeapResource()), mCount(0){}
+    JSonKeyPool::~JSonKeyPool(){clear();}
+
+    JSonKey JSonKeyPool::intern(const StringView &key){
+        std::uint32_t hash = _HashKey(key.data(), key.size());
+        if ((mCount + 1) * 2 > mSlots.size())
+            _Grow();
+        size_type mask = mSlots.size() - 1;
+        size_type slot = hash & mask;
+        for (; mSlots[slot] != nullptr; slot = (slot + 1) & mask){
+            JSonKey::_Rep* rep = mSlots[slot];
+            if (rep->hash == hash && rep->size == key.size() && std::memcmp(rep->data, key.data(), key.size()) == 0)
+                break;
+        }
+        if (mSlots[slot] == nullptr){
+            // The key is built owning its characters, then handed over to the pool.
+            JSonKey owned;
+            owned._Assign(key.data(), key.size(), hash, mResource);
+            mSlots[slot] = owned._Get();
+            owned.mRep = 0;
+            mCount++;
+        }
+        JSonKey interned;
+        interned.mRep = reinterpret_cast<std::uintptr_t>(mSlots[slot]) | JSonKey::INTERNED;
+        return interned;
+    }
+
+    size_type JSonKeyPool::size() const{return mCount;}
+
+    void JSonKeyPool::clear(){
+        for (std::vector<JSonKey::_Rep*>::iterator i = mSlots.begin(); i != mSlots.end() && mCount > 0; i++){
+            if (*i != nullptr){
+                mResource->deallocate(*i, offsetof(JSonKey::_Rep, data) + (*i)->size + 1, alignof(JSonKey::_Rep));
+                *i = nullptr;
+                mCount--;
+            }
+        }
+    }
+
+    void JSonKeyPool::_Grow(){
+        std::vector<JSonKey::_Rep*> slots(mSlots.empty() ? 64 : mSlots.size() * 2, nullptr);
+        size_type mask = slots.size() - 1;
+        for (std::vector<JSonKey::_Rep*>::iterator i = mSlots.begin(); i != mSlots.end(); i++){
+            if (*i == nullptr)
+                continue;
+            size_type slot = (*i)->hash & mask;
+            while (slots[slot] != nullptr)
+                slot = (slot + 1) & mask;
+            slots[slot] = *i;
+        }
+        mSlots.swap(slots);
+    }
+
+
+/* --------------------------------------------------------------------------------------------
+ *  Parsing methods and support functions.
+ -------------------------------------------------------------------------------------------- */
+
+    inline bool _IsWhitespace(char_type c){
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    inline bool _IsDigit(char_type c){
+        return c >= '0' && c <= '9';
+    }
+
+    // A dead simple caseless equality check against a lowercase literal.
+    inline bool _icaseeq(const char_type* s, const char_type* literal, size_type len){
+        for (size_type i = 0; i < len; i++){
+            if (std::tolower(static_cast<unsigned char>(s[i])) != literal[i])
+                return false;
+        }
+        return true;
+    }
+
+    // Characters that may end a number or literal.
+    inline bool _IsDelimiter(char_type c){
+        return _IsWhitespace(c) || c == VALUE_SEPARATOR || c == OBJECT_SYM_TAIL || c == ARRAY_SYM_TAIL;
+    }
+
+    // Returns a short piece of a value. Used for error messages.
+    inline string_type _Snippet(const char_type* s, size_type len){
+        return string_type(s, std::min<size_type>(len, 10));
+    }
+
+    // Converts w * 10^q to the bits of the nearest double (sign excluded), following the Eisel-Lemire algorithm
+    // (Lemire, "Number Parsing at a Gigabyte per Second", 2021). Exact for any w, given w is the complete significand.
+    std::uint64_t _EiselLemire(std::uint64_t w, int q){
+        const int mantissaBits = 52;
+        if (w == 0 || q < POW5_128_MIN)
+            return 0;
+        if (q > POW5_128_MAX)
+            return static_cast<std::uint64_t>(0x7FF) << mantissaBits;
+
+        int lz = static_cast<int>(_LeadingZeros(w));
+        w <<= lz;
+
+        // Only the top 55 bits of the product matter. The low half of 5^q is only needed if those could be off by one.
+        const std::uint64_t* pow5 = POW5_128 + 2 * (q - POW5_128_MIN);
+        std::uint64_t high, low;
+        _Multiply128(w, pow5[0], high, low);
+        const std::uint64_t precisionMask = static_cast<std::uint64_t>(-1) >> (mantissaBits + 3);
+        if ((high & precisionMask) == precisionMask){
+            std::uint64_t high2, low2;
+            _Multiply128(w, pow5[1], high2, low2);
+            low += high2;
+            if (high2 > low)
+                high++;
+        }
+
+        int upperBit = static_cast<int>(high >> 63);
+        int shift = upperBit + 64 - mantissaBits - 3;
+        std::uint64_t mantissa = high >> shift;
+        // ((152170 + 65536) * q) >> 16 is floor(q * log2(10)).
+        int power2 = (((152170 + 65536) * q) >> 16) + 63 + upperBit - lz + 1023;
+
+        if (power2 <= 0){
+            // Subnormal... or zero.
+            if (-power2 + 1 >= 64)
+                return 0;
+            mantissa >>= -power2 + 1;
+            mantissa += (mantissa & 1);
+            mantissa >>= 1;
+            power2 = (mantissa < (static_cast<std::uint64_t>(1) << mantissaBits)) ? 0 : 1;
+            return (static_cast<std::uint64_t>(power2) << mantissaBits) | (mantissa & ~(static_cast<std::uint64_t>(1) << mantissaBits));
+        }
+
+        // Exactly half way between two doubles rounds to even. This can only happen while 5^q fits in 64 bits.
+        if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1){
+            if ((mantissa << shift) == high)
+                mantissa &= ~static_cast<std::uint64_t>(1);
+        }
+
+        mantissa += (mantissa & 1);
+        mantissa >>= 1;
+        if (mantissa >= (static_cast<std::uint64_t>(2) << mantissaBits)){
+            mantissa = static_cast<std::uint64_t>(1) << mantissaBits;
+            power2++;
+        }
+        mantissa &= ~(static_cast<std::uint64_t>(1) << mantissaBits);
+        if (power2 >= 0x7FF)
+            return static_cast<std::uint64_t>(0x7FF) << mantissaBits;
+        return (static_cast<std::uint64_t>(power2) << mantissaBits) | mantissa;
+    }
+
+    // strtod() in the "C" locale, so the decimal point is always a '.' no matter the locale of the application.
+    double _StrtodC(const char_type* s){
+#if defined(_WIN32)
+        static _locale_t cLocale = _create_locale(LC_NUMERIC, "C");
+        return _strtod_l(s, nullptr, cLocale);
+#else
+        static locale_t cLocale = newlocale(LC_NUMERIC_MASK, "C", static_cast<locale_t>(0));
+        return strtod_l(s, nullptr, cLocale);
+#endif
+    }
+
+    // Converts the (up to) 19 significant digits in w, scaled by 10^q, to a double. If truncated is true, s had more
+    // significant digits than would fit into w, and the len characters at s are used should w alone not be enough.
+    double _ToDouble(std::uint64_t w, int q, bool negative, bool truncated, const char_type* s, size_type len, string_type &scratch){
+        // Powers of ten that are exact as doubles.
+        static const double EXACT_POW10[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        double d;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+        // Clinger's fast path... both w and 10^q are exact doubles, so a single, correctly rounded, operation is exact.
+        if (!truncated && w <= (static_cast<std::uint64_t>(1) << 53) && q >= -22 && q <= 22){
+            d = static_cast<double>(w);
+            d = (q < 0) ? d / EXACT_POW10[-q] : d * EXACT_POW10[q];
+            return negative ? -d : d;
+        }
+#endif
+
+        std::uint64_t bits = _EiselLemire(w, q);
+        // The digits dropped from w put the true value somewhere between w and w + 1. Should those round to different
+        // doubles, only the full string can decide between them.
+        if (truncated && _EiselLemire(w + 1, q) != bits){
+            scratch.assign(s, len);
+            return _StrtodC(scratch.c_str());
+        }
+        if (negative)
+            bits |= static_cast<std::uint64_t>(1) << 63;
+        std::memcpy(&d, &bits, sizeof(d));
+        return d;
+    }
+
+    // What an _Emit*() function made of its token... the handler's answer, or _Emit_Invalid if the token was never passed
+    // to the handler because it isn't a valid number or literal, or _Emit_OutOfRange if it's a number too large for a
+    // double. Invalid tokens are reported rather than thrown, leaving each parser to decide how to fail.
+    enum _Emit{
+        _Emit_Stop,
+        _Emit_Continue,
+        _Emit_Invalid,
+        _Emit_OutOfRange
+    };
+
+    inline _Emit _Emitted(bool proceed){
+        return proceed ? _Emit_Continue : _Emit_Stop;
+    }
+
+    // Returns the error for a token an _Emit*() function turned down.
+    inline JSonException _EmitError(_Emit result, const char_type* s, size_type len){
+        if (result == _Emit_OutOfRange)
+            return JSonException::ParseNumberOutOfRange(_Snippet(s, len));
+        return JSonException::ParseUnknownValueType(_Snippet(s, len));
+    }
+
+    // Returns the handler's answer for an _Emit*() result, throwing if the token was turned down.
+    inline bool _EmitOrThrow(_Emit result, const char_type* s, size_type len){
+        if (result == _Emit_Invalid || result == _Emit_OutOfRange)
+            throw _EmitError(result, s, len);
+        return result == _Emit_Continue;
+    }
+
+    // Validates the number of len characters at s against the JSon number grammar, and passes it to the handler.
+    // Integers that fit in a long long are passed as integers, and all other numbers as doubles (including -0, and
+    // integers too large for a long long, which lose precision rather than fail). Numbers beyond the range of a double
+    // fail, as no double, nor the JSon written from one, could hold them. Those too small round to zero.
+    _Emit _EmitNumber(const char_type* s, size_type len, JSonHandler &handler, string_type &scratch){
+        const char_type* cur = s;
+        const char_type* end = s + len;
+        bool negative = false;
+        bool isInt = true;
+
+        // The first 19 significant digits are gathered into w, which always fits in 64 bits. Any digits past those
+        // only scale w by 10 (or don't, if they're past the decimal point), and set truncated should they be nonzero.
+        std::uint64_t w = 0;
+        int digits = 0;
+        int q = 0;
+        bool truncated = false;
+
+        if (cur != end && *cur == '-'){
+            negative = true;
+            cur++;
+        }
+        if (cur == end || !_IsDigit(*cur))
+            return _Emit_Invalid;
+        if (*cur == '0'){
+            cur++;
+        } else {
+            for (; cur != end && _IsDigit(*cur); cur++){
+                if (digits < 19){
+                    w = w * 10 + static_cast<std::uint64_t>(*cur - '0');
+                    digits++;
+                } else {
+                    truncated |= (*cur != '0');
+                    q++;
+                }
+            }
+        }
+
+        if (cur != end && *cur == '.'){
+            isInt = false;
+            cur++;
+            if (cur == end || !_IsDigit(*cur))
+                return _Emit_Invalid;
+            for (; cur != end && _IsDigit(*cur); cur++){
+                if (digits < 19){
+                    w = w * 10 + static_cast<std::uint64_t>(*cur - '0');
+                    // Leading zeros (as in 0.001) aren't significant.
+                    if (w != 0)
+                        digits++;
+                    q--;
                 } else {
-                    escaped = true;
-                    i++;
+                    truncated |= (*cur != '0');
+                }
+            }
+        }
+
+        if (cur != end && (*cur == 'e' || *cur == 'E')){
+            isInt = false;
+            cur++;
+            bool negativeExp = false;
+            if (cur != end && (*cur == '+' || *cur == '-')){
+                negativeExp = (*cur == '-');
+                cur++;
+            }
+            if (cur == end || !_IsDigit(*cur))
+                return _Emit_Invalid;
+            // Anything past 99999 is well beyond the range of a double, so is clamped rather than allowed to overflow.
+            int exp = 0;
+            for (; cur != end && _IsDigit(*cur); cur++){
+                if (exp < 100000)
+                    exp = exp * 10 + (*cur - '0');
+            }
+            q += negativeExp ? -exp : exp;
+        }
+
+        if (cur != end)
+            return _Emit_Invalid;
+
+        if (isInt && q == 0){
+            // A long long has no -0, so -0 is passed as a double to keep its sign.
+            if (negative && w == 0)
+                return _Emitted(handler.number_double(-0.0));
+            const std::uint64_t limit = static_cast<std::uint64_t>(std::numeric_limits<long long>::max()) + (negative ? 1 : 0);
+            if (w <= limit)
+                return _Emitted(handler.number_int(negative ? static_cast<long long>(0 - w) : static_cast<long long>(w)));
+        }
+        const double d = _ToDouble(w, q, negative, truncated, s, len, scratch);
+        if (std::isinf(d))
+            return _Emit_OutOfRange;
+        return _Emitted(handler.number_double(d));
+    }
+
+    // Passes the literal (true, false, or null) of len characters at s to the handler.
+    _Emit _EmitLiteral(const char_type* s, size_type len, JSonHandler &handler){
+        if (len == 4 && _icaseeq(s, "true", 4))
+            return _Emitted(handler.boolean(true));
+        if (len == 5 && _icaseeq(s, "false", 5))
+            return _Emitted(handler.boolean(false));
+        if (len == 4 && _icaseeq(s, "null", 4))
+            return _Emitted(handler.null());
+        return _Emit_Invalid;
+    }
+
+    // Passes the number or literal of len characters at s to the handler.
+    inline _Emit _EmitScalar(const char_type* s, size_type len, JSonHandler &handler, string_type &scratch){
+        if (*s == '-' || _IsDigit(*s))
+            return _EmitNumber(s, len, handler, scratch);
+        return _EmitLiteral(s, len, handler);
+    }
+
+    // Appends the character represented by the escape sequence "\c" to out. Returns false if "\c" isn't a valid escape.
+    inline bool _AppendEscaped(char_type c, string_type &out){
+        switch(c){
+        case '"': out += '"'; break;
+        case '\\': out += '\\'; break;
+        case '/': out += '/'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        default:
+            return false;
+        }
+        return true;
+    }
+
+    // Returns the value of the hex digit c, or -1 if it isn't one.
+    inline int _HexValue(char_type c){
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
+
+    // Returns the UTF-16 code unit of the 4 hex digits at s, which must already be known to be hex digits.
+    inline std::uint32_t _CodeUnit(const char_type* s){
+        return static_cast<std::uint32_t>((_HexValue(s[0]) << 12) | (_HexValue(s[1]) << 8) | (_HexValue(s[2]) << 4) | _HexValue(s[3]));
+    }
+
+    // Appends the code point cp to out, encoded as UTF-8.
+    inline void _AppendUtf8(std::uint32_t cp, string_type &out){
+        if (cp < 0x80){
+            out += static_cast<char_type>(cp);
+        } else if (cp < 0x800){
+            out += static_cast<char_type>(0xC0 | (cp >> 6));
+            out += static_cast<char_type>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000){
+            out += static_cast<char_type>(0xE0 | (cp >> 12));
+            out += static_cast<char_type>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char_type>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char_type>(0xF0 | (cp >> 18));
+            out += static_cast<char_type>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char_type>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char_type>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    // Decodes the escape sequence at s (on its backslash), of which avail characters are known, appending the character
+    // it stands for to out. \uXXXX escapes are written as UTF-8, with the escape of a high surrogate taking the escape
+    // of its low surrogate along with it ("\uD83D\uDE00" is one character). Returns the number of characters the escape
+    // took up, 0 if it isn't valid, or -1 if it may yet be valid but runs past avail.
+    int _DecodeEscape(const char_type* s, size_type avail, string_type &out){
+        if (avail < 2)
+            return -1;
+        if (s[1] != 'u')
+            return _AppendEscaped(s[1], out) ? 2 : 0;
+
+        // The digits that are known are checked before asking for more, so a bad escape fails as soon as it's seen.
+        size_type known = std::min<size_type>(avail, 6);
+        for (size_type i = 2; i < known; i++){
+            if (_HexValue(s[i]) < 0)
+                return 0;
+        }
+        if (avail < 6)
+            return -1;
+        std::uint32_t cp = _CodeUnit(s + 2);
+        if (cp >= 0xDC00 && cp <= 0xDFFF)
+            return 0; // A low surrogate with no high surrogate before it.
+        if (cp < 0xD800 || cp > 0xDBFF){
+            _AppendUtf8(cp, out);
+            return 6;
+        }
+
+        // A high surrogate, which is only valid followed by the escape of a low surrogate.
+        known = std::min<size_type>(avail, 12);
+        if ((known > 6 && s[6] != '\\') || (known > 7 && s[7] != 'u'))
+            return 0;
+        for (size_type i = 8; i < known; i++){
+            if (_HexValue(s[i]) < 0)
+                return 0;
+        }
+        if (avail < 12)
+            return -1;
+        std::uint32_t low = _CodeUnit(s + 8);
+        if (low < 0xDC00 || low > 0xDFFF)
+            return 0;
+        _AppendUtf8(0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00), out);
+        return 12;
+    }
+
+
+    JSonSelector::JSonSelector() : mNodes(1), mPointers(0){
+        mNodes[0].wildcard = 0;
+        mNodes[0].selected = false;
+    }
+
+    JSonSelector::JSonSelector(const std::vector<string_type> &pointers) : JSonSelector(){
+        for (std::vector<string_type>::const_iterator i = pointers.begin(); i != pointers.end(); i++)
+            add(*i);
+    }
+
+    JSonSelector& JSonSelector::add(const StringView &pointer){
+        if (!pointer.empty() && pointer[0] != '/')
+            throw std::invalid_argument("JSon Pointer must be empty or start with '/'.");
+
+        // Decoding every segment before touching the tree, so a malformed pointer leaves it as it was.
+        std::vector<string_type> segments;
+        for (size_type i = 0; i < pointer.size(); i++){
+            if (pointer[i] == '/'){
+                segments.push_back(string_type());
+                continue;
+            }
+            if (pointer[i] == '~'){
+                if (i + 1 == pointer.size() || (pointer[i + 1] != '0' && pointer[i + 1] != '1'))
+                    throw std::invalid_argument("JSon Pointer has an invalid '~' escape.");
+                segments.back().push_back(pointer[++i] == '0' ? '~' : '/');
+                continue;
+            }
+            segments.back().push_back(pointer[i]);
+        }
+
+        std::uint32_t node = 0;
+        for (std::vector<string_type>::const_iterator i = segments.begin(); i != segments.end(); i++)
+            node = _Child(node, *i);
+        mNodes[node].selected = true;
+        mPointers++;
+        return *this;
+    }
+
+    size_type JSonSelector::size() const{
+        return mPointers;
+    }
+
+    bool JSonSelector::empty() const{
+        return mPointers == 0;
+    }
+
+    void JSonSelector::clear(){
+        mNodes.resize(1);
+        mNodes[0].steps.clear();
+        mNodes[0].wildcard = 0;
+        mNodes[0].selected = false;
+        mPointers = 0;
+    }
+
+    std::uint32_t JSonSelector::_Child(std::uint32_t node, const string_type &key){
+        if (key == "*" && mNodes[node].wildcard != 0)
+            return mNodes[node].wildcard;
+        if (key != "*"){
+            for (std::vector<_Step>::const_iterator i = mNodes[node].steps.begin(); i != mNodes[node].steps.end(); i++){
+                if (i->key == key)
+                    return i->node;
+            }
+        }
+
+        std::uint32_t child = static_cast<std::uint32_t>(mNodes.size());
+        mNodes.push_back(_Node());
+        mNodes[child].wildcard = 0;
+        mNodes[child].selected = false;
+        if (key == "*"){
+            mNodes[node].wildcard = child;
+            return child;
+        }
+
+        // Array indexes are written in decimal without leading zeros.
+        _Step step;
+        step.key = key;
+        step.index = string_type::npos;
+        if (!key.empty() && key.size() < 19 && (key[0] != '0' || key.size() == 1) &&
+            std::all_of(key.begin(), key.end(), [](char_type c){return _IsDigit(c);}))
+            step.index = static_cast<size_type>(std::stoull(key));
+        step.node = child;
+        mNodes[node].steps.push_back(step);
+        return child;
+    }
+
+
+    JSonParseResult::JSonParseResult() : code(0), offset(0), line(0), column(0){}
+
+    bool JSonParseResult::ok() const{
+        return code == 0;
+    }
+
+    JSonParseResult::operator bool() const{
+        return code == 0;
+    }
+
+
+    /* JSonParser is a single pass JSon parser.
+     *
+     * The parser walks the tokens found by mIndex, passing each value to the handler as it is encountered. mCur always
+     * points at the next token to be consumed, or is mEnd once the tokens have run out. The Arrays and Objects currently
+     * open are kept on mStack rather than the call stack, so hostile nesting is bounded by mLimits.max_depth alone.
+     * Every _Parse*() method returns false if the handler asked for parsing to stop, or if the JSon string turned out to
+     * be invalid. Errors are recorded by _Fail() and handed back the same way a stop is, so nothing is thrown until the
+     * error reaches parse()... and never by try_parse().
+     */
+    const size_type JSonParseLimits::DEFAULT_MAX_DEPTH = 1024;
+    const size_type JSonParseLimits::NO_LIMIT = static_cast<size_type>(-1);
+
+    JSonParseLimits::JSonParseLimits(size_type maxDepth, size_type maxSize) : max_depth(maxDepth), max_size(maxSize){}
+
+    JSonParser::JSonParser() : JSonParser(JSonParseLimits()){}
+
+    JSonParser::JSonParser(const JSonParseLimits &limits) :
+        mBegin(nullptr), mCur(nullptr), mEnd(nullptr), mHandler(nullptr), mLimits(limits), mSelector(nullptr),
+        mError(string_type(), 0), mErrorAt(nullptr), mFailed(false){}
+
+    const JSonParseLimits& JSonParser::limits() const{
+        return mLimits;
+    }
+
+    void JSonParser::set_limits(const JSonParseLimits &limits){
+        mLimits = limits;
+    }
+
+    bool JSonParser::parse(const StringView &jsonstr, JSonHandler &handler){
+        return parse(jsonstr.data(), jsonstr.size(), handler);
+    }
+
+    bool JSonParser::parse(const char_type* data, size_type size, JSonHandler &handler){
+        mHandler = &handler;
+        mSelector = nullptr;
+        return _Completed(_Parse(data, size));
+    }
+
+    bool JSonParser::parse(const StringView &jsonstr, JSonHandler &handler, const JSonSelector &selector){
+        return parse(jsonstr.data(), jsonstr.size(), handler, selector);
+    }
+
+    bool JSonParser::parse(const char_type* data, size_type size, JSonHandler &handler, const JSonSelector &selector){
+        mHandler = &handler;
+        // Selecting the root is the same as parsing everything.
+        mSelector = selector.mNodes[0].selected ? nullptr : &selector;
+        mActive.assign(1, 0);
+        return _Completed(_Parse(data, size));
+    }
+
+    JSonParseResult JSonParser::try_parse(const StringView &jsonstr, JSonHandler &handler){
+        return try_parse(jsonstr.data(), jsonstr.size(), handler);
+    }
+
+    JSonParseResult JSonParser::try_parse(const char_type* data, size_type size, JSonHandler &handler){
+        mHandler = &handler;
+        mSelector = nullptr;
+        _Parse(data, size);
+        return _Result();
+    }
+
+    JSonParseResult JSonParser::try_parse(const StringView &jsonstr, JSonHandler &handler, const JSonSelector &selector){
+        return try_parse(jsonstr.data(), jsonstr.size(), handler, selector);
+    }
+
+    JSonParseResult JSonParser::try_parse(const char_type* data, size_type size, JSonHandler &handler, const JSonSelector &selector){
+        mHandler = &handler;
+        mSelector = selector.mNodes[0].selected ? nullptr : &selector;
+        mActive.assign(1, 0);
+        _Parse(data, size);
+        return _Result();
+    }
+
+    bool JSonParser::_Parse(const char_type* data, size_type size){
+        mBegin = data;
+        mEnd = data + size;
+        mFailed = false;
+        mStack.clear();
+        if (size > mLimits.max_size)
+            return _Fail(JSonException::ParseTooLarge(mLimits.max_size), data + mLimits.max_size);
+        const char_type* invalid = JSonFindInvalidUtf8(data, size);
+        if (invalid != mEnd)
+            return _Fail(JSonException::ParseInvalidEncoding(), invalid);
+        mIndex.reset(data, size);
+
+        _Advance();
+        if (mCur == mEnd)
+            return _Fail(JSonException::ParseInvalidJsonContainer(), mCur);
+
+        bool completed = false;
+        switch(*mCur){
+        case OBJECT_SYM_HEAD:
+            completed = (mSelector != nullptr) ? _SelectObject(0, 1) : _ParseValue(); break;
+        case ARRAY_SYM_HEAD:
+            completed = (mSelector != nullptr) ? _SelectArray(0, 1) : _ParseValue(); break;
+        default:
+            return _Fail(JSonException::ParseInvalidJsonContainer(), mCur);
+        }
+        if (!completed)
+            return false;
+
+        // Only white space may follow the root container.
+        if (mCur != mEnd)
+            return _Fail(JSonException::ParseInvalidSymbol(), mCur);
+        return true;
+    }
+
+    // Throws the error _Parse() stopped at, if it stopped at one.
+    inline bool JSonParser::_Completed(bool completed){
+        if (!completed && mFailed)
+            throw mError;
+        return completed;
+    }
+
+    // Records the error found at the given point in the source. Always returns false.
+    bool JSonParser::_Fail(const JSonException &error, const char_type* at){
+        mError = error;
+        mErrorAt = at;
+        mFailed = true;
+        return false;
+    }
+
+    // Describes how the last _Parse() went. Line and column are only worked out for errors, by counting the line breaks
+    // before the error.
+    JSonParseResult JSonParser::_Result() const{
+        JSonParseResult result;
+        if (!mFailed)
+            return result;
+
+        result.code = mError.get_code();
+        result.message = mError.what();
+        result.offset = static_cast<size_type>(mErrorAt - mBegin);
+        result.line = 1;
+        const char_type* lineStart = mBegin;
+        for (const char_type* c = mBegin; c != mErrorAt; c++){
+            if (*c == '\n'){
+                result.line++;
+                lineStart = c + 1;
+            }
+        }
+        result.column = static_cast<size_type>(mErrorAt - lineStart) + 1;
+        return result;
+    }
+
+    inline void JSonParser::_Advance(){
+        mCur = mIndex.next();
+        if (mCur == nullptr)
+            mCur = mEnd;
+    }
+
+    // Parses the value at the cursor along with everything nested within it. Rather than recursing into each Array and
+    // Object, the ones open are kept on mStack, so nesting costs a byte of mStack per level instead of a stack frame.
+    bool JSonParser::_ParseValue(){
+        const size_type base = mStack.size();
+        while (true){
+            switch(*mCur){
+            case OBJECT_SYM_HEAD:
+                if (!_Open(OBJECT_SYM_HEAD))
+                    return false;
+                if (*mCur != OBJECT_SYM_TAIL){
+                    StringView key;
+                    if (!_ParseKey(key) || !mHandler->key(key) || !_ParsePairSeparator())
+                        return false;
+                    continue;
+                }
+                break;
+            case ARRAY_SYM_HEAD:
+                if (!_Open(ARRAY_SYM_HEAD))
+                    return false;
+                if (*mCur == VALUE_SEPARATOR)
+                    return _Fail(JSonException::ParseMissingValue(), mCur);
+                if (*mCur != ARRAY_SYM_TAIL)
+                    continue;
+                break;
+            case '"':{
+                StringView str;
+                if (!_ParseString(str) || !mHandler->string(str))
+                    return false;
+                break;
+            }
+            default:
+                if (!_ParseScalar())
+                    return false;
+                break;
+            }
+
+            // A value (or an empty Array or Object) has been parsed... closing every container it ends, up to the first
+            // with another value to come.
+            while (true){
+                if (mStack.size() == base)
+                    return true;
+                const bool isObject = (mStack.back() == OBJECT_SYM_HEAD);
+                const char_type tail = isObject ? OBJECT_SYM_TAIL : ARRAY_SYM_TAIL;
+                if (mCur == mEnd)
+                    return _Fail(JSonException::ParseUnclosedStructure(isObject ? JSonType_Object : JSonType_Array), mCur);
+                if (*mCur == tail){
+                    if (!_Close())
+                        return false;
+                    continue;
+                }
+                if (*mCur != VALUE_SEPARATOR)
+                    return _Fail(JSonException::ParseMissingSymbol(VALUE_SEPARATOR), mCur);
+                _Advance();
+
+                if (mCur == mEnd)
+                    return _Fail(JSonException::ParseUnclosedStructure(isObject ? JSonType_Object : JSonType_Array), mCur);
+                if (*mCur == tail || (!isObject && *mCur == VALUE_SEPARATOR))
+                    return _Fail(JSonException::ParseMissingValue(), mCur);
+                if (isObject){
+                    StringView key;
+                    if (!_ParseKey(key) || !mHandler->key(key) || !_ParsePairSeparator())
+                        return false;
+                }
+                break;
+            }
+        }
+    }
+
+    // Opens the Array or Object at the cursor, moving the cursor past its opening bracket.
+    bool JSonParser::_Open(char_type head){
+        if (mStack.size() >= mLimits.max_depth)
+            return _Fail(JSonException::ParseTooDeep(mLimits.max_depth), mCur);
+        const bool isObject = (head == OBJECT_SYM_HEAD);
+        if (!(isObject ? mHandler->start_object() : mHandler->start_array()))
+            return false;
+        mStack.push_back(head);
+
+        _Advance(); // Skipping the OBJECT_SYM_HEAD or ARRAY_SYM_HEAD
+        if (mCur == mEnd)
+            return _Fail(JSonException::ParseUnclosedStructure(isObject ? JSonType_Object : JSonType_Array), mCur);
+        return true;
+    }
+
+    // Closes the innermost open Array or Object, whose closing bracket is at the cursor.
+    bool JSonParser::_Close(){
+        const bool isObject = (mStack.back() == OBJECT_SYM_HEAD);
+        mStack.pop_back();
+        _Advance();
+        return isObject ? mHandler->end_object() : mHandler->end_array();
+    }
+
+    // Parses an Object's key, leaving the cursor on what should be the OBJECT_PAIR_SEPARATOR.
+    bool JSonParser::_ParseKey(StringView &key){
+        if (*mCur != '"')
+            return _Fail(JSonException::ParseMalformed(), mCur);
+        return _ParseString(key);
+    }
+
+    // Skips the OBJECT_PAIR_SEPARATOR following a key, leaving the cursor on the start of the member's value.
+    bool JSonParser::_ParsePairSeparator(){
+        if (mCur == mEnd)
+            return _Fail(JSonException::ParseUnclosedStructure(JSonType_Object), mCur);
+        if (*mCur != OBJECT_PAIR_SEPARATOR)
+            return _Fail(JSonException::ParseMissingSymbol(OBJECT_PAIR_SEPARATOR), mCur);
+        _Advance();
+
+        if (mCur == mEnd)
+            return _Fail(JSonException::ParseUnclosedStructure(JSonType_Object), mCur);
+        if (*mCur == VALUE_SEPARATOR || *mCur == OBJECT_SYM_TAIL)
+            return _Fail(JSonException::ParseMissingValue(), mCur);
+        return true;
+    }
+
+    // Decodes the string at the cursor (which must be on the opening quote) into str.
+    // Strings without escapes are viewed directly within the source; all others are decoded into mScratch.
+    bool JSonParser::_ParseString(StringView &str){
+        const char_type* head = mCur + 1;
+        // The index always follows an opening quote with its closing quote... unless the source ends first.
+        const char_type* tail = mIndex.next();
+        const char_type* stop = (tail != nullptr) ? tail : mEnd;
+
+        // Fast path... the vast majority of strings contain no escapes and need no decoding.
+        const char_type* escape = static_cast<const char_type*>(std::memchr(head, '\\', stop - head));
+        if (escape == nullptr){
+            if (tail == nullptr)
+                return _Fail(JSonException::ParseUnclosedStructure(JSonType_String), mEnd);
+            _Advance();
+            str = StringView(head, tail - head);
+            return true;
+        }
+
+        mScratch.assign(head, escape);
+        while (escape != nullptr){
+            int used = _DecodeEscape(escape, stop - escape, mScratch);
+            if (used <= 0){
+                // The closing quote can't be escaped, so only a string missing its closing quote can cut an escape short.
+                if (used < 0 && tail == nullptr)
+                    return _Fail(JSonException::ParseUnclosedStructure(JSonType_String), mEnd);
+                return _Fail(JSonException::ParseMalformed(), escape);
+            }
+            head = escape + used;
+            escape = static_cast<const char_type*>(std::memchr(head, '\\', stop - head));
+            mScratch.append(head, (escape != nullptr) ? escape : stop);
+        }
+        if (tail == nullptr)
+            return _Fail(JSonException::ParseUnclosedStructure(JSonType_String), mEnd);
+        _Advance();
+        str = StringView(mScratch);
+        return true;
+    }
+
+    // Only the first character of a number or literal is indexed, so the rest is found by scanning to a delimiter.
+    bool JSonParser::_ParseScalar(){
+        const char_type* head = mCur;
+        const char_type* tail = head + 1;
+        while (tail != mEnd && !_IsDelimiter(*tail))
+            tail++;
+        _Advance();
+        _Emit result = _EmitScalar(head, tail - head, *mHandler, mScratch);
+        switch(result){
+        case _Emit_Continue: return true;
+        case _Emit_Stop: return false;
+        default: break;
+        }
+        return _Fail(_EmitError(result, head, tail - head), head);
+    }
+
+    // _SelectObject() and _SelectArray() hand each member to _SelectMember() along with the run of mActive holding the
+    // selector nodes the container matched. They recurse only as deep as the selector's pointers reach: anything past
+    // the end of a pointer is parsed by _ParseValue(), or skipped by _SkipValue().
+    bool JSonParser::_SelectObject(size_type active, size_type count){
+        if (!_Open(OBJECT_SYM_HEAD))
+            return false;
+        if (*mCur == OBJECT_SYM_TAIL)
+            return _Close();
+
+        while (true){
+            StringView key;
+            if (!_ParseKey(key) || !_ParsePairSeparator())
+                return false;
+            if (!_SelectMember(active, count, key, string_type::npos, true))
+                return false;
+
+            if (mCur == mEnd)
+                return _Fail(JSonException::ParseUnclosedStructure(JSonType_Object), mCur);
+            if (*mCur == OBJECT_SYM_TAIL)
+                return _Close();
+            if (*mCur != VALUE_SEPARATOR)
+                return _Fail(JSonException::ParseMissingSymbol(VALUE_SEPARATOR), mCur);
+            _Advance();
+
+            if (mCur == mEnd)
+                return _Fail(JSonException::ParseUnclosedStructure(JSonType_Object), mCur);
+            if (*mCur == OBJECT_SYM_TAIL)
+                return _Fail(JSonException::ParseMissingValue(), mCur);
+        }
+    }
+
+    bool JSonParser::_SelectArray(size_type active, size_type count){
+        if (!_Open(ARRAY_SYM_HEAD))
+            return false;
+        if (*mCur == ARRAY_SYM_TAIL)
+            return _Close();
+
+        for (size_type index = 0; ; index++){
+            if (*mCur == VALUE_SEPARATOR)
+                return _Fail(JSonException::ParseMissingValue(), mCur);
+            if (!_SelectMember(active, count, StringView(), index, false))
+                return false;
+
+            if (mCur == mEnd)
+                return _Fail(JSonException::ParseUnclosedStructure(JSonType_Array), mCur);
+            if (*mCur == ARRAY_SYM_TAIL)
+                return _Close();
+            if (*mCur != VALUE_SEPARATOR)
+                return _Fail(JSonException::ParseMissingSymbol(VALUE_SEPARATOR), mCur);
+            _Advance();
+
+            if (mCur == mEnd)
+                return _Fail(JSonException::ParseUnclosedStructure(JSonType_Array), mCur);
+            if (*mCur == ARRAY_SYM_TAIL)
+                return _Fail(JSonException::ParseMissingValue(), mCur);
+        }
+    }
+
+    // Matches the member (an Object's key, or an Array's index) against the container's selector nodes, then parses the
+    // value in full if a pointer ends at it, descends into it if a pointer passes through it, or skips it otherwise.
+    bool JSonParser::_SelectMember(size_type active, size_type count, const StringView &key, size_type index, bool isKey){
+        size_type next = mActive.size();
+        bool selected = false;
+        for (size_type i = active; i < active + count; i++){
+            const JSonSelector::_Node& node = mSelector->mNodes[mActive[i]];
+            for (std::vector<JSonSelector::_Step>::const_iterator s = node.steps.begin(); s != node.steps.end(); s++){
+                if (isKey ? StringView(s->key) == key : s->index == index){
+                    mActive.push_back(s->node);
+                    selected |= mSelector->mNodes[s->node].selected;
                 }
+            }
+            if (node.wildcard != 0){
+                mActive.push_back(node.wildcard);
+                selected |= mSelector->mNodes[node.wildcard].selected;
+            }
+        }
+
+        size_type matched = mActive.size() - next;
+        bool container = (*mCur == OBJECT_SYM_HEAD || *mCur == ARRAY_SYM_HEAD);
+        if (matched == 0 || (!selected && !container)){
+            mActive.resize(next);
+            return _SkipValue();
+        }
+
+        if (isKey && !mHandler->key(key))
+            return false;
+        bool completed;
+        if (selected)
+            completed = _ParseValue();
+        else if (*mCur == OBJECT_SYM_HEAD)
+            completed = _SelectObject(next, matched);
+        else
+            completed = _SelectArray(next, matched);
+        mActive.resize(next);
+        return completed;
+    }
+
+    // Skips the value at the cursor by matching brackets, hopping over strings without looking inside them.
+    bool JSonParser::_SkipValue(){
+        JSonType type = (*mCur == OBJECT_SYM_HEAD) ? JSonType_Object : JSonType_Array;
+        size_type depth = 0;
+        do{
+            switch(*mCur){
+            case OBJECT_SYM_HEAD:
+            case ARRAY_SYM_HEAD:
+                if (mStack.size() + ++depth > mLimits.max_depth)
+                    return _Fail(JSonException::ParseTooDeep(mLimits.max_depth), mCur);
+                break;
+            case OBJECT_SYM_TAIL:
+            case ARRAY_SYM_TAIL:
+                if (depth == 0)
+                    return _Fail(JSonException::ParseMalformed(), mCur);
+                depth--;
                 break;
             case '"':
-                if (escaped){
-                    s.replace(i-1, 2, "\"");
-                    escaped = false;
-                } else {i++;}
+                // The index always follows an opening quote with its closing quote... unless the source ends first.
+                if (mIndex.next() == nullptr)
+                    return _Fail(JSonException::ParseUnclosedStructure(JSonType_String), mEnd);
+                break;
+            default: break;
+            }
+            _Advance();
+            if (depth > 0 && mCur == mEnd)
+                return _Fail(JSonException::ParseUnclosedStructure(type), mCur);
+        } while (depth > 0);
+        return true;
+    }
+
+
+    /* JSonPushParser
+     *
+     * A state machine version of JSonParser that can stop at the end of any chunk and pick up again with the next.
+     * mState records what the parser is waiting for, and mStack the containers currently open. Strings and scalars
+     * (numbers and literals) that straddle a chunk boundary are gathered into mToken until they are complete, as are
+     * escape sequences into mEscape. mFed counts every character fed, so max_size bounds the whole JSon string rather
+     * than each chunk.
+     *
+     * Error reporting mirrors JSonParser so both throw the same JSonException codes for the same JSon strings.
+     */
+    JSonPushParser::JSonPushParser(JSonHandler &handler) : JSonPushParser(handler, JSonParseLimits()){}
+
+    JSonPushParser::JSonPushParser(JSonHandler &handler, const JSonParseLimits &limits) :
+        mHandler(&handler), mLimits(limits), mState(_State_Root), mFed(0), mTokenIsKey(false), mTokenBuffered(false){}
+
+    const JSonParseLimits& JSonPushParser::limits() const{
+        return mLimits;
+    }
+
+    void JSonPushParser::set_limits(const JSonParseLimits &limits){
+        mLimits = limits;
+    }
+
+    void JSonPushParser::reset(){
+        mState = _State_Root;
+        mFed = 0;
+        mStack.clear();
+        mToken.clear();
+        mEscape.clear();
+        mUtf8.clear();
+        mTokenIsKey = false;
+        mTokenBuffered = false;
+    }
+
+    bool JSonPushParser::feed(const StringView &chunk){
+        return feed(chunk.data(), chunk.size());
+    }
+
+    bool JSonPushParser::feed(const char_type* data, size_type size){
+        const char_type* cur = data;
+        const char_type* end = data + size;
+        if (mState != _State_Stopped){
+            if (size > mLimits.max_size || mFed > mLimits.max_size - size)
+                throw JSonException::ParseTooLarge(mLimits.max_size);
+            mFed += size;
+            _CheckUtf8(data, size);
+        }
+
+        // Picking up anything left unfinished by the previous chunk.
+        switch(mState){
+        case _State_String:
+        case _State_StringEscape:
+            if (!_ScanString(cur, end))
+                return false;
+            break;
+        case _State_Scalar:
+            if (!_ScanScalar(cur, end))
+                return false;
+            break;
+        case _State_Stopped:
+            return false;
+        default: break;
+        }
+
+        while (cur != end){
+            char_type c = *cur;
+            if (_IsWhitespace(c)){
+                cur++;
+                continue;
+            }
+
+            switch(mState){
+            case _State_Root:
+                if (c != OBJECT_SYM_HEAD && c != ARRAY_SYM_HEAD)
+                    throw JSonException::ParseInvalidJsonContainer();
+                if (!_StartValue(cur, end, c))
+                    return false;
+                break;
+
+            case _State_ObjectFirst:
+                if (c == OBJECT_SYM_TAIL){
+                    cur++;
+                    if (!_CloseContainer(c))
+                        return false;
+                    break;
+                }
+                // Fall through... it must be a key.
+            case _State_ObjectKey:
+                if (c == OBJECT_SYM_TAIL)
+                    throw JSonException::ParseMissingValue();
+                if (c != '"')
+                    throw JSonException::ParseMalformed();
+                cur++;
+                mState = _State_String;
+                mTokenIsKey = true;
+                mTokenBuffered = false;
+                if (!_ScanString(cur, end))
+                    return false;
+                break;
+
+            case _State_PairSeparator:
+                if (c != OBJECT_PAIR_SEPARATOR)
+                    throw JSonException::ParseMissingSymbol(OBJECT_PAIR_SEPARATOR);
+                cur++;
+                mState = _State_ObjectValue;
+                break;
+
+            case _State_ObjectValue:
+                if (c == VALUE_SEPARATOR || c == OBJECT_SYM_TAIL)
+                    throw JSonException::ParseMissingValue();
+                if (!_StartValue(cur, end, c))
+                    return false;
+                break;
+
+            case _State_ArrayFirst:
+                if (c == ARRAY_SYM_TAIL){
+                    cur++;
+                    if (!_CloseContainer(c))
+                        return false;
+                    break;
+                }
+                // Fall through... it must be a value.
+            case _State_ArrayValue:
+                if (c == VALUE_SEPARATOR || c == ARRAY_SYM_TAIL)
+                    throw JSonException::ParseMissingValue();
+                if (!_StartValue(cur, end, c))
+                    return false;
+                break;
+
+            case _State_AfterValue:
+                cur++;
+                if (c == VALUE_SEPARATOR){
+                    mState = (mStack.back() == OBJECT_SYM_HEAD) ? _State_ObjectKey : _State_ArrayValue;
+                } else if ((c == OBJECT_SYM_TAIL && mStack.back() == OBJECT_SYM_HEAD) || (c == ARRAY_SYM_TAIL && mStack.back() == ARRAY_SYM_HEAD)){
+                    if (!_CloseContainer(c))
+                        return false;
+                } else {
+                    throw JSonException::ParseMissingSymbol(VALUE_SEPARATOR);
+                }
+                break;
+
+            case _State_Done:
+                throw JSonException::ParseInvalidSymbol();
+
+            default:
+                // Strings, scalars, and the stopped state never reach this point.
+                throw JSonException::ParseMalformed();
+            }
+        }
+        return true;
+    }
+
+    bool JSonPushParser::finish(){
+        if (!mUtf8.empty() && mState != _State_Stopped)
+            throw JSonException::ParseInvalidEncoding();
+        switch(mState){
+        case _State_Done:
+            return true;
+        case _State_Stopped:
+            return false;
+        case _State_Root:
+            throw JSonException::ParseInvalidJsonContainer();
+        case _State_String:
+        case _State_StringEscape:
+            throw JSonException::ParseUnclosedStructure(JSonType_String);
+        case _State_Scalar:
+            // The input ends with the scalar, which JSonParser reads up to the end before finding its container unclosed.
+            if (!_EmitOrThrow(_EmitScalar(mToken.data(), mToken.size(), *mHandler, mScratch), mToken.data(), mToken.size())){
+                mState = _State_Stopped;
+                return false;
+            }
+            break;
+        default: break;
+        }
+        throw JSonException::ParseUnclosedStructure((mStack.back() == OBJECT_SYM_HEAD) ? JSonType_Object : JSonType_Array);
+    }
+
+    // Returns the length of the UTF-8 sequence the lead byte c starts, going by c alone.
+    inline size_type _Utf8Length(char_type c){
+        unsigned char u = static_cast<unsigned char>(c);
+        return (u >= 0xF0) ? 4 : (u >= 0xE0) ? 3 : (u >= 0xC0) ? 2 : 1;
+    }
+
+    // Validates the chunk's UTF-8, completing the sequence the previous chunk cut short first, and holding back any
+    // sequence this chunk cuts short for the next.
+    void JSonPushParser::_CheckUtf8(const char_type* data, size_type size){
+        const char_type* cur = data;
+        const char_type* end = data + size;
+        if (!mUtf8.empty()){
+            size_type needed = _Utf8Length(mUtf8[0]);
+            while (mUtf8.size() < needed && cur != end)
+                mUtf8 += *cur++;
+            if (mUtf8.size() < needed)
+                return;
+            if (JSonFindInvalidUtf8(mUtf8.data(), needed) != mUtf8.data() + needed)
+                throw JSonException::ParseInvalidEncoding();
+            mUtf8.clear();
+        }
+
+        const char_type* last = end;
+        for (size_type back = 1; back <= 3 && back <= static_cast<size_type>(end - cur); back++){
+            unsigned char c = static_cast<unsigned char>(end[-back]);
+            if (c < 0x80)
                 break;
-            case '/':
-                if (escaped){
-                    s.replace(i-1, 2, "/");
-                    escaped = false;
-                } else {i++;}
+            if (c >= 0xC0){
+                if (_Utf8Length(c) > back)
+                    last = end - back;
                 break;
+            }
+        }
+        if (JSonFindInvalidUtf8(cur, last - cur) != last)
+            throw JSonException::ParseInvalidEncoding();
+        mUtf8.assign(last, end);
+    }
+
+    // Starts the value at cur, whose first character is c.
+    bool JSonPushParser::_StartValue(const char_type* &cur, const char_type* end, char_type c){
+        switch(c){
+        case OBJECT_SYM_HEAD:
+            if (mStack.size() >= mLimits.max_depth)
+                throw JSonException::ParseTooDeep(mLimits.max_depth);
+            cur++;
+            mStack.push_back(c);
+            mState = _State_ObjectFirst;
+            if (!mHandler->start_object()){
+                mState = _State_Stopped;
+                return false;
+            }
+            return true;
+        case ARRAY_SYM_HEAD:
+            if (mStack.size() >= mLimits.max_depth)
+                throw JSonException::ParseTooDeep(mLimits.max_depth);
+            cur++;
+            mStack.push_back(c);
+            mState = _State_ArrayFirst;
+            if (!mHandler->start_array()){
+                mState = _State_Stopped;
+                return false;
+            }
+            return true;
+        case '"':
+            cur++;
+            mState = _State_String;
+            mTokenIsKey = false;
+            mTokenBuffered = false;
+            return _ScanString(cur, end);
+        case VALUE_SEPARATOR:
+        case OBJECT_SYM_TAIL:
+        case ARRAY_SYM_TAIL:
+            throw JSonException::ParseUnknownValueType("");
+        default: break;
+        }
+        mState = _State_Scalar;
+        mTokenBuffered = false;
+        return _ScanScalar(cur, end);
+    }
+
+    // Scans the string at cur, which is assumed to be past the opening quote, or the point reached in the previous chunk.
+    bool JSonPushParser::_ScanString(const char_type* &cur, const char_type* end){
+        if (mState == _State_StringEscape){
+            // Completing the escape left in mEscape by the previous chunk, a character at a time.
+            while (true){
+                if (cur == end)
+                    return true;
+                mEscape += *cur++;
+                int used = _DecodeEscape(mEscape.data(), mEscape.size(), mToken);
+                if (used == 0)
+                    throw JSonException::ParseMalformed();
+                if (used > 0)
+                    break;
+            }
+            mState = _State_String;
+        }
+
+        while (true){
+            const char_type* head = cur;
+            while (cur != end && *cur != '"' && *cur != '\\')
+                cur++;
+
+            if (cur == end){
+                // The string continues in the next chunk.
+                if (!mTokenBuffered){
+                    mToken.clear();
+                    mTokenBuffered = true;
+                }
+                mToken.append(head, cur);
+                return true;
+            }
+
+            if (*cur == '"'){
+                cur++;
+                if (!mTokenBuffered) // The whole string was within this chunk, with no escapes... no need to copy it.
+                    return _EmitString(StringView(head, cur - head - 1));
+                mToken.append(head, cur - 1);
+                return _EmitString(StringView(mToken));
+            }
+
+            // An escape sequence.
+            if (!mTokenBuffered){
+                mToken.clear();
+                mTokenBuffered = true;
+            }
+            mToken.append(head, cur);
+            int used = _DecodeEscape(cur, end - cur, mToken);
+            if (used == 0)
+                throw JSonException::ParseMalformed();
+            if (used < 0){
+                // The escape continues in the next chunk.
+                mEscape.assign(cur, end);
+                cur = end;
+                mState = _State_StringEscape;
+                return true;
+            }
+            cur += used;
+        }
+    }
+
+    bool JSonPushParser::_EmitString(const StringView &s){
+        bool completed;
+        if (mTokenIsKey){
+            mState = _State_PairSeparator;
+            completed = mHandler->key(s);
+        } else {
+            mState = _State_AfterValue;
+            completed = mHandler->string(s);
+        }
+        if (!completed)
+            mState = _State_Stopped;
+        return completed;
+    }
+
+    // Scans the number or literal at cur, or the point reached in the previous chunk.
+    bool JSonPushParser::_ScanScalar(const char_type* &cur, const char_type* end){
+        const char_type* head = cur;
+        while (cur != end && !_IsDelimiter(*cur))
+            cur++;
+
+        if (cur == end){
+            // The scalar may continue in the next chunk.
+            if (!mTokenBuffered){
+                mToken.clear();
+                mTokenBuffered = true;
+            }
+            mToken.append(head, cur);
+            return true;
+        }
+
+        bool completed;
+        if (mTokenBuffered){
+            mToken.append(head, cur);
+            completed = _EmitOrThrow(_EmitScalar(mToken.data(), mToken.size(), *mHandler, mScratch), mToken.data(), mToken.size());
+        } else {
+            completed = _EmitOrThrow(_EmitScalar(head, cur - head, *mHandler, mScratch), head, cur - head);
+        }
+        mState = completed ? _State_AfterValue : _State_Stopped;
+        return completed;
+    }
+
+    bool JSonPushParser::_CloseContainer(char_type tail){
+        mStack.pop_back();
+        mState = mStack.empty() ? _State_Done : _State_AfterValue;
+        bool completed = (tail == OBJECT_SYM_TAIL) ? mHandler->end_object() : mHandler->end_array();
+        if (!completed)
+            mState = _State_Stopped;
+        return completed;
+    }
+
+
+    /* JSonValueBuilder
+     *
+     * The members of the open Objects and Arrays wait on mValues (and, for Object keys, mKeys) until their container
+     * closes. The container is then built at its final size, and takes the members' place on the stack.
+     */
+    JSonValueBuilder::JSonValueBuilder() : mResource(JSonHeapResource()), mKeyPool(nullptr){}
+    JSonValueBuilder::JSonValueBuilder(JSonMemoryResource* resource, JSonKeyPool* keys) :
+        mResource(resource != nullptr ? resource : JSonHeapResource()), mKeyPool(keys){}
+
+    JSonValue& JSonValueBuilder::value(){
+        return mRoot;
+    }
+
+    void JSonValueBuilder::reset(){
+        mRoot = nullptr;
+        mValues.clear();
+        mKeys.clear();
+        mFrames.clear();
+    }
+
+    JSonValue& JSonValueBuilder::_NextValue(){
+        if (mFrames.empty())
+            return mRoot;
+        mValues.push_back(JSonValue());
+        return mValues.back();
+    }
+
+    bool JSonValueBuilder::start_object(){
+        _Frame frame = {mValues.size(), mKeys.size()};
+        mFrames.push_back(frame);
+        return true;
+    }
+
+    bool JSonValueBuilder::key(const StringView &key){
+        if (mKeyPool != nullptr)
+            mKeys.push_back(mKeyPool->intern(key));
+        else
+            mKeys.push_back(JSonKey(key, mResource));
+        return true;
+    }
+
+    bool JSonValueBuilder::end_object(){
+        _Frame frame = mFrames.back();
+        mFrames.pop_back();
+
+        JSonValue obj;
+        obj._SetContainer(JSonType_Object, mResource);
+        obj.mData._object->pinned = (mKeyPool != nullptr);
+        Object& members = obj.mData._object->value;
+        members.reserve(mKeys.size() - frame.keys);
+        for (size_type k = frame.keys, v = frame.values; k < mKeys.size(); k++, v++){
+            // Duplicate keys keep their first position, but take the last value given.
+            std::pair<Object::iterator, bool> added = members.emplace(std::move(mKeys[k]), std::move(mValues[v]));
+            if (!added.second)
+                added.first->second = std::move(mValues[v]);
+        }
+        mValues.resize(frame.values);
+        mKeys.resize(frame.keys);
+
+        _NextValue() = std::move(obj);
+        return true;
+    }
+
+    bool JSonValueBuilder::start_array(){
+        _Frame frame = {mValues.size(), mKeys.size()};
+        mFrames.push_back(frame);
+        return true;
+    }
+
+    bool JSonValueBuilder::end_array(){
+        _Frame frame = mFrames.back();
+        mFrames.pop_back();
+
+        JSonValue arr;
+        arr._SetArray(mValues.data() + frame.values, mValues.size() - frame.values, mResource);
+        arr.mData._array->pinned = (mKeyPool != nullptr);
+        mValues.resize(frame.values);
+
+        _NextValue() = std::move(arr);
+        return true;
+    }
+
+    bool JSonValueBuilder::string(const StringView &value){
+        _NextValue()._SetString(value.data(), value.size(), mResource);
+        return true;
+    }
+
+    bool JSonValueBuilder::number_int(long long value){
+        _NextValue() = value;
+        return true;
+    }
+
+    bool JSonValueBuilder::number_double(double value){
+        _NextValue() = value;
+        return true;
+    }
+
+    bool JSonValueBuilder::boolean(bool value){
+        _NextValue() = value;
+        return true;
+    }
+
+    bool JSonValueBuilder::null(){
+        _NextValue() = nullptr;
+        return true;
+    }
+
+
+    /* JSonTape
+     *
+     * parse() walks the tokens found by mIndex much as JSonPushParser walks characters: mState records what is expected
+     * next, and mStack the containers open. Each value and key becomes an entry as its first token is reached. An Array
+     * or Object entry is finished (its end recorded) when its tail is reached. mStack is held to mLimits.max_depth, which
+     * also bounds the recursion of JSonCursor::to_value() and to_str() over what was recorded.
+     *
+     * Error reporting mirrors JSonParser so both throw the same JSonException codes for the same JSon strings.
+     */
+    JSonTape::JSonTape() : JSonTape(JSonParseLimits()){}
+
+    JSonTape::JSonTape(const JSonParseLimits &limits) : mData(nullptr), mEnd(nullptr), mLimits(limits){}
+
+    const JSonParseLimits& JSonTape::limits() const{
+        return mLimits;
+    }
+
+    void JSonTape::set_limits(const JSonParseLimits &limits){
+        mLimits = limits;
+    }
+
+    JSonTape& JSonTape::parse(const StringView &jsonstr){
+        return parse(jsonstr.data(), jsonstr.size());
+    }
+
+    JSonTape& JSonTape::parse(const char_type* data, size_type size){
+        if (size > std::numeric_limits<std::uint32_t>::max())
+            throw std::length_error("JSon string is too large for a JSonTape.");
+        mData = data;
+        mEnd = data + size;
+        mEntries.clear();
+        mStack.clear();
+        mDecoded.clear();
+        if (size > mLimits.max_size){
+            mData = nullptr;
+            throw JSonException::ParseTooLarge(mLimits.max_size);
+        }
+        if (JSonFindInvalidUtf8(data, size) != mEnd){
+            mData = nullptr;
+            throw JSonException::ParseInvalidEncoding();
+        }
+        mIndex.reset(data, size);
+
+        const char_type* tok = mIndex.next();
+        if (tok == nullptr || (*tok != OBJECT_SYM_HEAD && *tok != ARRAY_SYM_HEAD)){
+            mData = nullptr;
+            throw JSonException::ParseInvalidJsonContainer();
+        }
+
+        try{
+            _State state = _AddValue(tok);
+            while (!mStack.empty()){
+                tok = mIndex.next();
+                if (tok == nullptr)
+                    throw JSonException::ParseUnclosedStructure(static_cast<JSonType>(mEntries[mStack.back()].type));
+                char_type c = *tok;
+
+                switch(state){
+                case _State_ObjectFirst:
+                case _State_ObjectKey:
+                    if (c == OBJECT_SYM_TAIL && state == _State_ObjectFirst){
+                        mEntries[mStack.back()].end = static_cast<std::uint32_t>(mEntries.size());
+                        mStack.pop_back();
+                        state = _State_AfterValue;
+                        break;
+                    }
+                    if (c == OBJECT_SYM_TAIL)
+                        throw JSonException::ParseMissingValue();
+                    if (c != '"')
+                        throw JSonException::ParseMalformed();
+                    _AddString(tok);
+                    state = _State_PairSeparator;
+                    break;
+                case _State_PairSeparator:
+                    if (c != OBJECT_PAIR_SEPARATOR)
+                        throw JSonException::ParseMissingSymbol(OBJECT_PAIR_SEPARATOR);
+                    state = _State_ObjectValue;
+                    break;
+                case _State_ArrayFirst:
+                    if (c == ARRAY_SYM_TAIL){
+                        mEntries[mStack.back()].end = static_cast<std::uint32_t>(mEntries.size());
+                        mStack.pop_back();
+                        state = _State_AfterValue;
+                        break;
+                    }
+                    // Falls through: the first element is handled as any other.
+                case _State_ObjectValue:
+                case _State_ArrayValue:
+                    if (c == VALUE_SEPARATOR || c == OBJECT_SYM_TAIL || c == ARRAY_SYM_TAIL)
+                        throw JSonException::ParseMissingValue();
+                    mEntries[mStack.back()].size++;
+                    state = _AddValue(tok);
+                    break;
+                case _State_AfterValue:{
+                    bool object = (mEntries[mStack.back()].type == JSonType_Object);
+                    if (c == (object ? OBJECT_SYM_TAIL : ARRAY_SYM_TAIL)){
+                        mEntries[mStack.back()].end = static_cast<std::uint32_t>(mEntries.size());
+                        mStack.pop_back();
+                    } else if (c == VALUE_SEPARATOR){
+                        state = object ? _State_ObjectKey : _State_ArrayValue;
+                    } else {
+                        throw JSonException::ParseMissingSymbol(VALUE_SEPARATOR);
+                    }
+                    break;
+                }
+                }
+            }
+
+            // Only white space may follow the root container.
+            if (mIndex.next() != nullptr)
+                throw JSonException::ParseInvalidSymbol();
+        } catch (...){
+            mData = nullptr;
+            mEntries.clear();
+            throw;
+        }
+        return *this;
+    }
+
+    // Adds an entry for the value at tok, returning the state that follows it.
+    JSonTape::_State JSonTape::_AddValue(const char_type* tok){
+        _Entry entry = {static_cast<std::uint32_t>(tok - mData), 0, 0, JSonType_Null};
+        switch(*tok){
+        case OBJECT_SYM_HEAD:
+        case ARRAY_SYM_HEAD:
+            if (mStack.size() >= mLimits.max_depth)
+                throw JSonException::ParseTooDeep(mLimits.max_depth);
+            entry.type = (*tok == OBJECT_SYM_HEAD) ? JSonType_Object : JSonType_Array;
+            mStack.push_back(static_cast<std::uint32_t>(mEntries.size()));
+            mEntries.push_back(entry);
+            return (*tok == OBJECT_SYM_HEAD) ? _State_ObjectFirst : _State_ArrayFirst;
+        case '"':
+            _AddString(tok);
+            return _State_AfterValue;
+        default: break;
+        }
+
+        // Only the first character of a number or literal is indexed, so the rest is found by scanning to a delimiter.
+        const char_type* tail = tok + 1;
+        while (tail != mEnd && !_IsDelimiter(*tail))
+            tail++;
+        entry.size = static_cast<std::uint32_t>(tail - tok);
+        if (*tok == '-' || _IsDigit(*tok)){
+            entry.type = JSonType_Number;
+        } else {
+            // Literals are short enough to check now, so the entry's type is known.
+            struct LiteralHandler : public JSonHandler{
+                bool value = false;
+                bool isNull = false;
+                bool boolean(bool v){value = v; return true;}
+                bool null(){isNull = true; return true;}
+            } literal;
+            _EmitOrThrow(_EmitLiteral(tok, entry.size, literal), tok, entry.size);
+            entry.type = literal.isNull ? JSonType_Null : JSonType_Bool;
+            entry.size = literal.value ? 1 : 0;
+        }
+        mEntries.push_back(entry);
+        return _State_AfterValue;
+    }
+
+    // Adds an entry for the string (or key) whose opening quote is at tok.
+    void JSonTape::_AddString(const char_type* tok){
+        // The index always follows an opening quote with its closing quote... unless the source ends first.
+        const char_type* tail = mIndex.next();
+        if (tail == nullptr)
+            throw JSonException::ParseUnclosedStructure(JSonType_String);
+        _Entry entry = {static_cast<std::uint32_t>(tok - mData), static_cast<std::uint32_t>(tail - tok - 1), 0, JSonType_String};
+        mEntries.push_back(entry);
+    }
+
+    // Strings without escapes are viewed directly within the source, unless they must be null terminated; all others are
+    // decoded into mDecoded, once.
+    StringView JSonTape::_String(std::uint32_t entry, bool terminated) const{
+        const char_type* head = mData + mEntries[entry].offset + 1;
+        const char_type* stop = head + mEntries[entry].size;
+        const char_type* escape = static_cast<const char_type*>(std::memchr(head, '\\', stop - head));
+        if (escape == nullptr && !terminated)
+            return StringView(head, stop - head);
+
+        std::unordered_map<std::uint32_t, string_type>::iterator found = mDecoded.find(entry);
+        if (found != mDecoded.end())
+            return StringView(found->second);
+        string_type decoded(head, (escape != nullptr) ? escape : stop);
+        while (escape != nullptr){
+            int used = _DecodeEscape(escape, stop - escape, decoded);
+            if (used <= 0)
+                throw JSonException::ParseMalformed();
+            head = escape + used;
+            escape = static_cast<const char_type*>(std::memchr(head, '\\', stop - head));
+            decoded.append(head, (escape != nullptr) ? escape : stop);
+        }
+        return StringView(mDecoded.emplace(entry, std::move(decoded)).first->second);
+    }
+
+    JSonCursor JSonTape::root() const{
+        if (mEntries.empty())
+            return JSonCursor();
+        return JSonCursor(this, 0);
+    }
+
+    size_type JSonTape::size() const{
+        return mEntries.size();
+    }
+
+
+    JSonCursor::JSonCursor() : mTape(nullptr), mEntry(0){}
+
+    bool JSonCursor::is(JSonType t) const{
+        return type() == t;
+    }
+
+    JSonType JSonCursor::type() const{
+        return (mTape != nullptr) ? static_cast<JSonType>(mTape->mEntries[mEntry].type) : JSonType_Null;
+    }
+
+    size_type JSonCursor::size() const{
+        switch(type()){
+        case JSonType_Object:
+        case JSonType_Array:
+            return mTape->mEntries[mEntry].size;
+        case JSonType_String:
+            return get<StringView>().size();
+        case JSonType_Number:
+        case JSonType_Bool:
+            return 1;
+        default: break;
+        }
+        return 0;
+    }
+
+    void JSonCursor::_Expect(JSonType t) const{
+        if (type() != t)
+            throw JSonException::InvalidJSonType(t, type());
+    }
+
+    // Returns the entry of the member's value, or 0 (never a member) if the Object has no member with the key. Should the
+    // key be repeated, its last value is the one found, as JSonValueBuilder keeps.
+    std::uint32_t JSonCursor::_Find(const StringView &key) const{
+        const std::vector<JSonTape::_Entry>& entries = mTape->mEntries;
+        std::uint32_t end = entries[mEntry].end;
+        std::uint32_t found = 0;
+        for (std::uint32_t k = mEntry + 1; k < end; k = mTape->_Skip(k + 1)){
+            // Escape sequences only ever shorten a string, so shorter keys are passed over without decoding.
+            if (entries[k].size == key.size() || (entries[k].size > key.size() &&
+                std::memchr(mTape->mData + entries[k].offset + 1, '\\', entries[k].size) != nullptr)){
+                if (mTape->_String(k, false) == key)
+                    found = k + 1;
+            }
+        }
+        return found;
+    }
+
+    JSonCursor JSonCursor::at(const StringView &key) const{
+        _Expect(JSonType_Object);
+        std::uint32_t member = _Find(key);
+        if (member == 0)
+            throw JSonException::MissingKey(key.str());
+        return JSonCursor(mTape, member);
+    }
+
+    JSonCursor JSonCursor::at(size_type index) const{
+        _Expect(JSonType_Array);
+        if (index >= mTape->mEntries[mEntry].size)
+            throw JSonException::IndexOutOfBounds(index);
+        std::uint32_t element = mEntry + 1;
+        for (; index > 0; index--)
+            element = mTape->_Skip(element);
+        return JSonCursor(mTape, element);
+    }
+
+    bool JSonCursor::has_key(const StringView &key) const{
+        return type() == JSonType_Object && _Find(key) != 0;
+    }
+
+    JSonCursor::iterator JSonCursor::begin() const{
+        JSonType t = type();
+        if (t != JSonType_Object && t != JSonType_Array)
+            throw JSonException::InvalidJSonType(JSonType_Object, t);
+        return iterator(mTape, mEntry + 1, t == JSonType_Object);
+    }
+
+    JSonCursor::iterator JSonCursor::end() const{
+        JSonType t = type();
+        if (t != JSonType_Object && t != JSonType_Array)
+            throw JSonException::InvalidJSonType(JSonType_Object, t);
+        return iterator(mTape, mTape->mEntries[mEntry].end, t == JSonType_Object);
+    }
+
+    bool JSonCursor::_Number(long long &i, double &d) const{
+        _Expect(JSonType_Number);
+        struct NumberHandler : public JSonHandler{
+            long long i = 0;
+            double d = 0;
+            bool isInt = false;
+            bool number_int(long long v){i = v; isInt = true; return true;}
+            bool number_double(double v){d = v; return true;}
+        } number;
+        string_type scratch;
+        const JSonTape::_Entry& entry = mTape->mEntries[mEntry];
+        _EmitOrThrow(_EmitNumber(mTape->mData + entry.offset, entry.size, number, scratch), mTape->mData + entry.offset, entry.size);
+        i = number.i;
+        d = number.d;
+        return number.isInt;
+    }
+
+    JSonValue JSonCursor::to_value() const{
+        switch(type()){
+        case JSonType_Object:{
+            JSonValue value(JSonType_Object);
+            Object& members = value.get_object();
+            members.reserve(size());
+            for (iterator i = begin(); i != end(); i++){
+                // Repeated keys keep their first position, but take the last value given, as JSonValueBuilder does.
+                JSonValue member = (*i).to_value();
+                std::pair<Object::iterator, bool> added = members.emplace(i.key(), std::move(member));
+                if (!added.second)
+                    added.first->second = std::move(member);
+            }
+            return value;
+        }
+        case JSonType_Array:{
+            JSonValue value(JSonType_Array);
+            Array& elements = value.get_array();
+            elements.reserve(size());
+            for (iterator i = begin(); i != end(); i++)
+                elements.push_back((*i).to_value());
+            return value;
+        }
+        case JSonType_String:
+            return JSonValue(get<string_type>());
+        case JSonType_Number:{
+            long long i;
+            double d;
+            if (_Number(i, d))
+                return JSonValue(i);
+            return JSonValue(d);
+        }
+        case JSonType_Bool:
+            return JSonValue(get<bool>());
+        default: break;
+        }
+        return JSonValue();
+    }
+
+    string_type JSonCursor::to_str() const{
+        return to_value().to_str();
+    }
+
+    JSonCursor JSonCursor::iterator::operator*() const{
+        return JSonCursor(mTape, mObject ? mEntry + 1 : mEntry);
+    }
+
+    StringView JSonCursor::iterator::key() const{
+        if (!mObject)
+            throw JSonException::InvalidJSonType(JSonType_Object, JSonType_Array);
+        return mTape->_String(mEntry, false);
+    }
 
-            case 'b':
-                if (escaped){
-                    s.replace(i-1, 2, "\b");
-                    escaped = false;
-                } else {i++;}
-                break;
-            case 'f':
-                if (escaped){
-                    s.replace(i-1, 2, "\f");
-                    escaped = false;
-                } else {i++;}
-                break;
-            case 'n':
-                if (escaped){
-                    s.replace(i-1, 2, "\n");
-                    escaped = false;
-                } else {i++;}
-                break;
-            case 'r':
-                if (escaped){
-                    s.replace(i-1, 2, "\r");
-                    escaped = false;
-                } else {i++;}
-                break;
-            case 't':
-                if (escaped){
-                    s.replace(i-1, 2, "\t");
-                    escaped = false;
-                } else {i++;}
-                break;
-            default:
-                if (escaped)
-                    throw JSonException::ParseMalformed();
-                i++;
-            }
+    JSonCursor::iterator& JSonCursor::iterator::operator++(){
+        mEntry = mTape->_Skip(mObject ? mEntry + 1 : mEntry);
+        return *this;
+    }
+
+    JSonCursor::iterator JSonCursor::iterator::operator++(int){
+        iterator previous = *this;
+        ++*this;
+        return previous;
+    }
+
+
+    JSonValue& JSonValue::parse(const string_type &jsonstr){
+        return parse(jsonstr.data(), jsonstr.size());
+    }
+
+    JSonValue& JSonValue::parse(const char_type* jsonstr){
+        return parse(StringView(jsonstr));
+    }
+
+    JSonValue& JSonValue::parse(const StringView& jsonstr){
+        return parse(jsonstr.data(), jsonstr.size());
+    }
+
+    // The parser and builder behind JSonValue::parse(), kept for each thread so their buffers are reused from call to call.
+    struct _ParseContext{
+        JSonParser parser;
+        JSonValueBuilder builder;
+    };
+
+    static _ParseContext& _ThreadParseContext(){
+        static thread_local _ParseContext context;
+        return context;
+    }
+
+    JSonValue& JSonValue::parse(const char_type* data, size_type size){
+        // Parsing into a builder leaves this JSonValue untouched should the string turn out to be malformed.
+        _ParseContext& context = _ThreadParseContext();
+        try{
+            context.parser.parse(data, size, context.builder);
+        } catch (...){
+            context.builder.reset();
+            throw;
         }
+        return operator=(std::move(context.builder.value()));
+    }
 
-        return s;
+    JSonValue& JSonValue::parse(const StringView& jsonstr, const JSonSelector& selector){
+        _ParseContext& context = _ThreadParseContext();
+        try{
+            context.parser.parse(jsonstr.data(), jsonstr.size(), context.builder, selector);
+        } catch (...){
+            context.builder.reset();
+            throw;
+        }
+        return operator=(std::move(context.builder.value()));
     }
 
+    JSonParseResult JSonValue::try_parse(const StringView& jsonstr){
+        return try_parse(jsonstr.data(), jsonstr.size());
+    }
 
-    size_type _FindNextSymbol(const string_type src, const char_type symbol, size_type offset=0){
-        size_type depth = 0;
-        bool inQuotes = false;
+    JSonParseResult JSonValue::try_parse(const char_type* data, size_type size){
+        _ParseContext& context = _ThreadParseContext();
+        JSonParseResult result;
+        try{
+            result = context.parser.try_parse(data, size, context.builder);
+        } catch (...){
+            context.builder.reset();
+            throw;
+        }
+        if (!result){
+            context.builder.reset();
+            return result;
+        }
+        operator=(std::move(context.builder.value()));
+        return result;
+    }
 
-        for (size_type i = offset; i < src.size(); i++){
-            char_type c = src[i];
-            switch(c){
-            case '"':
-                if ((i > 0 && src[i-1] != '\\') || i == 0)
-                    inQuotes = !inQuotes;
-                break;
-            case OBJECT_SYM_HEAD:
-                if (symbol == OBJECT_SYM_HEAD && !inQuotes && depth == 0){
-                    return i;
-                }
-                depth += (inQuotes) ? 0 : 1;
-                break;
-            case ARRAY_SYM_HEAD:
-                if (symbol == ARRAY_SYM_HEAD && !inQuotes && depth == 0){
-                    return i;
-                }
-                depth += (inQuotes) ? 0 : 1;
-                break;
-            case OBJECT_SYM_TAIL:
-                depth -= (inQuotes || depth == 0) ? 0 : 1;
-                if (symbol == OBJECT_SYM_TAIL && !inQuotes && depth == 0){
-                    return i;
-                }
-                break;
-            case ARRAY_SYM_TAIL:
-                depth -= (inQuotes || depth == 0) ? 0 : 1;
-                if (symbol == ARRAY_SYM_TAIL && !inQuotes && depth == 0){
-                    return i;
-                }
-                break;
-            default:
-                if (src[i] == symbol && depth == 0 && !inQuotes)
-                    return i;
+    JSonValue& JSonValue::parse_file(const string_type& path){
+        JSonMappedFile file(path);
+        return parse(file.data(), file.size());
+    }
+
+
+/* --------------------------------------------------------------------------------------------
+ *  JSonMappedFile
+ -------------------------------------------------------------------------------------------- */
+
+#ifdef _WIN32
+    JSonMappedFile::JSonMappedFile() : mData(nullptr), mSize(0), mOpen(false), mFileHandle(INVALID_HANDLE_VALUE), mMapHandle(nullptr){}
+    JSonMappedFile::JSonMappedFile(const string_type &path) : mData(nullptr), mSize(0), mOpen(false), mFileHandle(INVALID_HANDLE_VALUE), mMapHandle(nullptr){open(path);}
+#else
+    JSonMappedFile::JSonMappedFile() : mData(nullptr), mSize(0), mOpen(false){}
+    JSonMappedFile::JSonMappedFile(const string_type &path) : mData(nullptr), mSize(0), mOpen(false){open(path);}
+#endif
+    JSonMappedFile::~JSonMappedFile(){close();}
+
+    bool JSonMappedFile::is_open() const{return mOpen;}
+    const char_type* JSonMappedFile::data() const{return mData;}
+    size_type JSonMappedFile::size() const{return mSize;}
+    StringView JSonMappedFile::view() const{return StringView(mData, mSize);}
+
+#ifdef _WIN32
+    void JSonMappedFile::open(const string_type &path){
+        close();
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw JSonException::FileUnreadable(path);
+
+        LARGE_INTEGER fsize;
+        if (!GetFileSizeEx(file, &fsize)){
+            CloseHandle(file);
+            throw JSonException::FileUnreadable(path);
+        }
+
+        // Windows refuses to map empty files, so those are left unmapped.
+        if (fsize.QuadPart > 0){
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            void* view = (mapping != nullptr) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (view == nullptr){
+                if (mapping != nullptr)
+                    CloseHandle(mapping);
+                CloseHandle(file);
+                throw JSonException::FileUnreadable(path);
+            }
+            mMapHandle = mapping;
+            mData = static_cast<const char_type*>(view);
+            mSize = static_cast<size_type>(fsize.QuadPart);
+        }
+        mFileHandle = file;
+        mOpen = true;
+    }
+
+    void JSonMappedFile::close(){
+        if (mData != nullptr)
+            UnmapViewOfFile(mData);
+        if (mMapHandle != nullptr)
+            CloseHandle(mMapHandle);
+        if (mFileHandle != INVALID_HANDLE_VALUE)
+            CloseHandle(mFileHandle);
+        mData = nullptr;
+        mSize = 0;
+        mOpen = false;
+        mFileHandle = INVALID_HANDLE_VALUE;
+        mMapHandle = nullptr;
+    }
+#else
+    void JSonMappedFile::open(const string_type &path){
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw JSonException::FileUnreadable(path);
+
+        struct stat st;
+        if (fstat(fd, &st) != 0){
+            ::close(fd);
+            throw JSonException::FileUnreadable(path);
+        }
+
+        // Empty files cannot be mapped, so those are left unmapped.
+        if (st.st_size > 0){
+            void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view == MAP_FAILED){
+                ::close(fd);
+                throw JSonException::FileUnreadable(path);
             }
+            // Parsers read front to back, so the kernel is asked to read ahead aggressively.
+            madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            mData = static_cast<const char_type*>(view);
+            mSize = static_cast<size_type>(st.st_size);
         }
-        return string_type::npos;
+        ::close(fd); // The mapping holds its own reference to the file.
+        mOpen = true;
     }
 
-    bool _IsNumber(const string_type &s){
-        bool found_decimal = false;
-        bool found_e = false;
-        bool checked_negorpos = false;
+    void JSonMappedFile::close(){
+        if (mData != nullptr)
+            munmap(const_cast<char_type*>(mData), mSize);
+        mData = nullptr;
+        mSize = 0;
+        mOpen = false;
+    }
+#endif
 
-        for (size_type i = 0; i < s.size(); i++){
-            if (!std::isdigit(s[i])){
-                if (checked_negorpos && (s[i] == '-' || s[i] == '+'))
-                    return false; // We can only have ONE '-' pr '+' at the BEGINNING of the number.
 
-                checked_negorpos = true;
-                if (!found_e && (s[i] == 'e' || s[i] == 'E')){
-                    found_e = true;
-                    found_decimal = false; // We can find one more.
-                    checked_negorpos = false; // we can find one more.
-                } else if (!found_decimal && s[i] == '.'){
-                    found_decimal = true;
-                } else {
-                    return false;
-                }
+/* --------------------------------------------------------------------------------------------
+ *  JSonSink and JSonWriter
+ -------------------------------------------------------------------------------------------- */
+
+    JSonStringSink::JSonStringSink(string_type &target) : mTarget(&target){}
+
+    void JSonStringSink::write(const char_type* data, size_type size){
+        mTarget->append(data, size);
+    }
+
+    JSonStreamSink::JSonStreamSink(std::ostream &stream) : mStream(&stream){}
+
+    void JSonStreamSink::write(const char_type* data, size_type size){
+        mStream->write(data, static_cast<std::streamsize>(size));
+        if (!*mStream)
+            throw JSonException::WriteFailed("stream in a failed state");
+    }
+
+    void JSonStreamSink::flush(){
+        mStream->flush();
+        if (!*mStream)
+            throw JSonException::WriteFailed("stream in a failed state");
+    }
+
+    JSonFdSink::JSonFdSink(int fd) : mFd(fd){}
+
+    void JSonFdSink::write(const char_type* data, size_type size){
+        // Pipes and sockets may take less than they're given, so keep going until all of it is written.
+        while (size > 0){
+#ifdef _WIN32
+            int written = _write(mFd, data, static_cast<unsigned int>(std::min<size_type>(size, 1 << 30)));
+#else
+            ssize_t written = ::write(mFd, data, size);
+#endif
+            if (written < 0){
+                if (errno == EINTR)
+                    continue;
+                throw JSonException::WriteFailed(std::strerror(errno));
             }
+            data += written;
+            size -= static_cast<size_type>(written);
         }
-        return true;
     }
 
-    bool _IsString(const string_type &s){
-        bool quotes_open = false;
-        bool found_escape = false;
 
-        for (size_type i = 0; i < s.size(); i++){
-            switch(s[i]){
-            case '"':
-                if (!found_escape){
-                    quotes_open = ! quotes_open;
-                } else {
-                    found_escape = false;
-                }
-                break;
-            case '\\':
-                if (!quotes_open){
-                    // There's no way to have an escape character if we're NOT in quotes.
-                    return false;
-                }
-                found_escape = !found_escape;
-                break;
-            default:
-                if (!std::isspace(s[i])){
-                    if (!quotes_open)
-                        return false;
-                    if (found_escape)
-                        found_escape = false;
-                }
-                break;
-            }
+    // Size of the buffer each JSonWriter gathers output into before handing it to the sink.
+    static const size_type WRITER_BUFFER_SIZE = 64 * 1024;
+
+    // The character following the backslash for characters which must be escaped in strings, or 0 for all others.
+    // Control characters without an escape of their own are written as \u00XX.
+    struct _EscapeTable{
+        char_type escapes[256];
+
+        _EscapeTable(){
+            std::memset(escapes, 0, sizeof(escapes));
+            for (int c = 0; c < 0x20; c++)
+                escapes[c] = 'u';
+            escapes[static_cast<unsigned char>('"')] = '"';
+            escapes[static_cast<unsigned char>('\\')] = '\\';
+            escapes[static_cast<unsigned char>('/')] = '/';
+            escapes[static_cast<unsigned char>('\b')] = 'b';
+            escapes[static_cast<unsigned char>('\f')] = 'f';
+            escapes[static_cast<unsigned char>('\n')] = 'n';
+            escapes[static_cast<unsigned char>('\r')] = 'r';
+            escapes[static_cast<unsigned char>('\t')] = 't';
         }
+    };
+
+    /* JSonWriter
+     *
+     * Output is gathered into mBuffer and handed to the sink only once it's full, so a sink sees a few large writes no
+     * matter how many small values there are. mFirst tracks whether each open container still awaits its first value
+     * (and so needs no separator), and mAfterKey whether the next value belongs to the key just written.
+     */
+    JSonWriter::JSonWriter(JSonSink &sink, const string_type &indentStr, size_type depth) : mSink(&sink), mIndent(indentStr), mDepth(depth),
+                                                                                          mBuffer(WRITER_BUFFER_SIZE), mUsed(0), mAfterKey(false){}
+
+    JSonWriter::~JSonWriter(){
+        try{
+            flush();
+        } catch (...) {}
+    }
 
-        return true;
+    JSonWriter& JSonWriter::write(const JSonValue &value){
+        _WriteValue(value);
+        return *this;
     }
 
-    JSonType _DetermineType(const string_type &src){
-        // I'd prefer REGEX, but I don't want to use Boost, and GCC has some issues.
-        //std::regex regString("\"(([^\"\\]*)|(\\[\"brnft])|(\\\\u[0-9][a-f]{4}))*\"");
-        //std::regex regNumber("(\\+|-)?\\d+(\\.\\d+)?([eE][-+]?\\d+)?");
-        //std::regex regBool("([Tt]{1}[Rr]{1}[Uu]{1}[Ee]{1})|([Ff]{1}[Aa]{1}[Ll]{1}[Ss]{1}[Ee]{1})");
-        //std::regex regNull("[Nn]{1}[Uu]{1}[Ll]{2}");
-
-        if (_IsString(src))
-            return JSonType_String;
-        if (_IsNumber(src))
-            return JSonType_Number;
-        if (_icaseeq(src, "true") or _icaseeq(src, "false"))
-            return JSonType_Bool;
-        if (_icaseeq(src, "null"))
-            return JSonType_Null;
-        else{
-            size_type fpos = src.find_first_not_of(" \r\n\f\v\t");
-            //string_type::const_iterator fchar = std::find_if(src.begin(), src.end(), std::not1(std::ptr_fun<int, int>(std::isspace)));
-            //if (fchar != src.end()){
-            if (fpos != string_type::npos){
-                //string_type::const_iterator lchar = std::find_if(src.rbegin(), src.rend(), std::not1(std::ptr_fun<int, int>(std::isspace))).base();
-                size_type lpos = src.find_last_not_of(" \r\n\f\v\t");
-                if (src[fpos] == OBJECT_SYM_HEAD){
-                    if (src[lpos] == OBJECT_SYM_TAIL)
-                        return JSonType_Object;
-                    throw JSonException::ParseUnclosedStructure(JSonType_Object);
-                }
-                else if (src[fpos] == ARRAY_SYM_HEAD){
-                    if (src[lpos] == ARRAY_SYM_TAIL)
-                        return JSonType_Array;
-                    throw JSonException::ParseUnclosedStructure(JSonType_Array);
+    void JSonWriter::flush(){
+        _Drain();
+        mSink->flush();
+    }
+
+    inline void JSonWriter::_Drain(){
+        if (mUsed > 0){
+            // Emptying the buffer first keeps a throwing sink from having the same output handed to it again.
+            size_type used = mUsed;
+            mUsed = 0;
+            mSink->write(mBuffer.data(), used);
+        }
+    }
+
+    inline void JSonWriter::_Put(char_type c){
+        if (mUsed == mBuffer.size())
+            _Drain();
+        mBuffer[mUsed++] = c;
+    }
+
+    void JSonWriter::_Put(const char_type* data, size_type size){
+        if (size > mBuffer.size() - mUsed){
+            _Drain();
+            // Anything as large as the buffer itself may as well go straight to the sink.
+            if (size >= mBuffer.size()){
+                mSink->write(data, size);
+                return;
+            }
+        }
+        std::memcpy(mBuffer.data() + mUsed, data, size);
+        mUsed += size;
+    }
+
+    void JSonWriter::_PutString(const StringView &s){
+        static const _EscapeTable table;
+        const char_type* escapes = table.escapes;
+        _Put('"');
+        const char_type* head = s.data();
+        const char_type* end = head + s.size();
+        for (const char_type* cur = head; cur != end; cur++){
+            char_type escape = escapes[static_cast<unsigned char>(*cur)];
+            if (escape != 0){
+                _Put(head, cur - head);
+                _Put('\\');
+                _Put(escape);
+                if (escape == 'u'){
+                    static const char_type HEX_DIGITS[] = "0123456789abcdef";
+                    const char_type digits[] = {'0', '0', HEX_DIGITS[(*cur >> 4) & 0xF], HEX_DIGITS[*cur & 0xF]};
+                    _Put(digits, 4);
                 }
+                head = cur + 1;
             }
         }
-        throw JSonException::ParseUnknownValueType(src);
+        _Put(head, end - head);
+        _Put('"');
     }
 
-    void _ParseObject(const string_type &src, JSonValue& jval){
-        // At this point, we only ASSUME we have an Object. Let's confirm...
-        size_type tailpos = _FindNextSymbol(src, OBJECT_SYM_TAIL);
-        if (tailpos == string_type::npos){ // If we didn't find the Object tail symbol, then this is JUNK!
-            throw JSonException::ParseUnclosedStructure(JSonType_Object);
+    // Writes the separator and indentation due before a value... unless the value follows a key, which has written them.
+    void JSonWriter::_BeforeValue(){
+        if (mAfterKey){
+            mAfterKey = false;
+            return;
         }
+        if (mFirst.empty())
+            return;
 
-        // Check that we only have white space after the Object tail symbol.
-        if (_trim(src.substr(tailpos+1)).size() != 0){
-            throw JSonException::ParseInvalidSymbol(); // If not... then this is junk!
+        if (!mFirst.back()){
+            _Put(VALUE_SEPARATOR);
+            if (!mIndent.empty())
+                _Put('\n');
         }
-        // If we're here, then we know that, structurally, anyway, this looks like a valid Object. Let's parse!
+        mFirst.back() = false;
+        for (size_type d = 0; d < mDepth + mFirst.size() && !mIndent.empty(); d++)
+            _Put(mIndent.data(), mIndent.size());
+    }
 
+    void JSonWriter::_Open(char_type head){
+        _BeforeValue();
+        _Put(head);
+        if (!mIndent.empty())
+            _Put('\n');
+        mFirst.push_back(true);
+    }
 
-        jval = JSonValue(JSonType_Object);
-        size_type spos = 1;
-        size_type epos = 0;
-        while (spos < tailpos){
-            // Find next value separator
-            epos = _FindNextSymbol(src, VALUE_SEPARATOR, spos);
-            // If we don't find a value separator, find the end of the object.
-            if (epos == string_type::npos){
-                epos = _FindNextSymbol(src, OBJECT_SYM_TAIL, spos);
-                if (epos == string_type::npos){
-                    // Technically, we should have already accounted for this case, but better safe than sorry.
-                    throw JSonException::ParseMissingSymbol(OBJECT_SYM_TAIL);
-                }
-            }
+    void JSonWriter::_Close(char_type tail){
+        mFirst.pop_back();
+        if (!mIndent.empty()){
+            _Put('\n');
+            for (size_type d = 0; d < mDepth + mFirst.size(); d++)
+                _Put(mIndent.data(), mIndent.size());
+        }
+        _Put(tail);
+    }
 
-            // Extracting the value pair substring.
-            string_type value = _trim(src.substr(spos, epos-spos));
+    bool JSonWriter::start_object(){
+        _Open(OBJECT_SYM_HEAD);
+        return true;
+    }
 
-            // Finding the pair separator.
-            size_type pairpos = _FindNextSymbol(value, OBJECT_PAIR_SEPARATOR);
-            if (pairpos == string_type::npos)
-                throw JSonException::ParseMissingSymbol(OBJECT_PAIR_SEPARATOR);
+    bool JSonWriter::key(const StringView &key){
+        _BeforeValue();
+        _PutString(key);
+        _Put(" : ", 3);
+        mAfterKey = true;
+        return true;
+    }
 
-            // Extracting the key name
-            string_type key = _deserializeChars(_trim(value.substr(0, pairpos)));
-            // Setting the value to the actual value substring.
-            value = _trim(value.substr(pairpos+1));
-            if (value.size() == 0) // Making sure we ACTUALLY have a value.
-                throw JSonException::ParseMalformed();
+    bool JSonWriter::end_object(){
+        _Close(OBJECT_SYM_TAIL);
+        return true;
+    }
 
-            JSonType vtype = _DetermineType(value);
-            switch(vtype){
-            case JSonType_Object:
-                {
-                    JSonValue v;
-                    _ParseObject(value, v);
-                    jval.get_object().insert({key, v});
-                }
-                break;
-            case JSonType_Array:
-                {
-                    JSonValue v;
-                    _ParseArray(value, v);
-                    jval.get_object().insert({key, v});
-                }
-                break;
-            case JSonType_String:
-                jval.get_object().insert({key, JSonValue(_deserializeChars(value))});
-                break;
-            case JSonType_Number:
-                if (value.find("e") == string_type::npos && value.find("E") == string_type::npos && value.find(".") == string_type::npos){
-                    jval.get_object().insert({key, JSonValue(std::stoll(value))});;
-                } else {
-                    jval.get_object().insert({key, JSonValue(std::stod(value))});
-                }
-                break;
-            case JSonType_Bool:
-                jval.get_object().insert({key, JSonValue(_icaseeq(value, "true"))});
-                break;
-            case JSonType_Null:
-                jval.get_object().insert({key, JSonValue()});
-                break;
+    bool JSonWriter::start_array(){
+        _Open(ARRAY_SYM_HEAD);
+        return true;
+    }
+
+    bool JSonWriter::end_array(){
+        _Close(ARRAY_SYM_TAIL);
+        return true;
+    }
+
+    bool JSonWriter::string(const StringView &value){
+        _BeforeValue();
+        _PutString(value);
+        return true;
+    }
+
+    bool JSonWriter::number_int(long long value){
+        _BeforeValue();
+        char_type buf[32];
+        _Put(buf, _FormatInt(value, buf) - buf);
+        return true;
+    }
+
+    bool JSonWriter::number_double(double value){
+        _BeforeValue();
+        char_type buf[32];
+        _Put(buf, _FormatDouble(value, buf) - buf);
+        return true;
+    }
+
+    bool JSonWriter::boolean(bool value){
+        _BeforeValue();
+        if (value)
+            _Put("true", 4);
+        else
+            _Put("false", 5);
+        return true;
+    }
+
+    bool JSonWriter::null(){
+        _BeforeValue();
+        _Put("null", 4);
+        return true;
+    }
+
+    void JSonWriter::_WriteValue(const JSonValue &value){
+        const JSonValue::_data* data = &value.mData;
+        switch(value.mDataType){
+        case JSonType_Null:
+            null(); break;
+        case JSonType_Bool:
+            boolean(data->_bool); break;
+        case JSonType_Number:
+            if (value.mNumberInt)
+                number_int(data->_numberi);
+            else
+                number_double(data->_number);
+            break;
+        case JSonType_String:
+            string(StringView(data->_string->data, data->_string->size)); break;
+        case JSonType_Object:
+            start_object();
+            for (Object::const_iterator i = data->_object->value.begin(); i != data->_object->value.end(); i++){
+                key(StringView(i->first));
+                _WriteValue(i->second);
             }
-            spos = epos+1;
-            if (epos != tailpos && _trim(src.substr(spos, tailpos-spos)).size() <= 0)
-                throw JSonException::ParseMissingValue();
+            end_object();
+            break;
+        case JSonType_Array:
+            start_array();
+            for (Array::const_iterator i = data->_array->value.begin(); i != data->_array->value.end(); i++)
+                _WriteValue(*i);
+            end_array();
+            break;
         }
     }
 
-    void _ParseArray(const string_type &src, JSonValue& jval){
-        // At this point, we only ASSUME we have an Array. Let's confirm...
-        size_type tailpos = _FindNextSymbol(src, ARRAY_SYM_TAIL);
-        if (tailpos == string_type::npos){ // If we didn't find the Array tail symbol, then this is JUNK!
-            throw JSonException::ParseMissingSymbol(ARRAY_SYM_TAIL);
-        }
 
-        // Check that we only have white space after the Array tail symbol.
-        if (_trim(src.substr(tailpos+1)).size() != 0){
-            throw JSonException::ParseMalformed(); // If not... then this is junk!
+
+/* --------------------------------------------------------------------------------------------
+ *  JSonArena
+ -------------------------------------------------------------------------------------------- */
+
+    const size_type JSonArena::DEFAULT_BLOCK_SIZE;
+    const size_type JSonArena::MAX_BLOCK_SIZE;
+
+    // Blocks start with their _Block header, padded so the memory following it is suitably aligned for anything.
+    static const size_type ARENA_HEADER_SIZE = (sizeof(void*) + sizeof(size_type) + alignof(std::max_align_t) - 1) /
+                                                alignof(std::max_align_t) * alignof(std::max_align_t);
+    static const size_type ARENA_MIN_BLOCK_SIZE = 1024;
+
+    JSonArena::JSonArena(size_type blockSize, JSonMemoryResource* upstream) :
+        mUpstream(upstream != nullptr ? upstream : JSonHeapResource()), mBlocks(nullptr), mCur(nullptr), mEnd(nullptr),
+        mFirstBlockSize(std::max(blockSize, ARENA_MIN_BLOCK_SIZE)), mNextBlockSize(std::max(blockSize, ARENA_MIN_BLOCK_SIZE)),
+        mUsed(0), mCapacity(0), mBlockCount(0){}
+
+    JSonArena::~JSonArena(){
+        release();
+    }
+
+    void JSonArena::release(){
+        while (mBlocks != nullptr){
+            _Block* next = mBlocks->next;
+            mUpstream->deallocate(mBlocks, ARENA_HEADER_SIZE + mBlocks->size);
+            mBlocks = next;
+        }
+        mCur = mEnd = nullptr;
+        mNextBlockSize = mFirstBlockSize;
+        mUsed = mCapacity = mBlockCount = 0;
+    }
+
+    void JSonArena::reset(){
+        if (mBlockCount > 1){
+            // The next block allocated is made big enough to hold everything this time around.
+            size_type total = mCapacity;
+            release();
+            mNextBlockSize = total;
+            return;
         }
-        // If we're here, then we know that, structurally, anyway, this looks like a valid Array. Let's parse!
+        if (mBlocks != nullptr){
+            mCur = reinterpret_cast<char*>(mBlocks) + ARENA_HEADER_SIZE;
+            mEnd = mCur + mBlocks->size;
+        }
+        mUsed = 0;
+    }
+
+    size_type JSonArena::used() const{return mUsed;}
+    size_type JSonArena::capacity() const{return mCapacity;}
+    size_type JSonArena::blocks() const{return mBlockCount;}
+
+    void* JSonArena::do_allocate(size_type size, size_type alignment){
+        if (size == 0)
+            size = 1;
+        std::uintptr_t cur = reinterpret_cast<std::uintptr_t>(mCur);
+        std::uintptr_t aligned = (cur + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+        if (mCur != nullptr && aligned - cur <= static_cast<size_type>(mEnd - mCur) &&
+            size <= static_cast<size_type>(mEnd - mCur) - (aligned - cur)){
+            mCur = reinterpret_cast<char*>(aligned) + size;
+            mUsed += size;
+            return reinterpret_cast<char*>(aligned);
+        }
+        return _Grow(size, alignment);
+    }
 
+    void JSonArena::do_deallocate(void* p, size_type size, size_type alignment){
+        // Memory is only ever given back all at once, by release().
+    }
 
-        jval = JSonValue(JSonType_Array);
-        size_type spos = 1;
-        size_type epos = 0;
-        while (spos < tailpos){
-            // Find next value separator
-            epos = _FindNextSymbol(src, VALUE_SEPARATOR, spos);
-            // If we don't find a value separator, find the end of the array.
-            if (epos == string_type::npos){
-                epos = _FindNextSymbol(src, ARRAY_SYM_TAIL, spos);
-                if (epos == string_type::npos){
-                    // Technically, we should have already accounted for this case, but better safe than sorry.
-                    throw JSonException::ParseMissingSymbol(ARRAY_SYM_TAIL);
-                }
+    void* JSonArena::_Grow(size_type size, size_type alignment){
+        size_type needed = size + (alignment > alignof(std::max_align_t) ? alignment : 0);
+        if (needed > mNextBlockSize / 2){
+            // Too big to share a block. It gets its own, placed behind the current block so that block stays in use.
+            _Block* block = static_cast<_Block*>(mUpstream->allocate(ARENA_HEADER_SIZE + needed));
+            block->size = needed;
+            if (mBlocks == nullptr){
+                block->next = nullptr;
+                mBlocks = block;
+            } else {
+                block->next = mBlocks->next;
+                mBlocks->next = block;
             }
+            mCapacity += needed;
+            mBlockCount++;
+            mUsed += size;
+            std::uintptr_t start = reinterpret_cast<std::uintptr_t>(block) + ARENA_HEADER_SIZE;
+            return reinterpret_cast<void*>((start + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1));
+        }
 
-            // Extracting the value substring.
-            string_type value = _trim(src.substr(spos, epos-spos));
-            if (value.size() == 0) // Making sure we ACTUALLY have a value.
-                throw JSonException::ParseMalformed();
+        _Block* block = static_cast<_Block*>(mUpstream->allocate(ARENA_HEADER_SIZE + mNextBlockSize));
+        block->size = mNextBlockSize;
+        block->next = mBlocks;
+        mBlocks = block;
+        mCur = reinterpret_cast<char*>(block) + ARENA_HEADER_SIZE;
+        mEnd = mCur + mNextBlockSize;
+        mCapacity += mNextBlockSize;
+        mBlockCount++;
+        if (mNextBlockSize < MAX_BLOCK_SIZE)
+            mNextBlockSize = std::min(mNextBlockSize * 2, MAX_BLOCK_SIZE);
+        return do_allocate(size, alignment);
+    }
 
-            JSonType vtype = _DetermineType(value);
-            switch(vtype){
-            case JSonType_Object:
-                {
-                    JSonValue v;
-                    _ParseObject(value, v);
-                    jval.get_array().push_back(v);
-                }
-                break;
-            case JSonType_Array:
-                {
-                    JSonValue v;
-                    _ParseArray(value, v);
-                    jval.get_array().push_back(v);
-                }
-                break;
-            case JSonType_String:
-                jval.get_array().push_back(JSonValue(_deserializeChars(value)));
-                break;
-            case JSonType_Number:
-                jval.get_array().push_back(JSonValue(std::stod(value)));
-                break;
-            case JSonType_Bool:
-                jval.get_array().push_back(JSonValue(_icaseeq(value, "true")));
-                break;
-            case JSonType_Null:
-                jval.get_array().push_back(JSonValue());
-                break;
-            }
-            spos = epos+1;
-            if (epos != tailpos && _trim(src.substr(spos, tailpos-spos)).size() <= 0)
-                throw JSonException::ParseMissingValue();
+
+/* --------------------------------------------------------------------------------------------
+ *  JSonDocument
+ -------------------------------------------------------------------------------------------- */
+
+    JSonDocument::JSonDocument(size_type blockSize, JSonMemoryResource* upstream, bool internKeys) :
+        mArena(blockSize, upstream), mKeyPool(&mArena), mInternKeys(internKeys), mReleaseValues(false),
+        mBuilder(&mArena, internKeys ? &mKeyPool : nullptr){}
+
+    JSonDocument::~JSonDocument(){
+        clear();
+    }
+
+    JSonDocument& JSonDocument::parse(const string_type &jsonstr){
+        return parse(jsonstr.data(), jsonstr.size());
+    }
+
+    JSonDocument& JSonDocument::parse(const char_type* jsonstr){
+        return parse(StringView(jsonstr));
+    }
+
+    JSonDocument& JSonDocument::parse(const StringView &jsonstr){
+        return parse(jsonstr.data(), jsonstr.size());
+    }
+
+    JSonDocument& JSonDocument::parse(const char_type* data, size_type size){
+        reset();
+        try{
+            mParser.parse(data, size, mBuilder);
+            mRoot = std::move(mBuilder.value());
+        } catch (...){
+            // Whatever the builder had built lives in the arena, and is worth nothing now.
+            mBuilder.reset();
+            reset();
+            throw;
         }
+        return *this;
     }
 
+    JSonParseResult JSonDocument::try_parse(const StringView &jsonstr){
+        return try_parse(jsonstr.data(), jsonstr.size());
+    }
 
-    string_type _StripCharacters(string_type s, string_type characters){
-        size_type pos = s.find_first_of(characters);
-        while (pos != string_type::npos){
-            s.erase(pos, 1);
-            pos = s.find_first_of(characters);
+    JSonParseResult JSonDocument::try_parse(const char_type* data, size_type size){
+        reset();
+        JSonParseResult result;
+        try{
+            result = mParser.try_parse(data, size, mBuilder);
+        } catch (...){
+            mBuilder.reset();
+            reset();
+            throw;
         }
-        return s;
+        if (!result){
+            mBuilder.reset();
+            reset();
+            return result;
+        }
+        mRoot = std::move(mBuilder.value());
+        return result;
+    }
+
+    JSonDocument& JSonDocument::parse_file(const string_type &path){
+        JSonMappedFile file(path);
+        return parse(file.data(), file.size());
+    }
+
+    const JSonValue& JSonDocument::root() const{
+        return mRoot;
+    }
+
+    JSonValue& JSonDocument::mutable_root(){
+        mReleaseValues = true;
+        return mRoot;
+    }
+
+    void JSonDocument::clear(){
+        _Discard();
+        mArena.release();
+    }
+
+    void JSonDocument::reset(){
+        _Discard();
+        mArena.reset();
+    }
+
+    void JSonDocument::_Discard(){
+        // Unless something outside the arena may hang off the tree, the tree is simply forgotten with the arena.
+        if (mReleaseValues)
+            mRoot = nullptr;
+        else
+            mRoot._Forget();
+        mKeyPool.clear();
+        mReleaseValues = false;
+    }
+
+    const JSonArena& JSonDocument::arena() const{
+        return mArena;
+    }
+
+    JSonKeyPool& JSonDocument::key_pool(){
+        return mKeyPool;
+    }
+
+    const JSonParseLimits& JSonDocument::limits() const{
+        return mParser.limits();
+    }
+
+    void JSonDocument::set_limits(const JSonParseLimits &limits){
+        mParser.set_limits(limits);
     }
 
 
@@ -987,17 +3880,29 @@ namespace OYAJSon {
     const unsigned int JSonException::ERR_PARSE_INVALIDSYMBOL           = 1014;
     const unsigned int JSonException::ERR_PARSE_UNKNOWNVALUETYPE        = 1015;
     const unsigned int JSonException::ERR_PARSE_MISSINGVALUE            = 1016;
+    const unsigned int JSonException::ERR_PARSE_TOODEEP                 = 1017;
+    const unsigned int JSonException::ERR_PARSE_TOOLARGE                = 1018;
+    const unsigned int JSonException::ERR_PARSE_INVALIDENCODING         = 1019;
+
+    const unsigned int JSonException::ERR_FILE_UNREADABLE               = 1020;
+    const unsigned int JSonException::ERR_WRITE_FAILED                  = 1021;
+    const unsigned int JSonException::ERR_PARSE_NUMBEROUTOFRANGE        = 1022;
 
     const unsigned int JSonException::ERR_INVALIDJSONTYPE               = 1001;
     const unsigned int JSonException::ERR_MISSINGKEY                    = 1002;
     const unsigned int JSonException::ERR_INDEXOUTOFBOUNDS              = 1003;
 
-    JSonException::JSonException(const string_type &msg, unsigned int code) : std::runtime_error(msg), m_code(code){}
+    // The code is formatted into the message up front, so what() can hand out a pointer that stays valid.
+    string_type _FormatExceptionMessage(const string_type &msg, unsigned int code){
+        std::stringstream ss;
+        ss << "[" << code << "] " << msg;
+        return ss.str();
+    }
+
+    JSonException::JSonException(const string_type &msg, unsigned int code) : std::runtime_error(_FormatExceptionMessage(msg, code)), m_code(code){}
 
     const char* JSonException::what() const throw(){
-        std::stringstream ss;
-        ss << "[" << m_code << "] " << std::runtime_error::what();
-        return ss.str().c_str();
+        return std::runtime_error::what();
     }
 
     unsigned int JSonException::get_code() const{
@@ -1035,7 +3940,7 @@ namespace OYAJSon {
     }
 
     JSonException JSonException::ParseMissingSymbol(char_type symbol){
-        string_type msg = "Parser failed to find expected symbol '" + string_type(&symbol) + "'.";
+        string_type msg = "Parser failed to find expected symbol '" + string_type(1, symbol) + "'.";
         return JSonException(msg, JSonException::ERR_PARSE_MISSINGSYMBOL);
     }
 
@@ -1054,10 +3959,40 @@ namespace OYAJSon {
         return JSonException(msg, JSonException::ERR_PARSE_UNKNOWNVALUETYPE);
     }
 
+    JSonException JSonException::ParseNumberOutOfRange(const string_type &value){
+        string_type msg = "Parser found a number beyond the range of a double, \"" + value + "\".";
+        return JSonException(msg, JSonException::ERR_PARSE_NUMBEROUTOFRANGE);
+    }
+
     JSonException JSonException::ParseMissingValue(){
         return JSonException("JSon Object or Array expecting additional values, but none found.", JSonException::ERR_PARSE_MISSINGVALUE);
     }
 
+    JSonException JSonException::ParseTooDeep(size_type maxDepth){
+        std::stringstream ss;
+        ss << "Parser found JSon Arrays and Objects nested deeper than " << maxDepth << " levels.";
+        return JSonException(ss.str(), JSonException::ERR_PARSE_TOODEEP);
+    }
+
+    JSonException JSonException::ParseTooLarge(size_type maxSize){
+        std::stringstream ss;
+        ss << "Parser given a JSon string longer than " << maxSize << " bytes.";
+        return JSonException(ss.str(), JSonException::ERR_PARSE_TOOLARGE);
+    }
+
+    JSonException JSonException::ParseInvalidEncoding(){
+        return JSonException("Parser found bytes that are not valid UTF-8.", JSonException::ERR_PARSE_INVALIDENCODING);
+    }
+
+    JSonException JSonException::FileUnreadable(const string_type &path){
+        string_type msg = "Unable to open or map file \"" + path + "\".";
+        return JSonException(msg, JSonException::ERR_FILE_UNREADABLE);
+    }
+
+    JSonException JSonException::WriteFailed(const string_type &reason){
+        return JSonException("Failed to write JSon: " + reason + ".", JSonException::ERR_WRITE_FAILED);
+    }
+
 
 } // End namespace "OYAJSon"
 
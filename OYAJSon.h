@@ -29,14 +29,23 @@
 
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <new>
 #include <sstream>
+#include <stdexcept>
 
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <vector>
+#include <ostream>
+#include <type_traits>
 
 #include <initializer_list>
+#include <tuple>
 
 
 extern const char* OYAJSON_VERSION; ///< The current version of OYAJSon. This is defined in an auto-generated file created just before compile time.
@@ -48,6 +57,11 @@ extern const char* OYAJSON_VERSION; ///< The current version of OYAJSon. This is
 namespace OYAJSon {
 
     class JSonValue;
+    class JSonObject;
+    class JSonKey;
+    struct JSonMember;
+    class JSonSelector;
+    struct JSonParseResult;
 
     /*! @typedef size_type
         @brief As defined by std::size_t
@@ -65,14 +79,194 @@ namespace OYAJSon {
         @brief As defined by std::string::value_type
     */
     typedef std::string::value_type char_type;
+
+    class JSonMemoryResource;
+
+    /*! Returns the JSonMemoryResource allocating from the global heap (operator new and delete).
+
+        This is the resource used by every Array, Object and String value not given another.
+    */
+    JSonMemoryResource* JSonHeapResource();
+
+    /*! The source of the memory used by Arrays, Objects and String values.
+
+        Modelled on C++17's std::pmr::memory_resource. Derive from it and implement do_allocate() and do_deallocate() to plug
+        any allocation scheme into OYAJSon. JSonArena is the monotonic resource used by JSonDocument.
+    */
+    class JSonMemoryResource{
+    public:
+        virtual ~JSonMemoryResource(){}
+
+        /*! Allocates memory from the resource.
+            @param size The number of bytes to allocate.
+            @param alignment The alignment required of the memory.
+            @return A pointer to at least size bytes of memory.
+            @throw std::bad_alloc if the memory cannot be allocated.
+        */
+        void* allocate(size_type size, size_type alignment=alignof(std::max_align_t)){return do_allocate(size, alignment);}
+
+        /*! Returns memory obtained from allocate() to the resource.
+            @param p The pointer returned by allocate().
+            @param size The size given to allocate().
+            @param alignment The alignment given to allocate().
+        */
+        void deallocate(void* p, size_type size, size_type alignment=alignof(std::max_align_t)){do_deallocate(p, size, alignment);}
+
+        /*! Returns true if memory allocated from this resource can be deallocated by the other, and vice versa. */
+        bool is_equal(const JSonMemoryResource& other) const{return this == &other || do_is_equal(other);}
+
+    protected:
+        virtual void* do_allocate(size_type size, size_type alignment) = 0;
+        virtual void do_deallocate(void* p, size_type size, size_type alignment) = 0;
+        virtual bool do_is_equal(const JSonMemoryResource& other) const{return false;}
+    };
+
+    /*! Standard library allocator drawing its memory from a JSonMemoryResource.
+
+        This is the allocator of the Array and Object containers. A default constructed JSonAllocator uses the global heap.
+
+        JSonValues copied into an Array or Object have their own Strings, Arrays and Objects allocated from the same resource,
+        all the way down.
+
+        Like std::pmr::polymorphic_allocator, the resource stays with the container it was given to. Copying a container gives the
+        copy a heap allocator, and assigning or swapping containers never exchanges their resources.
+    */
+    template <typename T> class JSonAllocator{
+    public:
+        typedef T value_type;
+        typedef std::false_type propagate_on_container_copy_assignment;
+        typedef std::false_type propagate_on_container_move_assignment;
+        typedef std::false_type propagate_on_container_swap;
+
+        /*! Creates a JSonAllocator using the global heap. */
+        JSonAllocator() : mResource(nullptr){}
+
+        /*! Creates a JSonAllocator using the given JSonMemoryResource.
+            @param resource The resource to allocate from. nullptr uses the global heap.
+        */
+        JSonAllocator(JSonMemoryResource* resource) : mResource(resource == JSonHeapResource() ? nullptr : resource){}
+
+        template <typename U> JSonAllocator(const JSonAllocator<U>& other) : mResource(other.mResource){}
+
+        T* allocate(size_type n){
+            if (n > static_cast<size_type>(-1) / sizeof(T))
+                throw std::bad_alloc();
+            if (mResource == nullptr)
+                return static_cast<T*>(::operator new(n * sizeof(T)));
+            return static_cast<T*>(mResource->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* p, size_type n){
+            if (mResource == nullptr)
+                ::operator delete(p);
+            else
+                mResource->deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+        /*! Constructs a copy of the given JSonValue, its Strings, Arrays and Objects allocated from this JSonAllocator's
+            resource. See JSonValue(const JSonValue&, JSonMemoryResource*).
+        */
+        void construct(JSonValue* p, const JSonValue& value);
+
+        /*! Constructs a copy of the given Object member, its key and value allocated from this JSonAllocator's resource. */
+        void construct(JSonMember* p, const JSonMember& member);
+
+        template <typename U, typename... Args> void construct(U* p, Args&&... args){
+            ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+        }
+
+        /*! Returns the JSonMemoryResource this JSonAllocator allocates from. */
+        JSonMemoryResource* resource() const{return mResource == nullptr ? JSonHeapResource() : mResource;}
+
+        JSonAllocator select_on_container_copy_construction() const{return JSonAllocator();}
+
+        template <typename U> bool operator==(const JSonAllocator<U>& rhs) const{
+            return mResource == rhs.mResource || (mResource != nullptr && rhs.mResource != nullptr && mResource->is_equal(*rhs.mResource));
+        }
+        template <typename U> bool operator!=(const JSonAllocator<U>& rhs) const{return !operator==(rhs);}
+
+    private:
+        template <typename U> friend class JSonAllocator;
+
+        JSonMemoryResource* mResource;
+    };
+
     /*! @typedef Array
-        @brief std::vector<JSonValue>
+        @brief std::vector<JSonValue> allocating through a JSonAllocator
     */
-    typedef std::vector<JSonValue> Array;
+    typedef std::vector<JSonValue, JSonAllocator<JSonValue> > Array;
     /*! @typedef Object
-        @brief std::map<string_type, JSonValue>
+        @brief JSonObject, the key/value members of a JSon Object in insertion order
+    */
+    typedef JSonObject Object;
+
+    /*! Non-owning view over a contiguous run of characters.
+
+        A StringView allows JSon held in buffers the caller already owns (network or IPC buffers, memory mapped files, etc.)
+        to be handed to OYAJSon without first copying it into a string_type.
+
+        \code{.cpp}
+            char buffer[4096];
+            size_type len = recv(sock, buffer, sizeof(buffer), 0);
+
+            JSonValue jval;
+            jval.parse(StringView(buffer, len)); // The buffer is parsed in place. Nothing is copied.
+        \endcode
+
+        __WARNING:__ A StringView does not own the characters it views. The characters must outlive the StringView.
     */
-    typedef std::map<string_type, JSonValue> Object;
+    class StringView{
+    public:
+        /*! Creates an empty StringView. */
+        StringView() : mData(nullptr), mSize(0){}
+
+        /*! Creates a StringView over the given characters.
+            @param data Pointer to the first character. Does not need to be null terminated.
+            @param size The number of characters viewed.
+        */
+        StringView(const char_type* data, size_type size) : mData(data), mSize(size){}
+
+        /*! Creates a StringView over the given null terminated string.
+            @param cstr A null terminated string.
+        */
+        StringView(const char_type* cstr) : mData(cstr), mSize(std::char_traits<char_type>::length(cstr)){}
+
+        /*! Creates a StringView over the characters of the given string_type.
+            @param s The string_type to view. Any modification to s may invalidate this StringView.
+        */
+        StringView(const string_type& s) : mData(s.data()), mSize(s.size()){}
+
+        /*! Creates a StringView over the characters of the given Object key.
+            @param key The JSonKey to view.
+        */
+        StringView(const JSonKey& key);
+
+        /*! Returns a pointer to the first character viewed. The characters are __not__ guaranteed to be null terminated. */
+        const char_type* data() const{return mData;}
+
+        /*! Returns the number of characters viewed. */
+        size_type size() const{return mSize;}
+
+        /*! Returns true if no characters are viewed. */
+        bool empty() const{return mSize == 0;}
+
+        const char_type* begin() const{return mData;}
+        const char_type* end() const{return mData + mSize;}
+
+        char_type operator[](size_type index) const{return mData[index];}
+
+        /*! Returns a string_type copy of the characters viewed. */
+        string_type str() const{return string_type(mData, mSize);}
+
+        bool operator==(const StringView& rhs) const{
+            return mSize == rhs.mSize && (mData == rhs.mData || std::char_traits<char_type>::compare(mData, rhs.mData, mSize) == 0);
+        }
+        bool operator!=(const StringView& rhs) const{return !operator==(rhs);}
+
+    private:
+        const char_type* mData;
+        size_type mSize;
+    };
 
     /*! @enum JSonType
         @brief Defines the core types used in a JSON.
@@ -159,32 +353,11 @@ namespace OYAJSon {
 
         Like with other JSonTypes, JSonValues of JSonType_Object and JSonType_Array can be assigned with the = operator.
 
-        However, unlike with the other types, the underlying data is *shared* after an assignment...
-
-        \code{.cpp}
-            JSonValue jobjA(JSonValue_Object);
-            JSonValue jobjB = jobjA; // Assigns jobjB the object in jobjA
-
-            jobjB.insert("KeyName", 5); // This inserts a new key into a JSonValue of JSonType_Object.
-            if (jobjB.has_key("KeyName"))
-                std::cout << "Object B has the key!" << std::endl;
-            else
-                std::cout << "Object B does NOT have the key :(" << std::endl;
-            // The above if statement would result in true and "Object B has the key!" would be printed.
-
-            if (jobjA.has_key("KeyName"))
-                std::cout << "Object A has the key!" << std::endl;
-            else
-                std::cout << "Object A does NOT have the key :(" << std::endl;
-            // The above if statement would ALSO result in true and "Object A has the key!" would be printed!
-            // This is because both jobjA and jobjB SHARE the same underlying Object.
-        \endcode
-
-        If one wants to make a "deep" copy of the underlying Array or Object, then the ::copy() method must be used.
+        Like every other type, assigning or copy constructing a JSonType_Object or JSonType_Array JSonValue copies the whole structure...
 
         \code{.cpp}
-            JSonType jarrA(Array{1, 2, true, "String Here!"}); // Creating an Array via inline initializing, then passing that into the constructor.
-            JSonType jarrB = jarrA.copy(); // Creating the second JSonValue as a copy of the first.
+            JSonValue jarrA(Array{1, 2, true, "String Here!"}); // Creating an Array via inline initializing, then passing that into the constructor.
+            JSonValue jarrB = jarrA; // Creating the second JSonValue as a copy of the first.
 
             // At this point both jarrA and jarrB contain an array of four elements with the exact same values. However...
             jarrA[3] = "This is a NEW string!";
@@ -194,6 +367,41 @@ namespace OYAJSon {
             // "This is a NEW string!"
             // "String Here!"
         \endcode
+
+        Copying an Array or Object is cheap: the copy refers to the same Array or Object until either JSonValue changes it,
+        and only then is it copied ("copy-on-write"). Changing an element clones just the Arrays and Objects on the way to it;
+        the rest of the tree stays shared. Strings are always copied.
+
+        Every non-const accessor (`operator[]`, `at()`, `get_object()`, `begin()`...) counts as a change. The reference it
+        returns belongs to this JSonValue alone, and stays that way: an Array or Object that has handed out references is
+        never shared again, so copies taken later get their own (copied one level deep, sharing what lies beneath) and never
+        see changes made through an old reference. Reading through a const JSonValue never copies anything.
+
+        \code{.cpp}
+            JSonValue jarrC = jarrA;              // No Array is copied.
+            const JSonValue& view = jarrC;
+            std::cout << view[0].get<int>();      // Still nothing copied.
+            jarrC[0] = 10;                        // jarrC gets an Array of its own; jarrA is left as it was.
+        \endcode
+
+        Copies that share may be read and changed from different threads, as long as each JSonValue itself is only used by
+        one thread at a time.
+
+        If two JSonValues should refer to the *same* Object or Array, sharing must be asked for with the ::share() method...
+
+        \code{.cpp}
+            JSonValue jobjA(JSonType_Object);
+            JSonValue jobjB = jobjA.share(); // jobjB now refers to the very same Object as jobjA
+
+            jobjB.insert("KeyName", 5);
+            if (jobjA.has_key("KeyName"))
+                std::cout << "Object A has the key!" << std::endl;
+            // The above if statement would result in true and "Object A has the key!" would be printed.
+            // This is because both jobjA and jobjB SHARE the same underlying Object.
+        \endcode
+
+        A JSonValue is 16 bytes. Nulls, Bools and Numbers are stored within the JSonValue itself, and only Strings, Objects
+        and Arrays allocate memory.
     */
     class JSonValue{
     public:
@@ -218,21 +426,41 @@ namespace OYAJSon {
         /*! Sets the JSonValue to the same value/type as the given JSonValue.
             @param value A const JSonValue object reference.
 
-            When assignment is done, the following JSonType JsonValues are copied
-            + JSonType_String
-            + JSonType_Number
-            + JSonType_Bool
+            An Array or Object isn't copied until one of the two JSonValues changes it (see the class notes). Use ::share() to
+            have two JSonValues keep referring to the same Object or Array instead.
+
+            An Array or Object obtained from ::share(), or built by a JSonValueBuilder with a JSonKeyPool, is copied right away.
+        */
+        JSonValue(const JSonValue &value);
+
+        /*! Takes over the value/type of the given JSonValue, leaving it as a JSonType_Null.
+            @param value A JSonValue rvalue reference.
+
+            No memory is allocated or copied.
+        */
+        JSonValue(JSonValue &&value) noexcept;
 
-            The following JSonType JSonValues __share__ their underlying data
-            + JSonType_Object
-            + JSonType_Array
+        /*! Sets the JSonValue to a copy of the given JSonValue, allocated from the given JSonMemoryResource.
+            @param value A const JSonValue object reference.
+            @param resource The resource every String, Array and Object of the copy is allocated from. nullptr uses the global heap.
+
+            The resource must outlive the copy. An Array or Object already allocated from the same resource is shared until
+            written to, as with the copy constructor.
 
-            If the desire is a unique copy of the Object or Array data, the following is possible...
             \code{.cpp}
-                JSonValue new_json_value(existing_json_object.copy());
+                JSonArena arena;
+                JSonValue inArena(jval, &arena); // jval, copied into the arena.
             \endcode
         */
-        JSonValue(const JSonValue &value);
+        JSonValue(const JSonValue &value, JSonMemoryResource* resource);
+
+        /*! Sets the JSonValue to the given JSonType, allocated from the given JSonMemoryResource.
+            @param type JSonType value in which to initialize the instance.
+            @param resource The resource an Array, Object or String is allocated from. nullptr uses the global heap.
+
+            The values are the same as for JSonValue(JSonType).
+        */
+        JSonValue(JSonType type, JSonMemoryResource* resource);
 
         /*! Sets a JSonValue to a JSonType_Object with an underlying data set to the given value.
             @param value An Object that will be copied into the internal JSonValue Object.
@@ -244,6 +472,16 @@ namespace OYAJSon {
         */
         JSonValue(const Array &value);
 
+        /*! Sets a JSonValue to a JSonType_Object, taking over the given Object's members. No member is copied.
+            @param value An Object rvalue reference. The Object keeps its allocator, but is left empty.
+        */
+        JSonValue(Object &&value);
+
+        /*! Sets a JSonValue to a JSonType_Array, taking over the given Array's elements. No element is copied.
+            @param value An Array rvalue reference. The Array keeps its allocator, but is left empty.
+        */
+        JSonValue(Array &&value);
+
         /*! Sets a JSonValue to a JSonType_String with an underlying data set to the given value.
             @param value A string_type
         */
@@ -347,11 +585,16 @@ namespace OYAJSon {
         */
         string_type type_str() const;
 
-        /*! Sets this JSonValue instance to the value/type of the given JSonValue instance.
+        /*! Sets this JSonValue instance to a copy of the value/type of the given JSonValue instance.
             @param value A const JSonValue reference.
         */
         void set(const JSonValue& value);
 
+        /*! Sets this JSonValue instance to the value/type of the given JSonValue instance, leaving it as a JSonType_Null.
+            @param value A JSonValue rvalue reference.
+        */
+        void set(JSonValue&& value);
+
         /*! Sets this JSonValue to a JSonType_Object defined by the given initializer list.
             @param ol const std::initializer_list<std::pair<string_type, JSonValue> >&
 
@@ -400,6 +643,16 @@ namespace OYAJSon {
                 jval.get<bool>(); // This will throw an exception.
             \endcode
 
+            A JSonType_String can be read without copying it, either as a StringView or as a null terminated string...
+
+            \code{.cpp}
+                if (message["type"].get<StringView>() == "login")
+                    route_login(message["user"].get<const char_type*>());
+            \endcode
+
+            Both refer to the JSonValue's own characters, so they're only valid until the JSonValue is changed or destroyed.
+            get<string_type>() returns a copy.
+
             There are no ::get<T>() methods for JSonType_Object or JSonType_Array.
 
             To access a JSonType_Object or JSonType_Array data structure, please use the get_object() and get_array() methods.
@@ -422,10 +675,22 @@ namespace OYAJSon {
         */
         Array& get_array();
 
+        /*! Returns a const reference to the underlying Object data.
+            @return A const reference to the underlying Object data.
+            @throws JSonException Exception thrown if this is not a JSonType_Object type.
+        */
+        const Object& get_object() const;
+
+        /*! Returns a const reference to the underlying Array data.
+            @return A const reference to the underlying Array data.
+            @throws JSonException Exception thrown if this is not a JSonType_Array type.
+        */
+        const Array& get_array() const;
+
 
         /*! Inserts the given key and value into this JSonType_Object JSonValue.
             @param key A const string_type& containing the new key name.
-            @param value A JSonValue& containing the value to store.
+            @param value A const JSonValue& containing the value to store.
             @throws JSonException if the JSonType for this JSonValue is not JSonType_Object, or if the given key already exists.
 
             This method is shorthand for the following...
@@ -434,11 +699,24 @@ namespace OYAJSon {
                 jObject.get_object().insert({key, value});
             \endcode
         */
-        void insert(const string_type &key, JSonValue &value);
+        void insert(const string_type &key, const JSonValue &value);
+
+        /*! Inserts the given key and value into this JSonType_Object JSonValue, taking over the value rather than copying it.
+            @param key A const string_type& containing the new key name.
+            @param value A JSonValue rvalue reference. It's left as a JSonType_Null, unless an exception is thrown.
+            @throws JSonException if the JSonType for this JSonValue is not JSonType_Object, or if the given key already exists.
+
+            \code{.cpp}
+                JSonValue records(JSonType_Array);
+                // ... fill in thousands of records ...
+                jObject.insert("records", std::move(records)); // Not a single record is copied.
+            \endcode
+        */
+        void insert(const string_type &key, JSonValue &&value);
 
         /*! Inserts the given JSonValue into this JSonType_Array JSonValue at the requested position.
             @param pos A size_type index before which to insert the new value.
-            @param value A JSonValue& to insert into the Array
+            @param value A const JSonValue& to insert into the Array
             @throws JSonException if the JSonType for this JSonValue is not JSonType_Array, or if the pos is out of bounds.
 
             This method is shorthand for the following...
@@ -447,11 +725,18 @@ namespace OYAJSon {
                 jArray.get_array().insert(pos, value);
             \endcode
         */
-        void insert(size_type pos, JSonValue &value);
+        void insert(size_type pos, const JSonValue &value);
+
+        /*! Inserts the given JSonValue into this JSonType_Array JSonValue at the requested position, taking it over rather than copying it.
+            @param pos A size_type index before which to insert the new value.
+            @param value A JSonValue rvalue reference to insert into the Array. It's left as a JSonType_Null.
+            @throws JSonException if the JSonType for this JSonValue is not JSonType_Array.
+        */
+        void insert(size_type pos, JSonValue &&value);
 
         /*! Inserts the given JSonValue into this JSonType_Array JSonValue before the given Array::iterator
             @param i An Array::iterator before which the given JSonValue will be inserted.
-            @param value A JSonValue& to insert into the Array
+            @param value A const JSonValue& to insert into the Array
             @throws JSonException if the JSonType for this JSonValue is not JSonType_Array.
 
             This method is shorthand for the following...
@@ -460,10 +745,17 @@ namespace OYAJSon {
                 jArray.get_array().insert(i, value);
             \endcode
         */
-        void insert(Array::iterator i, JSonValue &value);
+        void insert(Array::iterator i, const JSonValue &value);
+
+        /*! Inserts the given JSonValue into this JSonType_Array JSonValue before the given Array::iterator, taking it over rather than copying it.
+            @param i An Array::iterator before which the given JSonValue will be inserted.
+            @param value A JSonValue rvalue reference to insert into the Array. It's left as a JSonType_Null.
+            @throws JSonException if the JSonType for this JSonValue is not JSonType_Array.
+        */
+        void insert(Array::iterator i, JSonValue &&value);
 
         /*! Inserts the given JSonValue at the end of this JSonType_Array JSonValue.
-            @param value A JSonValue& to insert at the end of the Array.
+            @param value A const JSonValue& to insert at the end of the Array.
             @throws JSonException if the JSonType for this JSonValue is not JSonType_Array.
 
             This method is shorthand for the following...
@@ -472,13 +764,39 @@ namespace OYAJSon {
                 jArray.get_array().push_back(value);
             \endcode
         */
-        void push_back(JSonValue &value);
+        void push_back(const JSonValue &value);
+
+        /*! Inserts the given JSonValue at the end of this JSonType_Array JSonValue, taking it over rather than copying it.
+            @param value A JSonValue rvalue reference to insert at the end of the Array. It's left as a JSonType_Null.
+            @throws JSonException if the JSonType for this JSonValue is not JSonType_Array.
+        */
+        void push_back(JSonValue &&value);
+
+        /*! Constructs a JSonValue, in place, at the end of this JSonType_Array JSonValue.
+            @param args The arguments of any JSonValue constructor.
+            @return A reference to the new JSonValue.
+            @throws JSonException if the JSonType for this JSonValue is not JSonType_Array.
+
+            \code{.cpp}
+                jArray.emplace_back(5);
+                jArray.emplace_back(JSonType_Object)["name"] = string_type("Example");
+            \endcode
+        */
+        template <typename... Args> JSonValue& emplace_back(Args&&... args);
+
+        /*! Constructs a JSonValue from the given arguments and inserts it, under the given key, into this JSonType_Object JSonValue.
+            @param key The new key name.
+            @param args The arguments of any JSonValue constructor.
+            @return A reference to the new JSonValue.
+            @throws JSonException if the JSonType for this JSonValue is not JSonType_Object, or if the given key already exists.
+        */
+        template <typename... Args> JSonValue& emplace(const StringView &key, Args&&... args);
 
         /*! Returns the JSonValue at the given key within a JSonType_Object.
-            @param key A const string_type& key name from which to obtain the JSonValue.
+            @param key The key name from which to obtain the JSonValue. Looking it up copies nothing.
             @throws JSonException if the JSonType of this JSonValue is not JSonType_Object
         */
-        JSonValue& at(const string_type &key);
+        JSonValue& at(const StringView &key);
 
         /*! Returns the JSonValue at the given index within a JSonType_Array.
             @param index A size_type index from which to return the stored JSonValue.
@@ -486,12 +804,24 @@ namespace OYAJSon {
         */
         JSonValue& at(size_type index);
 
+        /*! Returns the JSonValue at the given key within a JSonType_Object.
+            @param key The key name from which to obtain the JSonValue. Looking it up copies nothing.
+            @throws JSonException if the JSonType of this JSonValue is not JSonType_Object or if the key does not exist.
+        */
+        const JSonValue& at(const StringView &key) const;
+
+        /*! Returns the JSonValue at the given index within a JSonType_Array.
+            @param index A size_type index from which to return the stored JSonValue.
+            @throws JSonException if the JSonType of this JSonValue is not JSonType_Array or if the index value is out of bounds.
+        */
+        const JSonValue& at(size_type index) const;
+
         /*! Returns true if the given key exists within the JSonType_Object JSonValue.
-            @param key A const string_type& key name.
+            @param key The key name.
             @return true if the key exists within the Object and false otherwise.
             @throws JSonException if this JSonValue is not of type JSonType_Object
         */
-        bool has_key(const string_type &key) const;
+        bool has_key(const StringView &key) const;
 
         /*! Returns true if all of the given keys in the vector exist within the JSonType_Object JSonValue.
             @param keys A const std::vector<string_type>& containing keys to test for.
@@ -515,6 +845,21 @@ namespace OYAJSon {
         */
         template <typename TI> TI begin();
 
+        /*! Template method to return a const iterator to the first item in the underlying Object or Array.
+            @return TI::const_iterator
+            @throws JSonException if the JSonType does not match the iterator type given.
+
+            Iterating a const Object copies nothing... each member's key is a JSonKey, holding its characters.
+
+            \code{.cpp}
+                for (Object::const_iterator i = jObject.begin<Object::const_iterator>(); i != jObject.end<Object::const_iterator>(); i++){
+                    StringView key = i->first.view();
+                    // ...
+                }
+            \endcode
+        */
+        template <typename TI> TI begin() const;
+
         /*! Template method to return an Iterator to the last item in the underlying Object or Array.
             @return TI::iterator
             @throws JSonException if the JSonType does not match the iterator type given.
@@ -530,6 +875,12 @@ namespace OYAJSon {
         */
         template <typename TI> TI end();
 
+        /*! Template method to return a const iterator past the last item in the underlying Object or Array.
+            @return TI::const_iterator
+            @throws JSonException if the JSonType does not match the iterator type given.
+        */
+        template <typename TI> TI end() const;
+
 
         /*! Returns the number of elements within the JSonValue.
             @return size_type value dependent on the JSonType of the object.
@@ -552,9 +903,99 @@ namespace OYAJSon {
             @throw JSonException if the given string is not a valid JSon string.
 
             The JSon string is considered valid if there is only one root value and that value must be either an Array or Object.
+
+            Should an Object repeat a key, the member keeps the position of the key's first occurrence and the value of its
+            last, as JavaScript's JSON.parse() does. Releases up to v0.3 kept the first value instead. Numbers are read as
+            a long long where they fit, otherwise as a double; those beyond the range of a double are an error
+            (ERR_PARSE_NUMBEROUTOFRANGE), and those too small for one round to zero.
+
+            The string is parsed in a single pass. Should parsing fail, this JSonValue is left unchanged. Arrays and Objects
+            may nest at most JSonParseLimits::DEFAULT_MAX_DEPTH deep; parse with a JSonParser for other limits.
+
+            The parser's buffers are kept by each thread for its next call. To reuse the memory of the tree itself as well,
+            parse into a JSonDocument.
         */
         JSonValue& parse(const string_type &jsonstr);
 
+        /*! Takes a valid, null terminated, JSon formatted string and parses it into this JSonValue.
+            @param jsonstr A null terminated string containing a valid JSon string.
+            @return A reference to this JSonValue object.
+            @throw JSonException if the given string is not a valid JSon string.
+        */
+        JSonValue& parse(const char_type* jsonstr);
+
+        /*! Takes a buffer holding a valid JSon formatted string and parses it, in place, into this JSonValue.
+            @param data Pointer to the start of the JSon string. The buffer does not need to be null terminated.
+            @param size The number of characters in the buffer.
+            @return A reference to this JSonValue object.
+            @throw JSonException if the given buffer is not a valid JSon string.
+
+            The buffer is never copied or modified. Only the decoded string values are copied out of it.
+        */
+        JSonValue& parse(const char_type* data, size_type size);
+
+        /*! Takes a StringView over a valid JSon formatted string and parses it, in place, into this JSonValue.
+            @param jsonstr A StringView of the JSon string.
+            @return A reference to this JSonValue object.
+            @throw JSonException if the viewed string is not a valid JSon string.
+
+            Semantically the same as `parse(jsonstr.data(), jsonstr.size())`
+        */
+        JSonValue& parse(const StringView& jsonstr);
+
+        /*! Parses only the parts of a JSon string picked by the given JSonSelector into this JSonValue.
+            @param jsonstr A StringView of the JSon string.
+            @param selector The JSON Pointers of the values wanted.
+            @return A reference to this JSonValue object.
+            @throw JSonException if the viewed string is not a valid JSon string.
+
+            The result has the shape of the whole JSon string, pruned down to the selected values and the Arrays and
+            Objects a pointer passes through on the way to them (even if nothing is found at its end). Everything else is
+            skipped without being decoded (see JSonParser).
+
+            \code{.cpp}
+                jval.parse(message, JSonSelector({"/meta/id", "/payload/items/0"}));
+                jval["payload"]["items"][0]; // The first item, and the only one kept.
+            \endcode
+        */
+        JSonValue& parse(const StringView& jsonstr, const JSonSelector& selector);
+
+        /*! Parses a JSon string into this JSonValue, reporting an invalid string in the returned JSonParseResult rather
+            than throwing.
+            @param data Pointer to the start of the JSon string. The buffer does not need to be null terminated.
+            @param size The number of characters in the buffer.
+            @return A JSonParseResult holding the error found, if any.
+
+            Meant for sources where malformed input is routine rather than exceptional. Should parsing fail, this JSonValue
+            is left unchanged.
+
+            \code{.cpp}
+                JSonParseResult result = jval.try_parse(data, size);
+                if (result.code == JSonException::ERR_PARSE_MISSINGVALUE)
+                    log_rejected(result.offset);
+            \endcode
+        */
+        JSonParseResult try_parse(const char_type* data, size_type size);
+
+        /*! Parses a JSon string into this JSonValue, reporting an invalid string in the returned JSonParseResult rather
+            than throwing.
+            @param jsonstr A StringView of the JSon string.
+            @return A JSonParseResult holding the error found, if any.
+
+            Semantically the same as `try_parse(jsonstr.data(), jsonstr.size())`
+        */
+        JSonParseResult try_parse(const StringView& jsonstr);
+
+        /*! Parses the JSon file at the given path into this JSonValue.
+            @param path The path of the file to parse.
+            @return A reference to this JSonValue object.
+            @throw JSonException if the file cannot be read or does not contain a valid JSon string.
+
+            The file is memory mapped and parsed directly from the mapping (see JSonMappedFile), so it's never read into
+            a string_type, and pages already in the OS page cache are reused.
+        */
+        JSonValue& parse_file(const string_type& path);
+
         /*! Returns the string form of the stored value.
             @return A string_type of the stored value.
 
@@ -572,27 +1013,58 @@ namespace OYAJSon {
 
             __NOTE:__ Calling this method on a JSonType_Object or JSonType_Array JSonValue will result in a __valid__ JSon string which can be used in
             the `parse()` method, or passed to other systems or services expecting JSon strings as values.
+
+            Doubles are written with the fewest digits that `parse()` turns back into the very same double, and always with a
+            decimal point or exponent so they stay doubles (`100.0` rather than `100`). NaN and infinity have no JSon
+            representation and are written as `null`.
         */
         string_type serialize(const string_type& indentStr, size_type depth=0) const;
 
-        /*! Creates and returns a "deep" copy of the value stored.
+        /*! Creates and returns a copy of the value stored.
             @return A new JSonValue containing a copy of the value(s) within this JSonValue
 
-            The intent of this method is to allow the creation of new, self contained JSonType_Array or JSonType_Object JSonValues that __DO NOT__
-            share the Array or Object underlying them.
+            The same as copy constructing a JSonValue. Changes to the copy are never seen by this JSonValue, even if this
+            JSonValue was obtained from ::share().
 
-            For Arrays and Objects, this method doesn't just create a copy of this JSonValue underlying Array/Object, but a copy of all of the JSonValues
-            stored within them as well. Multi-depth Arrays and Objects could take quite a bit of time to copy.
+            Arrays and Objects are copied on write: the copy refers to this JSonValue's Array or Object until one of them
+            changes it.
         */
         JSonValue copy() const;
 
+        /*! Returns a JSonValue referring to the same underlying Array or Object as this JSonValue.
+            @return A JSonValue sharing this JSonValue's Array or Object.
+
+            Changes made through either JSonValue are seen by both. The Array or Object is released once the last JSonValue
+            sharing it is destroyed or assigned a new value.
+
+            Strings, Numbers, Bools and Nulls are never shared; for them this method is the same as ::copy().
+
+            \code{.cpp}
+                JSonValue jarrA(JSonType_Array);
+                JSonValue jarrB = jarrA.share();
+
+                jarrB.push_back(value);
+                jarrA.size(); // 1
+            \endcode
+
+            __NOTE:__ Assigning or copying a shared JSonValue copies the Array or Object right away. Only ::share() creates another
+            reference.
+        */
+        JSonValue share();
+
 
-        /*! Sets this JSonValue to the type and value of the given JSonValue (shared copy for Array and Object types)
+        /*! Sets this JSonValue to a copy of the type and value of the given JSonValue
             @param rhs The JSonValue from which to obtain the new type/value
             @return Reference to this JSonValue
         */
         JSonValue& operator=(const JSonValue &rhs);
 
+        /*! Takes over the type and value of the given JSonValue, leaving it as a JSonType_Null.
+            @param rhs The JSonValue from which to take the new type/value
+            @return Reference to this JSonValue
+        */
+        JSonValue& operator=(JSonValue &&rhs) noexcept;
+
         /*! Sets this JSonValue a JSonType_Object and copies the given Object to an underlying Object.
             @param rhs
             @return Reference to this JSonValue
@@ -627,6 +1099,18 @@ namespace OYAJSon {
         */
         JSonValue& operator=(const Array &rhs);
 
+        /*! Sets this JSonValue a JSonType_Object, taking over the given Object's members. No member is copied.
+            @param rhs An Object rvalue reference. The Object keeps its allocator, but is left empty.
+            @return Reference to this JSonValue
+        */
+        JSonValue& operator=(Object &&rhs);
+
+        /*! Sets this JSonValue a JSonType_Array, taking over the given Array's elements. No element is copied.
+            @param rhs An Array rvalue reference. The Array keeps its allocator, but is left empty.
+            @return Reference to this JSonValue
+        */
+        JSonValue& operator=(Array &&rhs);
+
         /*! Sets this JSonValue a JSonType_String and copies the given string_type to an underlying string_type.
             @param rhs
             @return Reference to this JSonValue
@@ -741,11 +1225,11 @@ namespace OYAJSon {
         bool operator!=(const JSonValue& rhs) const;
 
         /*! Returns the JSonValue reference at the given key.
-            @param key A string_type key name within the Object
+            @param key A key name within the Object
             @return JSonValue&
             @throws JSonException if this JSonValue is not of type JSonType_Object or if key does not exist within the Object.
         */
-        JSonValue& operator[](const string_type &key);
+        JSonValue& operator[](const StringView &key);
 
         /*! Returns the JSonValue reference at the given index.
             @param index A size_type index within the Array
@@ -754,134 +1238,1925 @@ namespace OYAJSon {
         */
         JSonValue& operator[](size_type index);
 
+        /*! Returns the JSonValue at the given key.
+            @param key A key name within the Object
+            @return const JSonValue&
+            @throws JSonException if this JSonValue is not of type JSonType_Object or if key does not exist within the Object.
+
+            Unlike the non-const version, missing keys are never inserted.
+        */
+        const JSonValue& operator[](const StringView &key) const;
+
+        /*! Returns the JSonValue at the given index.
+            @param index A size_type index within the Array
+            @return const JSonValue&
+            @throws JSonException if this JSonValue is not of type JSonType_Array or if the index is out of bounds.
+        */
+        const JSonValue& operator[](size_type index) const;
+
     private:
+        // An Array or Object, counting the JSonValues referring to it. Copies refer to it until one of them changes it.
+        // Once pinned, copies get one of their own instead: it's been share()d, so every JSonValue referring to it sees
+        // every change... or it was built with keys from a JSonKeyPool, which copies mustn't depend on. Once lent, copies
+        // get one of their own too: a non-const accessor has handed out a reference into it, which may yet be written through.
+        template <typename T> struct _Shared{
+            T value;
+            std::atomic<unsigned int> refs;
+            bool pinned;
+            bool lent;
+
+            explicit _Shared(JSonMemoryResource* resource) : value(typename T::allocator_type(resource)), refs(1), pinned(false), lent(false){}
+            explicit _Shared(const T& v) : value(v), refs(1), pinned(false), lent(false){}
+            explicit _Shared(T&& v) : value(std::move(v)), refs(1), pinned(false), lent(false){}
+            _Shared(const T& v, JSonMemoryResource* resource) : value(v, typename T::allocator_type(resource)), refs(1), pinned(false), lent(false){}
+        };
+
+        // A String value, allocated in a single block from the resource it records.
+        struct _String{
+            JSonMemoryResource* resource;
+            size_type size;
+            char_type data[1]; // size characters and a null terminator.
+        };
+
         union _data{
-            Array* _array;
-            Object* _object;
-            string_type* _string;
+            _Shared<Array>* _array;
+            _Shared<Object>* _object;
+            _String* _string;
             bool _bool;
             double _number;
             long long _numberi;
         };
 
-        std::shared_ptr<_data> mData;
-        //_data* mData;
+        _data mData;
         JSonType mDataType;
         bool mNumberInt;
 
-        void _ClearData();
-        string_type Serialize_str(const string_type& s) const;
+        void _CopyFrom(const JSonValue& value);
+        void _Release();
+        void _Detach();
+        void _Lend();
+
+        // Used by JSonValueBuilder and JSonDocument to build values within a given JSonMemoryResource.
+        void _SetString(const char_type* str, size_type size, JSonMemoryResource* resource);
+        void _SetContainer(JSonType type, JSonMemoryResource* resource);
+        void _SetArray(JSonValue* values, size_type count, JSonMemoryResource* resource);
+
+        // Drops the value without releasing it. Only for values whose memory is released in bulk (see JSonDocument).
+        void _Forget();
+
+        friend class JSonWriter;
+        friend class JSonValueBuilder;
+        friend class JSonDocument;
+        friend class JSonFrozen;
     };
 
 
     // ------------------------------------------------------------------------------------------------------
     // ------------------------------------------------------------------------------------------------------
-    // CLASS: JSonException
+    // CLASS: JSonObject
     // ------------------------------------------------------------------------------------------------------
     // ------------------------------------------------------------------------------------------------------
 
-    /*! OYAJSon's JSon exception class.
+    /*! The key of a JSonObject member.
 
-        Can be thrown directly, or can be thrown by calling any one of the static methods for consistent error message formatting.
+        Holds its characters, null terminated, in a single block along with their length and hash. The block is allocated
+        from the resource of the Object holding the member, unless the key was interned by a JSonKeyPool. An interned key
+        refers to the pool's copy of its characters instead, and must not be used once the pool is cleared or destroyed.
+        Copying an interned key gives a key with a copy of its own.
+
+        A JSonKey converts to a string_type as needed, can be viewed through a StringView, and compares with both...
 
         \code{.cpp}
-            // Example - Assuming jArr is of type JSonType_Array
-            try{
-                if (!jArr.is(JSonType_Object))
-                    throw JSonException::InvalidJSonType(JSonType_Object, jArr.type());
-            catch (JSonException e){
-                std::cout << e.what() << std::endl;
-                // Outputs "[1001] Operation expecting JSonValue type Object but JSonValue is of type Array."
+            const Object& obj = jObject.get_object();
+            for (Object::const_iterator i = obj.begin(); i != obj.end(); i++){
+                if (i->first == "name")
+                    std::cout << i->first << " = " << i->second.to_str() << std::endl;
+            }
+        \endcode
+    */
+    class JSonKey{
+    public:
+        /*! Creates an empty key. */
+        JSonKey();
+
+        /*! Creates a key holding a copy of the given characters.
+            @param key The characters of the key.
+            @param resource The resource to allocate the key from. nullptr uses the global heap.
+        */
+        explicit JSonKey(const StringView &key, JSonMemoryResource* resource=nullptr);
+
+        JSonKey(const JSonKey &key);
+
+        /*! Creates a copy of the given key, allocated from the given resource.
+            @param key The key to copy.
+            @param resource The resource to allocate the key from. nullptr uses the global heap.
+        */
+        JSonKey(const JSonKey &key, JSonMemoryResource* resource);
+
+        JSonKey(JSonKey &&key) noexcept;
+        ~JSonKey();
+
+        JSonKey& operator=(const JSonKey &rhs);
+        JSonKey& operator=(JSonKey &&rhs) noexcept;
+
+        /*! Returns a pointer to the null terminated characters of the key. */
+        const char_type* data() const;
+
+        /*! Returns a pointer to the null terminated characters of the key. */
+        const char_type* c_str() const;
+
+        /*! Returns the number of characters in the key. */
+        size_type size() const;
+
+        /*! Returns true if the key has no characters. */
+        bool empty() const;
+
+        /*! Returns the hash of the key's characters, as used by JSonObject. */
+        std::uint32_t hash() const;
+
+        /*! Returns a copy of the key as a string_type. */
+        string_type str() const;
+
+        /*! Returns a StringView of the key's characters. The view is valid for as long as the key exists. */
+        StringView view() const;
+
+        operator string_type() const{return str();}
+
+        bool operator==(const JSonKey &rhs) const;
+        bool operator!=(const JSonKey &rhs) const{return !operator==(rhs);}
+        bool operator==(const StringView &rhs) const;
+        bool operator!=(const StringView &rhs) const{return !operator==(rhs);}
+        bool operator==(const char_type* rhs) const{return operator==(StringView(rhs));}
+        bool operator!=(const char_type* rhs) const{return !operator==(StringView(rhs));}
+        bool operator==(const string_type &rhs) const{return operator==(StringView(rhs));}
+        bool operator!=(const string_type &rhs) const{return !operator==(StringView(rhs));}
+
+    private:
+        struct _Rep{
+            JSonMemoryResource* resource;
+            std::uint32_t size;
+            std::uint32_t hash;
+            char_type data[1]; // size characters and a null terminator.
+        };
+
+        static const std::uintptr_t INTERNED = 1; // Set in mRep for keys interned by a JSonKeyPool, which owns their _Rep.
+
+        std::uintptr_t mRep; // The address of the key's _Rep, if any, and the INTERNED flag.
+
+        _Rep* _Get() const{return reinterpret_cast<_Rep*>(mRep & ~INTERNED);}
+
+        void _Assign(const char_type* key, size_type size, std::uint32_t hash, JSonMemoryResource* resource);
+        void _Release();
+
+        friend class JSonObject;
+        friend class JSonKeyPool;
+    };
+
+    /*! Writes the characters of the key to the given stream. */
+    std::ostream& operator<<(std::ostream& os, const JSonKey &key);
+
+    inline StringView::StringView(const JSonKey& key) : mData(key.data()), mSize(key.size()){}
+
+    /*! A key/value member of a JSonObject.
+
+        __WARNING:__ The key of a member within an Object must not be assigned to. The Object's index depends on it.
+    */
+    struct JSonMember{
+        JSonKey first;      ///< The member's key.
+        JSonValue second;   ///< The member's value.
+
+        JSonMember(const JSonKey &key, JSonValue &&value) : first(key), second(std::move(value)){}
+        JSonMember(JSonKey &&key, JSonValue &&value) : first(std::move(key)), second(std::move(value)){}
+
+        /*! Creates a copy of the given member, its key and value allocated from the given resource. */
+        JSonMember(const JSonMember &member, JSonMemoryResource* resource) : first(member.first, resource), second(member.second, resource){}
+
+        JSonMember(const JSonMember &member) : first(member.first), second(member.second){}
+        JSonMember(JSonMember &&member) noexcept : first(std::move(member.first)), second(std::move(member.second)){}
+        JSonMember& operator=(const JSonMember &rhs){first = rhs.first; second = rhs.second; return *this;}
+        JSonMember& operator=(JSonMember &&rhs) noexcept{first = std::move(rhs.first); second = std::move(rhs.second); return *this;}
+    };
+
+    /*! The members of a JSon Object, in the order they were inserted.
+
+        The members are stored contiguously. Small Objects are searched linearly, comparing key hashes before any
+        characters. Once an Object holds more than INDEX_THRESHOLD members it also keeps an open addressing hash index of
+        its members.
+
+        Its interface follows std::map's, so iterating yields JSonMembers with `first` (the JSonKey) and `second` (the
+        JSonValue)...
+
+        \code{.cpp}
+            Object& obj = jObject.get_object();
+            obj["added"] = 5;
+            for (Object::iterator i = obj.begin(); i != obj.end(); i++)
+                std::cout << i->first << std::endl;
+        \endcode
+
+        __WARNING:__ Unlike std::map, adding or erasing members invalidates iterators and references to all members.
+
+        Erasing a member keeps the order of the others, but costs time proportional to the size of the Object.
+    */
+    class JSonObject{
+    public:
+        typedef JSonKey key_type;
+        typedef JSonValue mapped_type;
+        typedef JSonMember value_type;
+        typedef JSonAllocator<JSonMember> allocator_type;
+        typedef std::vector<JSonMember, allocator_type>::iterator iterator;
+        typedef std::vector<JSonMember, allocator_type>::const_iterator const_iterator;
+
+        static const size_type INDEX_THRESHOLD = 16; ///< The number of members past which an Object is indexed.
+
+        /*! Creates an empty Object allocating from the global heap. */
+        JSonObject();
+
+        /*! Creates an empty Object allocating from the given allocator's resource. */
+        explicit JSonObject(const allocator_type &alloc);
+
+        /*! Creates an Object holding the given members. Should a key repeat, its first value is kept.
+            @param members The members, in order.
+            @param alloc The allocator to allocate with.
+        */
+        JSonObject(std::initializer_list<std::pair<string_type, JSonValue> > members, const allocator_type &alloc=allocator_type());
+
+        /*! Creates a copy of the given Object, allocated from the global heap. */
+        JSonObject(const JSonObject &obj);
+
+        /*! Creates a copy of the given Object, allocated from the given allocator's resource. */
+        JSonObject(const JSonObject &obj, const allocator_type &alloc);
+
+        JSonObject(JSonObject &&obj) noexcept;
+        ~JSonObject();
+
+        JSonObject& operator=(const JSonObject &rhs);
+        JSonObject& operator=(JSonObject &&rhs);
+
+        allocator_type get_allocator() const;
+
+        iterator begin();
+        iterator end();
+        const_iterator begin() const;
+        const_iterator end() const;
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+
+        /*! Returns the number of members. */
+        size_type size() const;
+
+        /*! Returns true if there are no members. */
+        bool empty() const;
+
+        /*! Reserves room for the given number of members. */
+        void reserve(size_type count);
+
+        /*! Erases every member. */
+        void clear();
+
+        /*! Returns an iterator to the member with the given key, or end() if there is none. */
+        iterator find(const StringView &key);
+
+        /*! Returns an iterator to the member with the given key, or end() if there is none. */
+        const_iterator find(const StringView &key) const;
+
+        /*! Returns an iterator to the member with the given key, or end() if there is none.
+
+            Should the key have been interned by the JSonKeyPool the Object's keys were interned by, a member is found by
+            comparing pointers rather than characters.
+        */
+        iterator find(const JSonKey &key);
+
+        /*! Returns an iterator to the member with the given key, or end() if there is none. */
+        const_iterator find(const JSonKey &key) const;
+
+        /*! Returns 1 if a member has the given key, and 0 otherwise. */
+        size_type count(const StringView &key) const;
+
+        /*! Returns the value of the member with the given key.
+            @throw JSonException if there is no member with the key.
+        */
+        JSonValue& at(const StringView &key);
+
+        /*! Returns the value of the member with the given key.
+            @throw JSonException if there is no member with the key.
+        */
+        const JSonValue& at(const StringView &key) const;
+
+        /*! Returns the value of the member with the given key, adding a JSonType_Null member should there be none. */
+        JSonValue& operator[](const StringView &key);
+
+        /*! Adds a copy of the given member, unless a member already has its key.
+            @return An iterator to the member with the key, and true if the member was added.
+        */
+        std::pair<iterator, bool> insert(const std::pair<string_type, JSonValue> &member);
+
+        /*! Adds a member with a copy of the given value, unless a member already has the key.
+            @return An iterator to the member with the key, and true if the member was added.
+        */
+        std::pair<iterator, bool> emplace(const StringView &key, const JSonValue &value);
+
+        /*! Adds a member taking over the given value, unless a member already has the key. The value is untouched if not added.
+            @return An iterator to the member with the key, and true if the member was added.
+        */
+        std::pair<iterator, bool> emplace(const StringView &key, JSonValue &&value);
+
+        /*! Adds a member taking over the given key and value, unless a member already has the key. Neither is touched if not added.
+
+            The key is kept as it is, wherever it was allocated... including keys interned by a JSonKeyPool. Copies of a
+            JSonValue holding this Object refer to the same keys until written to, so they mustn't outlive the pool either.
+            @return An iterator to the member with the key, and true if the member was added.
+        */
+        std::pair<iterator, bool> emplace(JSonKey &&key, JSonValue &&value);
+
+        /*! Erases the member at the given position.
+            @return An iterator to the member following the one erased.
+        */
+        iterator erase(const_iterator pos);
+
+        /*! Erases the member with the given key, if any.
+            @return The number of members erased.
+        */
+        size_type erase(const StringView &key);
+
+        /*! Returns true if both Objects have the same keys, with equal values. The order of the members is irrelevant. */
+        bool operator==(const JSonObject &rhs) const;
+        bool operator!=(const JSonObject &rhs) const;
+
+    private:
+        std::vector<JSonMember, allocator_type> mMembers;
+        std::uint32_t* mIndex;   // Member position + 1 for each slot in use, 0 for empty slots.
+        size_type mIndexSize;    // A power of two, at least twice the number of members. 0 when not indexed.
+
+        size_type _Find(const char_type* key, size_type size, std::uint32_t hash, const JSonKey::_Rep* rep=nullptr) const;
+        void _Added();
+        void _Reindex(size_type count);
+        void _ReleaseIndex();
+        void _Swap(JSonObject &other) noexcept;
+    };
+
+    /*! Interns Object keys, so every Object member with the same key refers to a single copy of its characters.
+
+        Records parsed from the same source tend to repeat the same few keys over and over. Given to a JSonValueBuilder (or
+        enabled on a JSonDocument), a JSonKeyPool stores each distinct key once, rather than once per member.
+
+        \code{.cpp}
+            JSonKeyPool pool;
+            JSonValueBuilder builder(nullptr, &pool);
+            JSonParser parser;
+            parser.parse(jsonstr, builder);
+
+            JSonValue records = std::move(builder.value());
+            JSonKey id = pool.intern("id");
+            for (size_type i = 0; i < records.size(); i++){
+                const Object& record = records[i].get_object();
+                Object::const_iterator member = record.find(id); // Found by comparing pointers.
+            }
+        \endcode
+
+        __WARNING:__ The keys interned refer to the pool's characters, so the pool must outlive every Object built with it
+        (copies of those Objects have keys of their own). A JSonKeyPool may only be used by one thread at a time.
+    */
+    class JSonKeyPool{
+    public:
+        /*! Creates an empty pool.
+            @param resource The resource the interned keys are allocated from. nullptr uses the global heap.
+        */
+        explicit JSonKeyPool(JSonMemoryResource* resource=nullptr);
+        ~JSonKeyPool();
+
+        /*! Returns a key referring to the pool's copy of the given characters, adding a copy should there be none. */
+        JSonKey intern(const StringView &key);
+
+        /*! Returns the number of distinct keys interned. */
+        size_type size() const;
+
+        /*! Releases every key interned. No key interned by the pool may be used afterwards. */
+        void clear();
+
+    private:
+        JSonKeyPool(const JSonKeyPool&);
+        JSonKeyPool& operator=(const JSonKeyPool&);
+
+        JSonMemoryResource* mResource;
+        std::vector<JSonKey::_Rep*> mSlots; // Open addressing, a power of two in size. nullptr for empty slots.
+        size_type mCount;
+
+        void _Grow();
+    };
+
+
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+    // CLASS: JSonException
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+
+    /*! OYAJSon's JSon exception class.
+
+        Can be thrown directly, or can be thrown by calling any one of the static methods for consistent error message formatting.
+
+        \code{.cpp}
+            // Example - Assuming jArr is of type JSonType_Array
+            try{
+                if (!jArr.is(JSonType_Object))
+                    throw JSonException::InvalidJSonType(JSonType_Object, jArr.type());
+            catch (const JSonException &e){
+                std::cout << e.what() << std::endl;
+                // Outputs "[1001] Operation expecting JSonValue type Object but JSonValue is of type Array."
             }
         \endcode
     */
     class JSonException : public std::runtime_error{
     public:
-        static const unsigned int ERR_PARSE_MALFORMED;              ///< Error code thrown by Parser when a Malformed error occurs
-        static const unsigned int ERR_PARSE_INVALIDJSONCONTAINER;   ///< Error code thrown by Parser when a Invalid JSon Container error occurs
-        static const unsigned int ERR_PARSE_UNCLOSEDSTURCTURE;      ///< Error code thrown by Parser when a Unclosed Structure error occurs
-        static const unsigned int ERR_PARSE_MISSINGSYMBOL;          ///< Error code thrown by Parser when a Missing Symbol error occurs
-        static const unsigned int ERR_PARSE_INVALIDSYMBOL;          ///< Error code thrown by Parser when a Invalid Symbol error occurs
-        static const unsigned int ERR_PARSE_UNKNOWNVALUETYPE;       ///< Error code thrown by Parser when a Unknown Value Type error occurs
-        static const unsigned int ERR_PARSE_MISSINGVALUE;           ///< Error code thrown by Parser when a Missing Value error occurs
+        static const unsigned int ERR_PARSE_MALFORMED;              ///< Error code thrown by Parser when a Malformed error occurs
+        static const unsigned int ERR_PARSE_INVALIDJSONCONTAINER;   ///< Error code thrown by Parser when a Invalid JSon Container error occurs
+        static const unsigned int ERR_PARSE_UNCLOSEDSTURCTURE;      ///< Error code thrown by Parser when a Unclosed Structure error occurs
+        static const unsigned int ERR_PARSE_MISSINGSYMBOL;          ///< Error code thrown by Parser when a Missing Symbol error occurs
+        static const unsigned int ERR_PARSE_INVALIDSYMBOL;          ///< Error code thrown by Parser when a Invalid Symbol error occurs
+        static const unsigned int ERR_PARSE_UNKNOWNVALUETYPE;       ///< Error code thrown by Parser when a Unknown Value Type error occurs
+        static const unsigned int ERR_PARSE_MISSINGVALUE;           ///< Error code thrown by Parser when a Missing Value error occurs
+        static const unsigned int ERR_PARSE_TOODEEP;                ///< Error code thrown by Parser when Arrays and Objects nest beyond JSonParseLimits::max_depth
+        static const unsigned int ERR_PARSE_TOOLARGE;               ///< Error code thrown by Parser when a JSon string is longer than JSonParseLimits::max_size
+        static const unsigned int ERR_PARSE_INVALIDENCODING;        ///< Error code thrown by Parser when a JSon string is not valid UTF-8
+        static const unsigned int ERR_PARSE_NUMBEROUTOFRANGE;       ///< Error code thrown by Parser when a number is beyond the range of a double
+
+        static const unsigned int ERR_FILE_UNREADABLE;              ///< Error code thrown when a file cannot be opened or mapped.
+        static const unsigned int ERR_WRITE_FAILED;                 ///< Error code thrown when a JSonSink fails to write.
+
+        static const unsigned int ERR_INVALIDJSONTYPE;              ///< Error code thrown when An unexpected JSonType is found.
+        static const unsigned int ERR_MISSINGKEY;                   ///< Error code thrown an expected key is not found in Object.
+        static const unsigned int ERR_INDEXOUTOFBOUNDS;             ///< Error code thrown a given index is beyond the bounds of the Array.
+
+        /*! Default JSonException constructor.
+            @param msg A const string_type& containing the message for this exception.
+            @param code An unsigned int code for this exception.
+        */
+        JSonException(const string_type &msg, unsigned int code);
+
+        virtual const char* what() const throw();
+
+        /*! Returns the error code given for this error.
+            @return unsigned int code given when exception generated.
+
+            Useful for quickly determining the severity of the exception (severity varies project to project)
+        */
+        unsigned int get_code() const;
+
+        /*! Generate a JSonException when given a JSonValue of the incorrect JSonType expected.
+            @param expected The JSonType expected by the operation.
+            @param given The JSonType give to the operation.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException InvalidJSonType(JSonType expected, JSonType given);
+
+        /*! Generate a JSonException when the JSonValue does not have the requested key.
+            @param key A coonst string_type& of the key requested.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException MissingKey(const string_type &key);
+
+        /*! Generate a JSonException when given index is out of bounds of the JSonValue Array.
+            @param index A size_type index value
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException IndexOutOfBounds(size_type index);
+
+        /*! Generate a JSonException when Parser encounters an unspecified malformed JSon string that cannot be parsed.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException ParseMalformed();
+
+        /*! Generate a JSonException when Parser given a JSon string that does not begin with a valid JSon container.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException ParseInvalidJsonContainer();
+
+        /*! Generate a JSonException when Parser encounters a structure ('[]', '{}', or '""') that is not closed.
+            @param type The type of structure missing a valid closure.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException ParseUnclosedStructure(JSonType type);
+
+        /*! Generate a JSonException when Parser is unable to find an expected symbol (usually ',' or ':')
+            @param symbol A char_type containing the expected, but missing, symbol.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException ParseMissingSymbol(char_type symbol);
+
+        /*! Generate a JSonException when Parser encounters an unexpected symbol.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException ParseInvalidSymbol();
+
+        /*! Generate a JSonException when Parser is unable to determine a values type.
+            @param value A const string_type& containing the value the Parser was attempting to identify.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException ParseUnknownValueType(const string_type &value);
+
+        /*! Generate a JSonException when Parser finds a number too large, in magnitude, for a double.
+            @param value A const string_type& containing the number.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException ParseNumberOutOfRange(const string_type &value);
+
+        /*! Generate a JSonException when Parser was expecting a value but did not find one.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException ParseMissingValue();
+
+        /*! Generate a JSonException when Parser finds Arrays and Objects nested deeper than it allows.
+            @param maxDepth The deepest nesting allowed.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException ParseTooDeep(size_type maxDepth);
+
+        /*! Generate a JSonException when Parser is given a JSon string longer than it allows.
+            @param maxSize The longest JSon string allowed, in bytes.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException ParseTooLarge(size_type maxSize);
+
+        /*! Generate a JSonException when Parser finds bytes that are not valid UTF-8.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException ParseInvalidEncoding();
+
+        /*! Generate a JSonException when a file cannot be opened or mapped.
+            @param path A const string_type& containing the path of the file.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException FileUnreadable(const string_type &path);
+
+        /*! Generate a JSonException when a JSonSink fails to write.
+            @param reason A const string_type& describing what failed.
+            @return A JSonException with a preformatted message and code for this error.
+        */
+        static JSonException WriteFailed(const string_type &reason);
+    private:
+        unsigned int m_code;
+    };
+
+
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+    // CLASS: JSonMappedFile
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+
+    /*! A read only, memory mapped, view of a file.
+
+        Allows files to be parsed in place, without first reading them into memory. Pages are loaded by the OS as the
+        parser reaches them, and are shared with the OS page cache, so even very large files parse without doubling the
+        memory they use.
+
+        \code{.cpp}
+            JSonMappedFile file("export.json");
+            JSonValue jval;
+            jval.parse(file.view());
+        \endcode
+
+        __WARNING:__ The mapping is released when the JSonMappedFile is closed or destroyed. Any StringView obtained from it
+        must not be used after that point.
+    */
+    class JSonMappedFile{
+    public:
+        /*! Creates a JSonMappedFile with no file mapped. */
+        JSonMappedFile();
+
+        /*! Maps the file at the given path.
+            @param path The path of the file to map.
+            @throw JSonException if the file cannot be opened or mapped.
+        */
+        explicit JSonMappedFile(const string_type &path);
+        ~JSonMappedFile();
+
+        /*! Maps the file at the given path, closing any file currently mapped.
+            @param path The path of the file to map.
+            @throw JSonException if the file cannot be opened or mapped.
+        */
+        void open(const string_type &path);
+
+        /*! Releases the mapping of the current file, if any. */
+        void close();
+
+        /*! Returns true if a file is currently mapped. */
+        bool is_open() const;
+
+        /*! Returns a pointer to the start of the mapped file. The contents are __not__ null terminated. */
+        const char_type* data() const;
+
+        /*! Returns the size of the mapped file. */
+        size_type size() const;
+
+        /*! Returns a StringView over the whole of the mapped file. */
+        StringView view() const;
+
+    private:
+        JSonMappedFile(const JSonMappedFile&);
+        JSonMappedFile& operator=(const JSonMappedFile&);
+
+        const char_type* mData;
+        size_type mSize;
+        bool mOpen;
+#ifdef _WIN32
+        void* mFileHandle;
+        void* mMapHandle;
+#endif
+    };
+
+
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+    // CLASS: JSonHandler
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+
+    /*! Receives the events generated while parsing a JSon string (SAX style).
+
+        Derive from JSonHandler and override the events of interest to inspect, extract, or forward JSon without building
+        a tree of JSonValues. Every event has a default implementation that does nothing and asks the parser to continue.
+
+        \code{.cpp}
+            // Example - Sums every number found in a JSon string without allocating.
+            class SumHandler : public JSonHandler{
+            public:
+                double sum = 0;
+                bool number_int(long long value){sum += value; return true;}
+                bool number_double(double value){sum += value; return true;}
+            };
+
+            SumHandler h;
+            JSonParser parser;
+            parser.parse(jsonstr, h);
+        \endcode
+
+        Each event returns true to continue parsing, or false to stop the parser immediately.
+
+        __NOTE:__ StringViews given to key() and string() are only valid for the duration of the call. Copy them if
+        they must be kept.
+    */
+    class JSonHandler{
+    public:
+        virtual ~JSonHandler(){}
+
+        /*! Called when the head of an Object ('{') is found. */
+        virtual bool start_object(){return true;}
+
+        /*! Called with each key of an Object. The key's value is given by the event that follows.
+            @param key The decoded key name.
+        */
+        virtual bool key(const StringView &key){return true;}
+
+        /*! Called when the tail of an Object ('}') is found. */
+        virtual bool end_object(){return true;}
+
+        /*! Called when the head of an Array ('[') is found. */
+        virtual bool start_array(){return true;}
+
+        /*! Called when the tail of an Array (']') is found. */
+        virtual bool end_array(){return true;}
+
+        /*! Called with each String value.
+            @param value The decoded string value.
+        */
+        virtual bool string(const StringView &value){return true;}
+
+        /*! Called with each Number value that has neither a fraction or an exponent, and fits within a long long.
+            @param value The number value.
+        */
+        virtual bool number_int(long long value){return true;}
+
+        /*! Called with every other Number value.
+            @param value The number value.
+        */
+        virtual bool number_double(double value){return true;}
+
+        /*! Called with each Bool value.
+            @param value The boolean value.
+        */
+        virtual bool boolean(bool value){return true;}
+
+        /*! Called with each null value. */
+        virtual bool null(){return true;}
+    };
+
+
+    /*! JSonHandler that builds a JSonValue tree from the events given to it.
+
+        This is the handler used by JSonValue::parse(). It's available for use with any other source of JSonHandler events.
+
+        \code{.cpp}
+            JSonValueBuilder builder;
+            JSonParser parser;
+            parser.parse(jsonstr, builder);
+
+            JSonValue jval = std::move(builder.value());
+        \endcode
+
+        The members of each Array and Object are gathered on an internal stack until it closes, so every Array is allocated
+        once, at its final size. The stack keeps its capacity, so a builder reused for many values soon stops allocating
+        anything but the values themselves. A key repeated within an Object keeps its first position and its last value.
+    */
+    class JSonValueBuilder : public JSonHandler{
+    public:
+        /*! Creates a builder allocating the values it builds from the global heap. */
+        JSonValueBuilder();
+
+        /*! Creates a builder allocating the Arrays, Objects and Strings it builds from the given JSonMemoryResource.
+            @param resource The resource to allocate from. nullptr uses the global heap. The resource must outlive the values built.
+            @param keys The pool Object keys are interned in. nullptr [default] gives every Object member a key of its own.
+                   The pool must outlive the values built.
+        */
+        explicit JSonValueBuilder(JSonMemoryResource* resource, JSonKeyPool* keys=nullptr);
+
+        /*! Returns the JSonValue built so far.
+            @return A reference to the root JSonValue.
+        */
+        JSonValue& value();
+
+        /*! Discards the JSonValue built so far, readying the builder for a new set of events. */
+        void reset();
+
+        bool start_object();
+        bool key(const StringView &key);
+        bool end_object();
+        bool start_array();
+        bool end_array();
+        bool string(const StringView &value);
+        bool number_int(long long value);
+        bool number_double(double value);
+        bool boolean(bool value);
+        bool null();
+
+    private:
+        // An Array or Object still open. Its members are those on the stacks past the given positions.
+        struct _Frame{
+            size_type values;
+            size_type keys;
+        };
+
+        JSonMemoryResource* mResource;
+        JSonKeyPool* mKeyPool;
+        JSonValue mRoot;
+        std::vector<JSonValue> mValues;
+        std::vector<JSonKey> mKeys;
+        std::vector<_Frame> mFrames;
+
+        JSonValue& _NextValue();
+    };
+
+
+
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+    // CLASS: JSonStructuralIndex
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+
+    /*! Locates the tokens of a JSon string ahead of the parser.
+
+        The source is classified 64 bytes at a time with SIMD instructions (AVX2 or SSE2 where the CPU supports them, or
+        a portable fallback chosen at runtime otherwise), finding every quote, backslash, and structural character in one
+        go. Quotes escaped by a backslash, and everything between a pair of quotes, are masked out, leaving the position of
+        every structural character ( { } [ ] , : ), every unescaped quote, and the first character of every number or
+        literal. Whitespace never appears in the index, so a parser can hop straight from token to token.
+
+        The source is indexed lazily, a window at a time, as tokens are asked for. This keeps the index small and in cache
+        no matter how large the JSon string is.
+
+        \code{.cpp}
+            JSonStructuralIndex index;
+            index.reset(jsonstr.data(), jsonstr.size());
+            for (const char_type* tok = index.next(); tok != nullptr; tok = index.next())
+                std::cout << *tok;
+        \endcode
+
+        The index does no validation itself. Every non-whitespace character outside of a string is either a token or part
+        of a number or literal that starts at a token, so a parser consuming the index still sees every character it needs
+        to reject malformed JSon.
+    */
+    class JSonStructuralIndex{
+    public:
+        JSonStructuralIndex();
+
+        /*! Starts indexing the given buffer, discarding anything left from the previous buffer.
+            @param data Pointer to the start of the JSon string. The buffer does not need to be null terminated.
+            @param size The number of characters in the buffer.
+        */
+        void reset(const char_type* data, size_type size);
+
+        /*! Returns a pointer to the next token in the buffer, or nullptr once all tokens have been returned.
+
+            Within a string, the opening quote is always followed by the closing quote. Should the buffer end inside of a
+            string, the opening quote is the last token returned.
+        */
+        const char_type* next(){
+            if (mRead == mCount && !_Refill())
+                return nullptr;
+            return mWindow + mPositions[mRead++];
+        }
+
+        /*! Returns the name of the instruction set used to index, one of "avx2", "sse2", or "scalar". */
+        static const char* implementation();
+
+    private:
+        const char_type* mData;
+        size_type mSize;
+        size_type mIndexed;
+        const char_type* mWindow;
+        std::vector<std::uint32_t> mPositions;
+        size_type mCount;
+        size_type mRead;
+
+        // Carried from one 64 byte block to the next.
+        std::uint64_t mPrevInString;
+        std::uint64_t mPrevEscaped;
+        std::uint64_t mPrevScalar;
+
+        bool _Refill();
+    };
+
+
+    /*! Finds the first byte of a buffer that isn't part of valid UTF-8.
+        @param data Pointer to the start of the buffer.
+        @param size The number of bytes in the buffer.
+        @return A pointer to the start of the first invalid (or cut short) sequence, or data + size if the buffer is valid.
+
+        Overlong encodings, surrogates, and code points past U+10FFFF are all invalid. As with JSonStructuralIndex, the
+        buffer is checked with SIMD instructions: 32 bytes at a time with AVX2, while SSE2 and the portable fallback skip
+        through ASCII quickly and check the rest a sequence at a time.
+    */
+    const char_type* JSonFindInvalidUtf8(const char_type* data, size_type size);
+
+
+
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+    // CLASS: JSonParseResult
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+
+    /*! The outcome of a try_parse()... either success, or the error that would otherwise have been thrown along with
+        where in the JSon string it was found.
+
+        \code{.cpp}
+            JSonParseResult result = jval.try_parse(line);
+            if (!result)
+                std::cerr << "Line " << result.line << ", column " << result.column << ": " << result.message << std::endl;
+        \endcode
+    */
+    struct JSonParseResult{
+        unsigned int code;      ///< 0 on success, otherwise the JSonException::ERR_PARSE_* code of the error.
+        size_type offset;       ///< The byte offset, from the start of the JSon string, at which the error was found.
+        size_type line;         ///< The line (from 1) holding offset. Lines are ended by '\n'.
+        size_type column;       ///< The byte (from 1) within that line at offset.
+        string_type message;    ///< The message the JSonException for the error would have carried.
+
+        JSonParseResult();
+
+        /*! Returns true if the JSon string was parsed without error. */
+        bool ok() const;
+
+        /*! Returns true if the JSon string was parsed without error. */
+        explicit operator bool() const;
+    };
+
+
+    /*! The bounds a JSonParser, JSonPushParser or JSonTape holds a JSon string to, so untrusted input can be rejected in
+        linear time and bounded memory.
+
+        \code{.cpp}
+            JSonParser parser(JSonParseLimits(64, 1 << 20)); // At most 64 levels deep, and 1 MiB long.
+        \endcode
+    */
+    struct JSonParseLimits{
+        static const size_type DEFAULT_MAX_DEPTH;   ///< The default max_depth, 1024.
+        static const size_type NO_LIMIT;            ///< A max_depth or max_size that allows anything.
+
+        size_type max_depth;    ///< The deepest Arrays and Objects may nest. The root is at depth 1.
+        size_type max_size;     ///< The longest JSon string accepted, in bytes.
+
+        /*! Constructor
+            @param maxDepth The deepest Arrays and Objects may nest.
+            @param maxSize The longest JSon string accepted, in bytes.
+        */
+        JSonParseLimits(size_type maxDepth = DEFAULT_MAX_DEPTH, size_type maxSize = NO_LIMIT);
+    };
+
+
+
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+    // CLASS: JSonSelector
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+
+    /*! A set of JSON Pointers (RFC 6901) picking the values of a JSon string that a JSonParser should parse.
+
+        Each pointer is a path of keys and Array indexes from the root, every one of them preceded by a '/'. Within a key
+        "~1" stands for '/' and "~0" for '~'. The empty pointer "" selects the whole JSon string.
+
+        As an extension, a segment of just "*" matches every member of an Object and every element of an Array. The pointer
+        made of the segments "items", "*" and "price" picks the price of every item.
+
+        \code{.cpp}
+            JSonSelector selector({"/meta/id", "/payload/items"});
+            selector.add("/payload/totals/0/amount");
+        \endcode
+
+        Selecting a value selects everything within it.
+    */
+    class JSonSelector{
+    public:
+        /*! Creates a selector selecting nothing. */
+        JSonSelector();
+
+        /*! Creates a selector selecting the given pointers.
+            @throw std::invalid_argument if any of them isn't a valid JSON Pointer.
+        */
+        explicit JSonSelector(const std::vector<string_type> &pointers);
+
+        /*! Selects the value at the given pointer, as well.
+            @param pointer A JSON Pointer.
+            @return A reference to this JSonSelector.
+            @throw std::invalid_argument if the pointer isn't a valid JSON Pointer.
+        */
+        JSonSelector& add(const StringView &pointer);
+
+        /*! Returns the number of pointers added. */
+        size_type size() const;
+
+        /*! Returns true if no pointers have been added. */
+        bool empty() const;
+
+        /*! Removes every pointer. */
+        void clear();
+
+    private:
+        // The pointers form a tree of segments, rooted at node 0.
+        struct _Step{
+            string_type key;
+            size_type index;            // The Array index the key spells, or npos if none.
+            std::uint32_t node;
+        };
+        struct _Node{
+            std::vector<_Step> steps;
+            std::uint32_t wildcard;     // The node "*" leads to, or 0 if none.
+            bool selected;              // A pointer ends here.
+        };
+
+        std::vector<_Node> mNodes;
+        size_type mPointers;
+
+        std::uint32_t _Child(std::uint32_t node, const string_type &key);
+
+        friend class JSonParser;
+    };
+
+
+
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+    // CLASS: JSonParser
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+
+    /*! Parses JSon strings, passing the values found to a JSonHandler as they're encountered.
+
+        The parser hops from token to token using a JSonStructuralIndex, so whitespace and the contents of strings are
+        only looked at by the (SIMD) indexer. Nothing is copied out of the source except for strings containing escape
+        sequences, which are decoded into a buffer owned (and reused) by the JSonParser.
+
+        As with JSonValue::parse(), the JSon string must have a single root value which is either an Object or an Array.
+
+        The JSon string must be UTF-8, which is checked before parsing starts (see JSonFindInvalidUtf8), failing with
+        JSonException::ERR_PARSE_INVALIDENCODING. Escape sequences, \uXXXX and surrogate pairs included, are decoded to UTF-8.
+
+        Nesting never recurses: the Arrays and Objects open are tracked on a stack owned (and reused) by the JSonParser,
+        and are bounded by JSonParseLimits::max_depth. Strings nesting deeper than that fail with
+        JSonException::ERR_PARSE_TOODEEP, and strings longer than JSonParseLimits::max_size fail with
+        JSonException::ERR_PARSE_TOOLARGE before any of them is looked at.
+    */
+    class JSonParser{
+    public:
+        /*! Constructor. The parser is given the default JSonParseLimits. */
+        JSonParser();
+
+        /*! Constructor
+            @param limits The bounds to hold every JSon string parsed to.
+        */
+        explicit JSonParser(const JSonParseLimits &limits);
+
+        /*! Returns the bounds JSon strings are held to. */
+        const JSonParseLimits& limits() const;
+
+        /*! Sets the bounds to hold the JSon strings parsed from now on to.
+            @param limits The new bounds.
+        */
+        void set_limits(const JSonParseLimits &limits);
+
+        /*! Parses the given buffer, passing all values found to the given handler.
+            @param data Pointer to the start of the JSon string. The buffer does not need to be null terminated.
+            @param size The number of characters in the buffer.
+            @param handler The JSonHandler to receive the parse events.
+            @return true if the whole string was parsed, or false if the handler asked the parser to stop.
+            @throw JSonException if the given buffer is not a valid JSon string.
+        */
+        bool parse(const char_type* data, size_type size, JSonHandler &handler);
+
+        /*! Parses the given JSon string, passing all values found to the given handler.
+            @param jsonstr A StringView of the JSon string.
+            @param handler The JSonHandler to receive the parse events.
+            @return true if the whole string was parsed, or false if the handler asked the parser to stop.
+            @throw JSonException if the given string is not a valid JSon string.
+        */
+        bool parse(const StringView &jsonstr, JSonHandler &handler);
+
+        /*! Parses the given buffer, passing only the values picked by the selector to the given handler.
+            @param data Pointer to the start of the JSon string. The buffer does not need to be null terminated.
+            @param size The number of characters in the buffer.
+            @param handler The JSonHandler to receive the parse events.
+            @param selector The JSON Pointers of the values wanted.
+            @return true if the whole string was parsed, or false if the handler asked the parser to stop.
+            @throw JSonException if the given buffer is not a valid JSon string.
+
+            The handler is given each selected value, along with the start and end, and the key, of every Array and Object
+            on the way to it. Values no pointer can reach are skipped by matching brackets over the structural index: they
+            are never decoded, and are only checked for balanced brackets and closed strings.
+        */
+        bool parse(const char_type* data, size_type size, JSonHandler &handler, const JSonSelector &selector);
+
+        /*! Parses the given JSon string, passing only the values picked by the selector to the given handler.
+            @param jsonstr A StringView of the JSon string.
+            @param handler The JSonHandler to receive the parse events.
+            @param selector The JSON Pointers of the values wanted.
+            @return true if the whole string was parsed, or false if the handler asked the parser to stop.
+            @throw JSonException if the given string is not a valid JSon string.
+        */
+        bool parse(const StringView &jsonstr, JSonHandler &handler, const JSonSelector &selector);
+
+        /*! Parses the given buffer as parse() does, but reports an invalid JSon string in the returned JSonParseResult
+            rather than throwing.
+            @param data Pointer to the start of the JSon string. The buffer does not need to be null terminated.
+            @param size The number of characters in the buffer.
+            @param handler The JSonHandler to receive the parse events.
+            @return A JSonParseResult holding the error found, if any. A handler asking to stop is not an error.
+
+            Errors are passed back up through the parser as return values, so a malformed string costs no more to parse
+            than a valid one. Exceptions thrown by the handler itself still propagate.
+        */
+        JSonParseResult try_parse(const char_type* data, size_type size, JSonHandler &handler);
+
+        /*! Parses the given JSon string as parse() does, but reports an invalid JSon string in the returned
+            JSonParseResult rather than throwing.
+            @param jsonstr A StringView of the JSon string.
+            @param handler The JSonHandler to receive the parse events.
+            @return A JSonParseResult holding the error found, if any. A handler asking to stop is not an error.
+        */
+        JSonParseResult try_parse(const StringView &jsonstr, JSonHandler &handler);
+
+        /*! Parses the given buffer as the selector taking parse() does, but reports an invalid JSon string in the returned
+            JSonParseResult rather than throwing.
+            @param data Pointer to the start of the JSon string. The buffer does not need to be null terminated.
+            @param size The number of characters in the buffer.
+            @param handler The JSonHandler to receive the parse events.
+            @param selector The JSON Pointers of the values wanted.
+            @return A JSonParseResult holding the error found, if any. A handler asking to stop is not an error.
+        */
+        JSonParseResult try_parse(const char_type* data, size_type size, JSonHandler &handler, const JSonSelector &selector);
+
+        /*! Parses the given JSon string as the selector taking parse() does, but reports an invalid JSon string in the
+            returned JSonParseResult rather than throwing.
+            @param jsonstr A StringView of the JSon string.
+            @param handler The JSonHandler to receive the parse events.
+            @param selector The JSON Pointers of the values wanted.
+            @return A JSonParseResult holding the error found, if any. A handler asking to stop is not an error.
+        */
+        JSonParseResult try_parse(const StringView &jsonstr, JSonHandler &handler, const JSonSelector &selector);
+
+    private:
+        const char_type* mBegin;
+        const char_type* mCur;
+        const char_type* mEnd;
+        JSonHandler* mHandler;
+        string_type mScratch;
+        JSonStructuralIndex mIndex;
+        JSonParseLimits mLimits;
+        std::vector<char_type> mStack; // The heads (OBJECT_SYM_HEAD or ARRAY_SYM_HEAD) of the Arrays and Objects open.
+
+        // The JSonSelector nodes the values being parsed may still match, a run for each Array and Object open.
+        const JSonSelector* mSelector;
+        std::vector<std::uint32_t> mActive;
+
+        // The error the last _Parse() stopped at, and where, should mFailed be set.
+        JSonException mError;
+        const char_type* mErrorAt;
+        bool mFailed;
+
+        bool _Parse(const char_type* data, size_type size);
+        bool _Completed(bool completed);
+        bool _Fail(const JSonException &error, const char_type* at);
+        JSonParseResult _Result() const;
+        void _Advance();
+        bool _ParseValue();
+        bool _Open(char_type head);
+        bool _Close();
+        bool _ParseKey(StringView &key);
+        bool _ParsePairSeparator();
+        bool _ParseString(StringView &str);
+        bool _ParseScalar();
+
+        bool _SelectObject(size_type active, size_type count);
+        bool _SelectArray(size_type active, size_type count);
+        bool _SelectMember(size_type active, size_type count, const StringView &key, size_type index, bool isKey);
+        bool _SkipValue();
+    };
+
+
+    /*! Parses a JSon string handed to it in pieces, passing the values found to a JSonHandler as they're encountered.
+
+        Intended for JSon arriving over sockets, pipes, or any other source that produces it a chunk at a time. Chunks can
+        be split anywhere... including in the middle of strings, escape sequences, numbers, and literals. Only the parts of
+        a string or number that straddle a chunk boundary are buffered by the parser; nothing else is kept between calls.
+
+        \code{.cpp}
+            JSonValueBuilder builder;
+            JSonPushParser parser(builder);
+
+            char buffer[4096];
+            ssize_t len;
+            while ((len = read(fd, buffer, sizeof(buffer))) > 0)
+                parser.feed(buffer, len);
+            parser.finish();
+
+            JSonValue jval = builder.value();
+        \endcode
+
+        As with JSonValue::parse(), the JSon string must have a single root value which is either an Object or an Array.
+        Errors are thrown from feed() as soon as they are found, and from finish() should the JSon string be incomplete.
+        Like JSonParser, the parser holds its input to a JSonParseLimits: feed() throws once the chunks nest too deep, or
+        add up to more than max_size.
+    */
+    class JSonPushParser{
+    public:
+        /*! Creates a JSonPushParser passing events to the given handler.
+            @param handler The JSonHandler to receive the parse events. Must outlive the JSonPushParser.
+        */
+        explicit JSonPushParser(JSonHandler &handler);
+
+        /*! Creates a JSonPushParser passing events to the given handler.
+            @param handler The JSonHandler to receive the parse events. Must outlive the JSonPushParser.
+            @param limits The bounds to hold every JSon string parsed to. max_size applies to all the chunks fed together.
+        */
+        JSonPushParser(JSonHandler &handler, const JSonParseLimits &limits);
+
+        /*! Returns the bounds JSon strings are held to. */
+        const JSonParseLimits& limits() const;
+
+        /*! Sets the bounds to hold JSon strings to, from the next chunk fed.
+            @param limits The new bounds.
+        */
+        void set_limits(const JSonParseLimits &limits);
+
+        /*! Parses the next chunk of the JSon string.
+            @param data Pointer to the start of the chunk. The chunk does not need to be null terminated.
+            @param size The number of characters in the chunk.
+            @return false if the handler has asked the parser to stop, true otherwise.
+            @throw JSonException if the JSon string is found to be invalid.
+        */
+        bool feed(const char_type* data, size_type size);
+
+        /*! Parses the next chunk of the JSon string.
+            @param chunk A StringView of the chunk.
+            @return false if the handler has asked the parser to stop, true otherwise.
+            @throw JSonException if the JSon string is found to be invalid.
+        */
+        bool feed(const StringView &chunk);
+
+        /*! Tells the parser there are no more chunks to come.
+            @return false if the handler has asked the parser to stop, true otherwise.
+            @throw JSonException if the JSon string given was incomplete.
+        */
+        bool finish();
+
+        /*! Readies the parser for a new JSon string. Buffers are kept for reuse. */
+        void reset();
+
+    private:
+        enum _State{
+            _State_Root,            // Waiting for the root Object or Array.
+            _State_ObjectFirst,     // Just after an Object head. Waiting for a key or the Object tail.
+            _State_ObjectKey,       // Just after a value separator within an Object. Waiting for a key.
+            _State_PairSeparator,   // Just after a key. Waiting for the pair separator.
+            _State_ObjectValue,     // Just after a pair separator. Waiting for a value.
+            _State_ArrayFirst,      // Just after an Array head. Waiting for a value or the Array tail.
+            _State_ArrayValue,      // Just after a value separator within an Array. Waiting for a value.
+            _State_AfterValue,      // Just after a value. Waiting for a value separator or the container tail.
+            _State_String,          // Within a string.
+            _State_StringEscape,    // Within a string, just after an escape character.
+            _State_Scalar,          // Within a number or literal.
+            _State_Done,            // The root container has been closed. Only white space may follow.
+            _State_Stopped          // The handler asked for parsing to stop.
+        };
+
+        JSonHandler* mHandler;
+        JSonParseLimits mLimits;
+        _State mState;
+        size_type mFed; // Characters fed since the last reset(), held to mLimits.max_size.
+        std::vector<char_type> mStack; // Open containers, by head symbol.
+        string_type mToken;
+        string_type mEscape; // An escape sequence cut short by the end of a chunk.
+        string_type mUtf8;   // A UTF-8 sequence cut short by the end of a chunk, yet to be validated.
+        string_type mScratch;
+        bool mTokenIsKey;
+        bool mTokenBuffered;
+
+        void _CheckUtf8(const char_type* data, size_type size);
+        bool _StartValue(const char_type* &cur, const char_type* end, char_type c);
+        bool _ScanString(const char_type* &cur, const char_type* end);
+        bool _EmitString(const StringView &s);
+        bool _ScanScalar(const char_type* &cur, const char_type* end);
+        bool _CloseContainer(char_type tail);
+    };
+
+
+
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+    // CLASS: JSonTape
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+
+    class JSonCursor;
+
+    /*! A flat record of where every value of a JSon string is, decoding nothing until it's asked for.
+
+        Parsing a JSonTape makes one pass over the structural index, recording each value's position in the source (and
+        for Arrays and Objects, where they end) in a single contiguous array. No JSonValues are built and no strings or
+        numbers are decoded; JSonCursors read them straight from the source when they're accessed. For reading a handful of
+        values out of a large JSon string, this is far less work than building the whole tree.
+
+        \code{.cpp}
+            JSonTape tape;
+            tape.parse(body); // The body must outlive the tape's use.
+            JSonCursor request = tape.root();
+            StringView user = request["user"]["id"].get<StringView>();
+            for (JSonCursor::iterator i = request["items"].begin(); i != request["items"].end(); i++)
+                total += (*i)["price"].get<double>();
+        \endcode
+
+        The structure of the JSon string is checked by parse(), which throws the same JSonExceptions as JSonParser, holding
+        it to the same JSonParseLimits. Numbers and escape sequences are only checked when read: a malformed one throws
+        from JSonCursor::get().
+
+        The source is never copied, so it must stay unchanged for as long as the tape and its cursors are in use. A tape
+        keeps its capacity, so one reused for many JSon strings soon stops allocating. Strings holding escape sequences are
+        decoded into the tape the first time they're read. A JSonTape, with its cursors, may only be used by one thread at
+        a time.
+    */
+    class JSonTape{
+    public:
+        /*! Constructor. The tape is given the default JSonParseLimits. */
+        JSonTape();
+
+        /*! Constructor
+            @param limits The bounds to hold every JSon string parsed to.
+        */
+        explicit JSonTape(const JSonParseLimits &limits);
+
+        /*! Returns the bounds JSon strings are held to. */
+        const JSonParseLimits& limits() const;
+
+        /*! Sets the bounds to hold the JSon strings parsed from now on to.
+            @param limits The new bounds.
+        */
+        void set_limits(const JSonParseLimits &limits);
+
+        /*! Records the values in the given buffer, replacing those of the previous JSon string.
+            @param data Pointer to the start of the JSon string. The buffer does not need to be null terminated.
+            @param size The number of characters in the buffer. At most 4GB.
+            @return A reference to this JSonTape.
+            @throw JSonException if the given buffer is not a valid JSon string.
+            @throw std::length_error if the buffer is larger than 4GB.
+        */
+        JSonTape& parse(const char_type* data, size_type size);
+
+        /*! Records the values in the given JSon string, replacing those of the previous JSon string.
+            @param jsonstr A StringView of the JSon string.
+            @return A reference to this JSonTape.
+            @throw JSonException if the given string is not a valid JSon string.
+        */
+        JSonTape& parse(const StringView &jsonstr);
+
+        /*! Returns a cursor at the root Object or Array. A JSonType_Null if nothing has been parsed. */
+        JSonCursor root() const;
+
+        /*! Returns the number of entries on the tape: one for every value and every key. */
+        size_type size() const;
+
+    private:
+        JSonTape(const JSonTape&);
+        JSonTape& operator=(const JSonTape&);
+
+        // A value or key. Arrays and Objects are followed by their members' entries, an Object's as key, value pairs.
+        struct _Entry{
+            std::uint32_t offset;   // Where it starts: the head symbol, the opening quote, or the first character.
+            std::uint32_t size;     // Arrays and Objects: the number of members. Strings: the characters between the quotes.
+                                    // Numbers: their characters. Bools: 1 for true.
+            std::uint32_t end;      // Arrays and Objects: the entry past their last member.
+            std::uint32_t type;
+        };
+
+        enum _State{
+            _State_ObjectFirst,     // Just after an Object head. Waiting for a key or the Object tail.
+            _State_ObjectKey,       // Just after a value separator within an Object. Waiting for a key.
+            _State_PairSeparator,   // Just after a key. Waiting for the pair separator.
+            _State_ObjectValue,     // Just after a pair separator. Waiting for a value.
+            _State_ArrayFirst,      // Just after an Array head. Waiting for a value or the Array tail.
+            _State_ArrayValue,      // Just after a value separator within an Array. Waiting for a value.
+            _State_AfterValue       // Just after a value. Waiting for a value separator or the container tail.
+        };
+
+        const char_type* mData;
+        const char_type* mEnd;
+        JSonParseLimits mLimits;
+        std::vector<_Entry> mEntries;
+        std::vector<std::uint32_t> mStack;  // Open containers, by entry.
+        JSonStructuralIndex mIndex;
+        mutable std::unordered_map<std::uint32_t, string_type> mDecoded; // Strings read through a copy, by entry.
+
+        _State _AddValue(const char_type* tok);
+        void _AddString(const char_type* tok);
+        std::uint32_t _Skip(std::uint32_t entry) const{
+            return (mEntries[entry].type == JSonType_Object || mEntries[entry].type == JSonType_Array) ? mEntries[entry].end : entry + 1;
+        }
+        StringView _String(std::uint32_t entry, bool terminated) const;
+
+        friend class JSonCursor;
+    };
+
+
+    /*! A read-only view of a value recorded on a JSonTape, decoding it only when asked.
+
+        Mirrors the const half of JSonValue: at(), operator[], has_key(), get<T>() and size() behave the same, throwing the
+        same JSonExceptions, and begin()/end() iterate over an Array's elements or an Object's members in order.
+
+        An Object repeating a key is the one place the two differ. Lookups and to_value() follow JSonValue::parse(), giving
+        the key's last value. size() and begin()/end(), though, count and visit the members as written, repeats included,
+        where JSonValue keeps only one member per key.
+
+        A JSonCursor is a pointer and an index, cheap to copy and pass by value. It's valid until its JSonTape parses
+        another JSon string. Looking a member up by index walks the members before it; by key, all of an Object's members.
+    */
+    class JSonCursor{
+    public:
+        /*! Iterates over the elements of an Array or the members of an Object, in order. */
+        class iterator{
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef JSonCursor value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const JSonCursor* pointer;
+            typedef JSonCursor reference;
+
+            /*! Returns the element, or member value. */
+            JSonCursor operator*() const;
+
+            /*! Returns the member's key. Only for Objects. */
+            StringView key() const;
+
+            iterator& operator++();
+            iterator operator++(int);
+            bool operator==(const iterator &rhs) const{return mEntry == rhs.mEntry;}
+            bool operator!=(const iterator &rhs) const{return mEntry != rhs.mEntry;}
+
+        private:
+            const JSonTape* mTape;
+            std::uint32_t mEntry;   // The key entry for Objects, the element entry for Arrays.
+            bool mObject;
+
+            iterator(const JSonTape* tape, std::uint32_t entry, bool object) : mTape(tape), mEntry(entry), mObject(object){}
+            friend class JSonCursor;
+        };
+
+        /*! Creates a cursor at a JSonType_Null belonging to no tape. */
+        JSonCursor();
+
+        /*! Returns true if the value is of the given JSonType. */
+        bool is(JSonType t) const;
+
+        /*! Returns the JSonType of the value. */
+        JSonType type() const;
+
+        /*! Returns the number of members of an Object, elements of an Array or characters of a String. Numbers and Bools
+            return 1, Nulls 0. An Object's members are counted as written, so a repeated key is counted each time.
+        */
+        size_type size() const;
+
+        /*! Decodes and returns the value as the given type. Supports the same types as JSonValue::get().
+            @throw JSonException::ERR_INVALIDJSONTYPE if the value isn't of a matching type.
+            @throw JSonException if the number, or a string's escape sequence, is malformed.
+
+            StringView and `const char_type*` results point into the source, or into the tape for strings that had to be
+            decoded, and are valid until the tape parses another JSon string.
+        */
+        template <typename T> T get() const;
+
+        /*! Returns the member of an Object with the given key.
+            @throw JSonException::ERR_INVALIDJSONTYPE if the value isn't an Object.
+            @throw JSonException::ERR_MISSINGKEY if the Object has no member with the key.
+        */
+        JSonCursor at(const StringView &key) const;
+
+        /*! Returns the element of an Array at the given index.
+            @throw JSonException::ERR_INVALIDJSONTYPE if the value isn't an Array.
+            @throw JSonException::ERR_INDEXOUTOFBOUNDS if the index is beyond the end of the Array.
+        */
+        JSonCursor at(size_type index) const;
+
+        /*! Same as at(key). Missing keys are never inserted. */
+        JSonCursor operator[](const StringView &key) const{return at(key);}
+
+        /*! Same as at(index). */
+        JSonCursor operator[](size_type index) const{return at(index);}
+
+        /*! Returns true if the value is an Object with a member with the given key. */
+        bool has_key(const StringView &key) const;
+
+        /*! Returns an iterator to the first element of an Array or member of an Object.
+            @throw JSonException::ERR_INVALIDJSONTYPE if the value is neither.
+        */
+        iterator begin() const;
+
+        /*! Returns an iterator past the last element of an Array or member of an Object.
+            @throw JSonException::ERR_INVALIDJSONTYPE if the value is neither.
+        */
+        iterator end() const;
+
+        /*! Decodes the value, and everything within it, into a JSonValue. */
+        JSonValue to_value() const;
+
+        /*! Returns the value as a JSon string, in the same format as JSonValue::to_str(). */
+        string_type to_str() const;
+
+    private:
+        const JSonTape* mTape;
+        std::uint32_t mEntry;
+
+        JSonCursor(const JSonTape* tape, std::uint32_t entry) : mTape(tape), mEntry(entry){}
+        void _Expect(JSonType t) const;
+        std::uint32_t _Find(const StringView &key) const;
+        bool _Number(long long &i, double &d) const;
+        template <typename T> T _NumberAs() const;
+
+        friend class JSonTape;
+    };
+
+
+
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+    // CLASS: JSonSink
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+
+    /*! The destination of a JSonWriter.
+
+        A JSonWriter buffers its own output, so a sink is handed large chunks and needs no buffering of its own. Derive from
+        JSonSink to send JSon anywhere the provided sinks don't reach.
+    */
+    class JSonSink{
+    public:
+        virtual ~JSonSink(){}
 
-        static const unsigned int ERR_INVALIDJSONTYPE;              ///< Error code thrown when An unexpected JSonType is found.
-        static const unsigned int ERR_MISSINGKEY;                   ///< Error code thrown an expected key is not found in Object.
-        static const unsigned int ERR_INDEXOUTOFBOUNDS;             ///< Error code thrown a given index is beyond the bounds of the Array.
+        /*! Writes size characters from data.
+            @throw JSonException if the characters could not be written.
+        */
+        virtual void write(const char_type* data, size_type size) = 0;
 
-        /*! Default JSonException constructor.
-            @param msg A const string_type& containing the message for this exception.
-            @param code An unsigned int code for this exception.
+        /*! Pushes anything held by the sink on to its final destination. */
+        virtual void flush(){}
+    };
+
+    /*! A JSonSink appending to a caller owned string_type, which grows as needed. */
+    class JSonStringSink : public JSonSink{
+    public:
+        /*! @param target The string to append to. Must outlive the JSonStringSink. */
+        explicit JSonStringSink(string_type &target);
+        void write(const char_type* data, size_type size);
+
+    private:
+        string_type* mTarget;
+    };
+
+    /*! A JSonSink writing to a std::ostream. */
+    class JSonStreamSink : public JSonSink{
+    public:
+        /*! @param stream The stream to write to. Must outlive the JSonStreamSink. */
+        explicit JSonStreamSink(std::ostream &stream);
+        void write(const char_type* data, size_type size);
+        void flush();
+
+    private:
+        std::ostream* mStream;
+    };
+
+    /*! A JSonSink writing to a file descriptor, such as an open file, pipe, or socket.
+
+        The descriptor is not closed by the JSonFdSink.
+    */
+    class JSonFdSink : public JSonSink{
+    public:
+        /*! @param fd The file descriptor to write to. */
+        explicit JSonFdSink(int fd);
+        void write(const char_type* data, size_type size);
+
+    private:
+        int mFd;
+    };
+
+
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+    // CLASS: JSonWriter
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+
+    /*! Writes JSon straight into a JSonSink, in a single pass, without building any intermediate strings.
+
+        Output is gathered into a fixed size buffer which is handed to the sink whenever it fills, so writing even a very
+        large JSonValue needs no more memory than that buffer. The output is the same as that of JSonValue::serialize(),
+        compact or indented.
+
+        \code{.cpp}
+            std::ofstream file("dump.json");
+            JSonStreamSink sink(file);
+            JSonWriter writer(sink, "  ");
+            writer.write(jval);
+            writer.flush();
+        \endcode
+
+        JSonWriter is also a JSonHandler, so values can be written as a series of events instead of (or as well as) from a
+        JSonValue. Handing it to a JSonParser re-formats a JSon string without ever building a JSonValue.
+
+        \code{.cpp}
+            JSonStringSink sink(pretty);
+            JSonWriter writer(sink, "\t");
+            JSonParser().parse(compact, writer);
+            writer.flush();
+        \endcode
+
+        __NOTE:__ Output still in the buffer only reaches the sink when flush() is called (or the JSonWriter is destroyed).
+    */
+    class JSonWriter : public JSonHandler{
+    public:
+        /*! Creates a JSonWriter.
+            @param sink The JSonSink to write to. Must outlive the JSonWriter.
+            @param indentStr The string used to indent values for "pretty printing". Pass "" [default] for compact output.
+            @param depth An optional depth [default: 0] at which to start indenting, as with JSonValue::serialize().
         */
-        JSonException(const string_type &msg, unsigned int code);
+        explicit JSonWriter(JSonSink &sink, const string_type &indentStr = "", size_type depth = 0);
 
-        virtual const char* what() const throw();
+        /*! Flushes any buffered output to the sink. Errors from the sink are ignored here; call flush() to see them. */
+        ~JSonWriter();
 
-        /*! Returns the error code given for this error.
-            @return unsigned int code given when exception generated.
+        /*! Writes the given value, and everything within it.
+            @param value The JSonValue to write.
+            @return A reference to this JSonWriter.
+            @throw JSonException if the sink fails to write.
+        */
+        JSonWriter& write(const JSonValue &value);
 
-            Useful for quickly determining the severity of the exception (severity varies project to project)
+        /*! Hands all buffered output to the sink, and flushes the sink.
+            @throw JSonException if the sink fails to write.
         */
-        unsigned int get_code() const;
+        void flush();
 
-        /*! Generate a JSonException when given a JSonValue of the incorrect JSonType expected.
-            @param expected The JSonType expected by the operation.
-            @param given The JSonType give to the operation.
-            @return A JSonException with a preformatted message and code for this error.
+        bool start_object();
+        bool key(const StringView &key);
+        bool end_object();
+        bool start_array();
+        bool end_array();
+        bool string(const StringView &value);
+        bool number_int(long long value);
+        bool number_double(double value);
+        bool boolean(bool value);
+        bool null();
+
+    private:
+        JSonWriter(const JSonWriter&);
+        JSonWriter& operator=(const JSonWriter&);
+
+        JSonSink* mSink;
+        string_type mIndent;
+        size_type mDepth;
+        std::vector<char_type> mBuffer;
+        size_type mUsed;
+        // One entry per open container; true until the first value in that container is written.
+        std::vector<bool> mFirst;
+        bool mAfterKey;
+
+        void _Put(const char_type* data, size_type size);
+        void _Put(char_type c);
+        void _PutString(const StringView &s);
+        void _BeforeValue();
+        void _Open(char_type head);
+        void _Close(char_type tail);
+        void _WriteValue(const JSonValue &value);
+        void _Drain();
+    };
+
+
+
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+    // CLASS: JSonArena
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+
+    /*! A monotonic JSonMemoryResource.
+
+        Memory is handed out from large blocks by bumping a pointer, and is only given back to the heap, all at once, when the
+        arena is released or destroyed. Deallocating memory from the arena does nothing.
+
+        Blocks start at the given block size and double, up to MAX_BLOCK_SIZE, as more are needed. Requests too large for a
+        block are given a block of their own.
+
+        \code{.cpp}
+            JSonArena arena;
+            JSonValueBuilder builder(&arena);
+            parser.parse(jsonstr, builder);
+        \endcode
+    */
+    class JSonArena : public JSonMemoryResource{
+    public:
+        static const size_type DEFAULT_BLOCK_SIZE = 64 * 1024; ///< The size of the first block allocated by default.
+        static const size_type MAX_BLOCK_SIZE = 4 * 1024 * 1024; ///< The size blocks stop doubling at.
+
+        /*! Creates an arena. No memory is allocated until the arena is first used.
+            @param blockSize The size of the first block allocated.
+            @param upstream The resource the blocks are allocated from. nullptr uses the global heap.
         */
-        static JSonException InvalidJSonType(JSonType expected, JSonType given);
+        explicit JSonArena(size_type blockSize=DEFAULT_BLOCK_SIZE, JSonMemoryResource* upstream=nullptr);
+        ~JSonArena();
 
-        /*! Generate a JSonException when the JSonValue does not have the requested key.
-            @param key A coonst string_type& of the key requested.
-            @return A JSonException with a preformatted message and code for this error.
+        /*! Returns every block to the heap. All memory allocated from the arena becomes invalid. */
+        void release();
+
+        /*! Makes all of the arena's memory available again, keeping hold of it. All memory allocated from the arena becomes
+            invalid.
+
+            An arena holding more than one block swaps them for a single block as large as all of them together, so an
+            arena reset between similar workloads soon stops allocating at all. Use release() to give the memory back.
         */
-        static JSonException MissingKey(const string_type &key);
+        void reset();
 
-        /*! Generate a JSonException when given index is out of bounds of the JSonValue Array.
-            @param index A size_type index value
-            @return A JSonException with a preformatted message and code for this error.
+        /*! Returns the number of bytes allocated from the arena since it was last released. */
+        size_type used() const;
+
+        /*! Returns the number of bytes held in the arena's blocks. */
+        size_type capacity() const;
+
+        /*! Returns the number of blocks held by the arena. */
+        size_type blocks() const;
+
+    protected:
+        void* do_allocate(size_type size, size_type alignment);
+        void do_deallocate(void* p, size_type size, size_type alignment);
+
+    private:
+        JSonArena(const JSonArena&);
+        JSonArena& operator=(const JSonArena&);
+
+        struct _Block{
+            _Block* next;
+            size_type size;
+        };
+
+        JSonMemoryResource* mUpstream;
+        _Block* mBlocks;
+        char* mCur;
+        char* mEnd;
+        size_type mFirstBlockSize;
+        size_type mNextBlockSize;
+        size_type mUsed;
+        size_type mCapacity;
+        size_type mBlockCount;
+
+        void* _Grow(size_type size, size_type alignment);
+    };
+
+
+
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+    // CLASS: JSonDocument
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+
+    /*! A parsed JSon tree, held in a JSonArena owned by the document.
+
+        Every Array, Object and String parsed into the document is allocated from its arena, so parsing barely touches
+        the heap. Destroying or clearing the document releases the arena's blocks without visiting a single JSonValue.
+        Parsing again reuses them, along with the parser's buffers: a document kept for a stream of messages allocates
+        nothing per message once it has seen the largest.
+
+        \code{.cpp}
+            JSonDocument doc;
+            doc.parse_file("export.json");
+
+            const JSonValue& records = doc.root()["records"];
+            for (size_type i = 0; i < records.size(); i++)
+                std::cout << records[i]["name"].get<string_type>() << std::endl;
+        \endcode
+
+        The tree is read through root(). A JSonValue copied out of the tree is allocated from the heap, and is independent
+        of the document.
+
+        The tree can be changed through mutable_root(). Values added that way are allocated from the heap, so a document
+        handed out by mutable_root() is destroyed value by value instead.
+
+        __WARNING:__ A JSonValue moved, or obtained with ::share(), out of the document's tree still lives in the arena, and
+        must not be used after the document is cleared or destroyed.
+    */
+    class JSonDocument{
+    public:
+        /*! Creates an empty document.
+            @param blockSize The size of the first block allocated by the document's arena.
+            @param upstream The resource the arena's blocks are allocated from. nullptr uses the global heap.
+            @param internKeys If true, each distinct Object key is stored once for the whole tree (see JSonKeyPool).
         */
-        static JSonException IndexOutOfBounds(size_type index);
+        explicit JSonDocument(size_type blockSize=JSonArena::DEFAULT_BLOCK_SIZE, JSonMemoryResource* upstream=nullptr, bool internKeys=false);
+        ~JSonDocument();
 
-        /*! Generate a JSonException when Parser encounters an unspecified malformed JSon string that cannot be parsed.
-            @return A JSonException with a preformatted message and code for this error.
+        /*! Takes a valid JSon formatted string and parses it into this document, replacing its current tree.
+            @param jsonstr A const string_type& string containing a valid JSon string.
+            @return A reference to this document.
+            @throw JSonException if the given string is not a valid JSon string. The document is left empty.
         */
-        static JSonException ParseMalformed();
+        JSonDocument& parse(const string_type &jsonstr);
 
-        /*! Generate a JSonException when Parser given a JSon string that does not begin with a valid JSon container.
-            @return A JSonException with a preformatted message and code for this error.
+        /*! Takes a valid, null terminated, JSon formatted string and parses it into this document.
+            @param jsonstr A null terminated string containing a valid JSon string.
+            @return A reference to this document.
+            @throw JSonException if the given string is not a valid JSon string. The document is left empty.
         */
-        static JSonException ParseInvalidJsonContainer();
+        JSonDocument& parse(const char_type* jsonstr);
 
-        /*! Generate a JSonException when Parser encounters a structure ('[]', '{}', or '""') that is not closed.
-            @param type The type of structure missing a valid closure.
-            @return A JSonException with a preformatted message and code for this error.
+        /*! Takes a buffer holding a valid JSon formatted string and parses it, in place, into this document.
+            @param data Pointer to the start of the JSon string. The buffer does not need to be null terminated.
+            @param size The number of characters in the buffer.
+            @return A reference to this document.
+            @throw JSonException if the given buffer is not a valid JSon string. The document is left empty.
         */
-        static JSonException ParseUnclosedStructure(JSonType type);
+        JSonDocument& parse(const char_type* data, size_type size);
 
-        /*! Generate a JSonException when Parser is unable to find an expected symbol (usually ',' or ':')
-            @param symbol A char_type containing the expected, but missing, symbol.
-            @return A JSonException with a preformatted message and code for this error.
+        /*! Takes a StringView over a valid JSon formatted string and parses it, in place, into this document.
+            @param jsonstr A StringView of the JSon string.
+            @return A reference to this document.
+            @throw JSonException if the viewed string is not a valid JSon string. The document is left empty.
         */
-        static JSonException ParseMissingSymbol(char_type symbol);
+        JSonDocument& parse(const StringView &jsonstr);
 
-        /*! Generate a JSonException when Parser encounters an unexpected symbol.
-            @return A JSonException with a preformatted message and code for this error.
+        /*! Parses a buffer into this document, reporting an invalid JSon string in the returned JSonParseResult rather
+            than throwing.
+            @param data Pointer to the start of the JSon string. The buffer does not need to be null terminated.
+            @param size The number of characters in the buffer.
+            @return A JSonParseResult holding the error found, if any. The document is left empty on error.
         */
-        static JSonException ParseInvalidSymbol();
+        JSonParseResult try_parse(const char_type* data, size_type size);
 
-        /*! Generate a JSonException when Parser is unable to determine a values type.
-            @param value A const string_type& containing the value the Parser was attempting to identify.
-            @return A JSonException with a preformatted message and code for this error.
+        /*! Parses a JSon string into this document, reporting an invalid JSon string in the returned JSonParseResult
+            rather than throwing.
+            @param jsonstr A StringView of the JSon string.
+            @return A JSonParseResult holding the error found, if any. The document is left empty on error.
         */
-        static JSonException ParseUnknownValueType(const string_type &value);
+        JSonParseResult try_parse(const StringView &jsonstr);
 
-        /*! Generate a JSonException when Parser was expecting a value but did not find one.
-            @return A JSonException with a preformatted message and code for this error.
+        /*! Parses the JSon file at the given path into this document.
+            @param path The path of the file to parse.
+            @return A reference to this document.
+            @throw JSonException if the file cannot be read or does not contain a valid JSon string. The document is left empty.
         */
-        static JSonException ParseMissingValue();
+        JSonDocument& parse_file(const string_type &path);
+
+        /*! Returns the root of the document's tree. JSonType_Null if nothing has been parsed. */
+        const JSonValue& root() const;
+
+        /*! Returns the root of the document's tree, for changes to be made to it.
+
+            The document is destroyed value by value from then on, until it's next parsed or cleared.
+        */
+        JSonValue& mutable_root();
+
+        /*! Discards the document's tree and releases its arena. */
+        void clear();
+
+        /*! Discards the document's tree, keeping the memory it used for the next parse.
+
+            The arena is reset rather than released, and the parser's and builder's buffers are kept. parse() resets the
+            document itself, so a document parsing one message after another stops allocating once it has seen the largest.
+        */
+        void reset();
+
+        /*! Returns the arena the document's tree is allocated from. */
+        const JSonArena& arena() const;
+
+        /*! Returns the pool the document's keys are interned in, when created with internKeys.
+
+            Keys interned through it find the members of the document's Objects by comparing pointers. They, and the pool's
+            contents, are released when the document is next parsed or cleared.
+        */
+        JSonKeyPool& key_pool();
+
+        /*! Returns the bounds the document's parser holds JSon strings to (see JSonParser). */
+        const JSonParseLimits& limits() const;
+
+        /*! Sets the bounds the document's parser holds JSon strings to from now on.
+            @param limits The new bounds.
+        */
+        void set_limits(const JSonParseLimits &limits);
+
     private:
-        unsigned int m_code;
+        JSonDocument(const JSonDocument&);
+        JSonDocument& operator=(const JSonDocument&);
+
+        JSonArena mArena;
+        JSonKeyPool mKeyPool;
+        bool mInternKeys;
+        JSonValue mRoot;
+        bool mReleaseValues; // Set when the tree may hold memory from outside the arena.
+
+        // Kept from one parse to the next, for their buffers.
+        JSonParser mParser;
+        JSonValueBuilder mBuilder;
+
+        void _Discard();
+    };
+
+
+
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+    // CLASS: JSonAllocatorResource
+    // ------------------------------------------------------------------------------------------------------
+    // ------------------------------------------------------------------------------------------------------
+
+    /*! A JSonMemoryResource allocating through a standard library allocator.
+
+        Lets any allocator supply the memory of a JSonDocument, JSonValueBuilder, Array or Object: pool allocators,
+        std::pmr::polymorphic_allocator, or the allocators of shared memory libraries.
+
+        \code{.cpp}
+            typedef boost::interprocess::allocator<char, segment_manager> ShmAllocator;
+
+            JSonAllocatorResource<ShmAllocator> shm(ShmAllocator(segment.get_segment_manager()));
+            JSonDocument doc(JSonArena::DEFAULT_BLOCK_SIZE, &shm); // The whole tree is placed in the shared memory segment.
+            doc.parse(jsonstr);
+        \endcode
+
+        The allocator's pointer type may be a fancy pointer, but JSonValues refer to each other through plain pointers. A
+        document placed in shared memory can only be read by processes mapping the segment at the same address.
+
+        Memory is allocated in units of std::max_align_t, so requests for stricter alignments throw std::bad_alloc.
+    */
+    template <typename Allocator> class JSonAllocatorResource : public JSonMemoryResource{
+    public:
+        typedef typename std::allocator_traits<Allocator>::template rebind_alloc<std::max_align_t> allocator_type;
+
+        /*! Creates a resource allocating through the given allocator.
+            @param alloc The allocator. It's rebound to allocate std::max_align_t units.
+        */
+        explicit JSonAllocatorResource(const Allocator& alloc=Allocator()) : mAlloc(alloc){}
+
+        /*! Returns the allocator used. */
+        allocator_type get_allocator() const{return mAlloc;}
+
+    protected:
+        typedef std::allocator_traits<allocator_type> traits;
+
+        void* do_allocate(size_type size, size_type alignment){
+            if (alignment > alignof(std::max_align_t))
+                throw std::bad_alloc();
+            typename traits::pointer p = traits::allocate(mAlloc, _Units(size));
+            return static_cast<void*>(std::addressof(*p));
+        }
+
+        void do_deallocate(void* p, size_type size, size_type alignment){
+            std::max_align_t* raw = static_cast<std::max_align_t*>(p);
+            traits::deallocate(mAlloc, std::pointer_traits<typename traits::pointer>::pointer_to(*raw), _Units(size));
+        }
+
+        bool do_is_equal(const JSonMemoryResource& other) const{
+            const JSonAllocatorResource* rhs = dynamic_cast<const JSonAllocatorResource*>(&other);
+            return rhs != nullptr && mAlloc == rhs->mAlloc;
+        }
+
+    private:
+        allocator_type mAlloc;
+
+        static size_type _Units(size_type size){return (size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);}
     };
 
 
@@ -892,17 +3167,37 @@ namespace OYAJSon {
     // ------------------------------------------------------------------------------------------------------
 
 
+    template <typename T> inline void JSonAllocator<T>::construct(JSonValue* p, const JSonValue& value){
+        ::new(static_cast<void*>(p)) JSonValue(value, mResource);
+    }
+
+    template <typename T> inline void JSonAllocator<T>::construct(JSonMember* p, const JSonMember& member){
+        ::new(static_cast<void*>(p)) JSonMember(member, mResource);
+    }
+
     template<> inline string_type JSonValue::get<string_type>() const{
         if (mDataType == JSonType_String)
-            return string_type(mData->_string->begin(), mData->_string->end());
+            return string_type(mData._string->data, mData._string->size);
+        throw JSonException::InvalidJSonType(JSonType_String, mDataType);
+    }
+
+    template<> inline StringView JSonValue::get<StringView>() const{
+        if (mDataType == JSonType_String)
+            return StringView(mData._string->data, mData._string->size);
+        throw JSonException::InvalidJSonType(JSonType_String, mDataType);
+    }
+
+    template<> inline const char_type* JSonValue::get<const char_type*>() const{
+        if (mDataType == JSonType_String)
+            return mData._string->data;
         throw JSonException::InvalidJSonType(JSonType_String, mDataType);
     }
 
     template<> inline double JSonValue::get<double>() const{
         if (mDataType == JSonType_Number){
             if (mNumberInt)
-                return static_cast<double>(mData->_numberi);
-            return mData->_number;
+                return static_cast<double>(mData._numberi);
+            return mData._number;
         }
         throw JSonException::InvalidJSonType(JSonType_Number, mDataType);
     }
@@ -910,8 +3205,8 @@ namespace OYAJSon {
     template<> inline int JSonValue::get<int>() const{
         if (mDataType == JSonType_Number){
             if (mNumberInt)
-                return static_cast<int>(mData->_numberi);
-            return static_cast<int>(mData->_number);
+                return static_cast<int>(mData._numberi);
+            return static_cast<int>(mData._number);
         }
         throw JSonException::InvalidJSonType(JSonType_Number, mDataType);
     }
@@ -919,8 +3214,8 @@ namespace OYAJSon {
     template<> inline unsigned int JSonValue::get<unsigned int>() const{
         if (mDataType == JSonType_Number){
             if (mNumberInt)
-                return static_cast<unsigned int>(mData->_numberi);
-            return static_cast<unsigned int>(mData->_number);
+                return static_cast<unsigned int>(mData._numberi);
+            return static_cast<unsigned int>(mData._number);
         }
         throw JSonException::InvalidJSonType(JSonType_Number, mDataType);
     }
@@ -928,8 +3223,8 @@ namespace OYAJSon {
     template<> inline long JSonValue::get<long>() const{
         if (mDataType == JSonType_Number){
             if (mNumberInt)
-                return static_cast<long>(mData->_numberi);
-            return static_cast<long>(mData->_number);
+                return static_cast<long>(mData._numberi);
+            return static_cast<long>(mData._number);
         }
         throw JSonException::InvalidJSonType(JSonType_Number, mDataType);
     }
@@ -937,8 +3232,8 @@ namespace OYAJSon {
     template<> inline unsigned long JSonValue::get<unsigned long>() const{
         if (mDataType == JSonType_Number){
             if (mNumberInt)
-                return static_cast<unsigned long>(mData->_numberi);
-            return static_cast<unsigned long>(mData->_number);
+                return static_cast<unsigned long>(mData._numberi);
+            return static_cast<unsigned long>(mData._number);
         }
         throw JSonException::InvalidJSonType(JSonType_Number, mDataType);
     }
@@ -946,8 +3241,8 @@ namespace OYAJSon {
     template<> inline long long JSonValue::get<long long>() const{
         if (mDataType == JSonType_Number){
             if (mNumberInt)
-                return mData->_numberi;
-            return static_cast<long long>(mData->_number);
+                return mData._numberi;
+            return static_cast<long long>(mData._number);
         }
         throw JSonException::InvalidJSonType(JSonType_Number, mDataType);
     }
@@ -955,8 +3250,8 @@ namespace OYAJSon {
     template<> inline unsigned long long JSonValue::get<unsigned long long>() const{
         if (mDataType == JSonType_Number){
             if (mNumberInt)
-                return static_cast<unsigned long long>(mData->_numberi);
-            return static_cast<unsigned long long>(mData->_number);
+                return static_cast<unsigned long long>(mData._numberi);
+            return static_cast<unsigned long long>(mData._number);
         }
         throw JSonException::InvalidJSonType(JSonType_Number, mDataType);
     }
@@ -964,42 +3259,128 @@ namespace OYAJSon {
     template<> inline float JSonValue::get<float>() const{
         if (mDataType == JSonType_Number){
             if (mNumberInt)
-                return static_cast<float>(mData->_numberi);
-            return static_cast<float>(mData->_number);
+                return static_cast<float>(mData._numberi);
+            return static_cast<float>(mData._number);
         }
         throw JSonException::InvalidJSonType(JSonType_Number, mDataType);
     }
 
     template<> inline bool JSonValue::get<bool>() const{
         if (mDataType == JSonType_Bool)
-            return mData->_bool;
+            return mData._bool;
         throw JSonException::InvalidJSonType(JSonType_Bool, mDataType);
     }
 
+    template <typename T> inline T JSonCursor::_NumberAs() const{
+        long long i;
+        double d;
+        if (_Number(i, d))
+            return static_cast<T>(i);
+        return static_cast<T>(d);
+    }
+
+    template<> inline double JSonCursor::get<double>() const{return _NumberAs<double>();}
+    template<> inline float JSonCursor::get<float>() const{return _NumberAs<float>();}
+    template<> inline int JSonCursor::get<int>() const{return _NumberAs<int>();}
+    template<> inline unsigned int JSonCursor::get<unsigned int>() const{return _NumberAs<unsigned int>();}
+    template<> inline long JSonCursor::get<long>() const{return _NumberAs<long>();}
+    template<> inline unsigned long JSonCursor::get<unsigned long>() const{return _NumberAs<unsigned long>();}
+    template<> inline long long JSonCursor::get<long long>() const{return _NumberAs<long long>();}
+    template<> inline unsigned long long JSonCursor::get<unsigned long long>() const{return _NumberAs<unsigned long long>();}
+
+    template<> inline bool JSonCursor::get<bool>() const{
+        _Expect(JSonType_Bool);
+        return mTape->mEntries[mEntry].size != 0;
+    }
+
+    template<> inline StringView JSonCursor::get<StringView>() const{
+        _Expect(JSonType_String);
+        return mTape->_String(mEntry, false);
+    }
+
+    template<> inline const char_type* JSonCursor::get<const char_type*>() const{
+        _Expect(JSonType_String);
+        return mTape->_String(mEntry, true).data();
+    }
+
+    template<> inline string_type JSonCursor::get<string_type>() const{
+        return get<StringView>().str();
+    }
+
     template <> inline Object::iterator JSonValue::begin(){
-        if (mDataType == JSonType_Object)
-            return mData->_object->begin();
+        if (mDataType == JSonType_Object){
+            _Lend();
+            return mData._object->value.begin();
+        }
         throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
     }
 
     template <> inline Array::iterator JSonValue::begin(){
-        if (mDataType == JSonType_Array)
-            return mData->_array->begin();
-        throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
+        if (mDataType == JSonType_Array){
+            _Lend();
+            return mData._array->value.begin();
+        }
+        throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
     }
 
     template <> inline Object::iterator JSonValue::end(){
+        if (mDataType == JSonType_Object){
+            _Lend();
+            return mData._object->value.end();
+        }
+        throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
+    }
+
+    template <> inline Array::iterator JSonValue::end(){
+        if (mDataType == JSonType_Array){
+            _Lend();
+            return mData._array->value.end();
+        }
+        throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
+    }
+
+    template <> inline Object::const_iterator JSonValue::begin() const{
         if (mDataType == JSonType_Object)
-            return mData->_object->end();
+            return mData._object->value.begin();
+        throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
+    }
+
+    template <> inline Array::const_iterator JSonValue::begin() const{
+        if (mDataType == JSonType_Array)
+            return mData._array->value.begin();
         throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
     }
 
-    template <> inline Array::iterator JSonValue::end(){
+    template <> inline Object::const_iterator JSonValue::end() const{
+        if (mDataType == JSonType_Object)
+            return mData._object->value.end();
+        throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
+    }
+
+    template <> inline Array::const_iterator JSonValue::end() const{
         if (mDataType == JSonType_Array)
-            return mData->_array->end();
+            return mData._array->value.end();
         throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
     }
 
+    template <typename... Args> inline JSonValue& JSonValue::emplace_back(Args&&... args){
+        if (mDataType != JSonType_Array)
+            throw JSonException::InvalidJSonType(JSonType_Array, mDataType);
+        _Lend();
+        mData._array->value.emplace_back(std::forward<Args>(args)...);
+        return mData._array->value.back();
+    }
+
+    template <typename... Args> inline JSonValue& JSonValue::emplace(const StringView &key, Args&&... args){
+        if (mDataType != JSonType_Object)
+            throw JSonException::InvalidJSonType(JSonType_Object, mDataType);
+        _Lend();
+        std::pair<Object::iterator, bool> added = mData._object->value.emplace(key, JSonValue(std::forward<Args>(args)...));
+        if (!added.second)
+            throw std::runtime_error("Key already exists in JSon Object.");
+        return added.first->second;
+    }
+
 } // End namespace "OYAJSon"
 
 #endif // __OYAJSON_H__
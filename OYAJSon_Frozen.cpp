@@ -0,0 +1,368 @@
+/*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014-2015 Bryan Miller
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "OYAJSon_Frozen.h"
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace OYAJSon {
+
+    // Objects with more members than this are looked up by hash rather than by comparing every key.
+    static const size_type LINEAR_MEMBERS = 16;
+
+    static std::uint32_t _HashText(const char_type* s, size_type size){
+        std::uint32_t hash = 2166136261u; // FNV-1a
+        for (size_type i = 0; i < size; i++)
+            hash = (hash ^ static_cast<unsigned char>(s[i])) * 16777619u;
+        return hash;
+    }
+
+    static std::uint32_t _Checked32(size_type value){
+        if (value > std::numeric_limits<std::uint32_t>::max())
+            throw std::length_error("JSonValue is too large to freeze.");
+        return static_cast<std::uint32_t>(value);
+    }
+
+    const JSonFrozen::_Node JSonFrozen::NULL_NODE = {{{0, 0}}, 0, JSonType_Null, false};
+
+
+    /* --------------------------------------------------------------------------
+    *  JSonFrozen
+    *  -------------------------------------------------------------------------- */
+
+    JSonFrozen::JSonFrozen(const JSonValue &value){
+        // Arrays and Objects are frozen breadth first, so the children of each are laid out side by side.
+        std::vector<std::pair<const JSonValue*, size_type> > pending;
+        std::unordered_map<string_type, std::uint32_t> texts;
+
+        auto text = [&](const char_type* s, size_type size) -> std::uint32_t{
+            std::pair<std::unordered_map<string_type, std::uint32_t>::iterator, bool> found =
+                texts.emplace(string_type(s, size), 0);
+            if (found.second){
+                found.first->second = _Checked32(mText.size());
+                mText.insert(mText.end(), s, s + size);
+                mText.push_back('\0');
+                _Checked32(mText.size());
+            }
+            return found.first->second;
+        };
+
+        auto set = [&](const JSonValue& v, size_type index){
+            _Node& node = mNodes[index];
+            std::memset(&node, 0, sizeof(node));
+            node.type = static_cast<std::uint8_t>(v.mDataType);
+            switch(v.mDataType){
+            case JSonType_Object:
+            case JSonType_Array:
+                pending.push_back(std::make_pair(&v, index)); break;
+            case JSonType_String:
+                node.range.offset = text(v.mData._string->data, v.mData._string->size);
+                node.range.size = static_cast<std::uint32_t>(v.mData._string->size);
+                break;
+            case JSonType_Number:
+                node.numberInt = v.mNumberInt;
+                if (v.mNumberInt)
+                    node.numberi = v.mData._numberi;
+                else
+                    node.number = v.mData._number;
+                break;
+            case JSonType_Bool:
+                node.boolean = v.mData._bool; break;
+            default: break;
+            }
+        };
+
+        mNodes.resize(1);
+        set(value, 0);
+        std::vector<std::uint32_t> order;
+        for (size_type p = 0; p < pending.size(); p++){
+            const JSonValue& v = *pending[p].first;
+            size_type index = pending[p].second;
+            size_type first = mNodes.size();
+            if (v.mDataType == JSonType_Array){
+                const Array& elements = v.mData._array->value;
+                mNodes.resize(_Checked32(first + elements.size()));
+                mNodes[index].range.offset = static_cast<std::uint32_t>(first);
+                mNodes[index].range.size = static_cast<std::uint32_t>(elements.size());
+                for (size_type i = 0; i < elements.size(); i++)
+                    set(elements[i], first + i);
+                continue;
+            }
+
+            const Object& members = v.mData._object->value;
+            size_type keys = mKeys.size();
+            mNodes.resize(_Checked32(first + members.size()));
+            mKeys.resize(_Checked32(keys + members.size()));
+            mNodes[index].range.offset = static_cast<std::uint32_t>(first);
+            mNodes[index].range.size = static_cast<std::uint32_t>(members.size());
+            mNodes[index].keys = static_cast<std::uint32_t>(keys);
+            for (size_type i = 0; i < members.size(); i++){
+                const JSonKey& key = members.begin()[i].first;
+                _Key& k = mKeys[keys + i];
+                k.offset = text(key.data(), key.size());
+                k.size = static_cast<std::uint32_t>(key.size());
+                k.hash = _HashText(key.data(), key.size());
+                k.order = static_cast<std::uint32_t>(i);
+                set(members.begin()[i].second, first + i);
+            }
+            if (members.size() > LINEAR_MEMBERS){
+                const _Key* k = mKeys.data() + keys;
+                order.resize(members.size());
+                for (size_type i = 0; i < order.size(); i++)
+                    order[i] = static_cast<std::uint32_t>(i);
+                std::stable_sort(order.begin(), order.end(), [k](std::uint32_t a, std::uint32_t b){return k[a].hash < k[b].hash;});
+                for (size_type i = 0; i < order.size(); i++)
+                    mKeys[keys + i].order = order[i];
+            }
+        }
+
+        // Growing the tables may have left up to half of each unused.
+        mNodes.shrink_to_fit();
+        mKeys.shrink_to_fit();
+        mText.shrink_to_fit();
+    }
+
+    JSonFrozenValue JSonFrozen::root() const{
+        return JSonFrozenValue(this, mNodes.data());
+    }
+
+    size_type JSonFrozen::count() const{
+        return mNodes.size();
+    }
+
+    size_type JSonFrozen::memory_used() const{
+        return sizeof(JSonFrozen) + mNodes.capacity() * sizeof(_Node) + mKeys.capacity() * sizeof(_Key) + mText.capacity();
+    }
+
+    const JSonFrozen::_Node* JSonFrozen::_Find(const _Node* object, const StringView &key) const{
+        const _Node* members = mNodes.data() + object->range.offset;
+        const _Key* keys = mKeys.data() + object->keys;
+        size_type count = object->range.size;
+        if (count <= LINEAR_MEMBERS){
+            for (size_type i = 0; i < count; i++){
+                if (keys[i].size == key.size() && _Text(keys[i].offset, keys[i].size) == key)
+                    return members + i;
+            }
+            return nullptr;
+        }
+
+        std::uint32_t hash = _HashText(key.data(), key.size());
+        size_type low = 0, high = count;
+        while (low < high){
+            size_type mid = low + (high - low) / 2;
+            if (keys[keys[mid].order].hash < hash)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        for (; low < count; low++){
+            const _Key& k = keys[keys[low].order];
+            if (k.hash != hash)
+                break;
+            if (_Text(k.offset, k.size) == key)
+                return members + keys[low].order;
+        }
+        return nullptr;
+    }
+
+    std::shared_ptr<const JSonFrozen> freeze(const JSonValue &value){
+        return std::make_shared<const JSonFrozen>(value);
+    }
+
+
+    /* --------------------------------------------------------------------------
+    *  JSonFrozenValue
+    *  -------------------------------------------------------------------------- */
+
+    JSonFrozenValue::JSonFrozenValue() : mFrozen(nullptr), mNode(&JSonFrozen::NULL_NODE){}
+
+    bool JSonFrozenValue::is(JSonType t) const{
+        return mNode->type == t;
+    }
+
+    JSonType JSonFrozenValue::type() const{
+        return static_cast<JSonType>(mNode->type);
+    }
+
+    size_type JSonFrozenValue::size() const{
+        switch(mNode->type){
+        case JSonType_Object:
+        case JSonType_Array:
+        case JSonType_String:
+            return mNode->range.size;
+        case JSonType_Number:
+        case JSonType_Bool:
+            return 1;
+        default: break;
+        }
+        return 0;
+    }
+
+    void JSonFrozenValue::_Expect(JSonType t) const{
+        if (mNode->type != t)
+            throw JSonException::InvalidJSonType(t, type());
+    }
+
+    JSonFrozenValue JSonFrozenValue::at(const StringView &key) const{
+        _Expect(JSonType_Object);
+        const JSonFrozen::_Node* member = mFrozen->_Find(mNode, key);
+        if (member == nullptr)
+            throw JSonException::MissingKey(key.str());
+        return JSonFrozenValue(mFrozen, member);
+    }
+
+    JSonFrozenValue JSonFrozenValue::at(size_type index) const{
+        _Expect(JSonType_Array);
+        if (index >= mNode->range.size)
+            throw JSonException::IndexOutOfBounds(index);
+        return JSonFrozenValue(mFrozen, mFrozen->mNodes.data() + mNode->range.offset + index);
+    }
+
+    bool JSonFrozenValue::has_key(const StringView &key) const{
+        return mNode->type == JSonType_Object && mFrozen->_Find(mNode, key) != nullptr;
+    }
+
+    StringView JSonFrozenValue::key(size_type index) const{
+        _Expect(JSonType_Object);
+        if (index >= mNode->range.size)
+            throw JSonException::IndexOutOfBounds(index);
+        const JSonFrozen::_Key& k = mFrozen->mKeys[mNode->keys + index];
+        return mFrozen->_Text(k.offset, k.size);
+    }
+
+    JSonFrozenValue JSonFrozenValue::member(size_type index) const{
+        if (mNode->type != JSonType_Object && mNode->type != JSonType_Array)
+            throw JSonException::InvalidJSonType(JSonType_Object, type());
+        if (index >= mNode->range.size)
+            throw JSonException::IndexOutOfBounds(index);
+        return JSonFrozenValue(mFrozen, mFrozen->mNodes.data() + mNode->range.offset + index);
+    }
+
+    JSonValue JSonFrozenValue::thaw() const{
+        switch(mNode->type){
+        case JSonType_Object:{
+            JSonValue value(JSonType_Object);
+            Object& members = value.get_object();
+            members.reserve(mNode->range.size);
+            for (size_type i = 0; i < mNode->range.size; i++)
+                members.emplace(key(i), member(i).thaw());
+            return value;
+        }
+        case JSonType_Array:{
+            JSonValue value(JSonType_Array);
+            Array& elements = value.get_array();
+            elements.reserve(mNode->range.size);
+            for (size_type i = 0; i < mNode->range.size; i++)
+                elements.push_back(member(i).thaw());
+            return value;
+        }
+        case JSonType_String:
+            return JSonValue(get<string_type>());
+        case JSonType_Number:
+            if (mNode->numberInt)
+                return JSonValue(mNode->numberi);
+            return JSonValue(mNode->number);
+        case JSonType_Bool:
+            return JSonValue(mNode->boolean);
+        default: break;
+        }
+        return JSonValue();
+    }
+
+    string_type JSonFrozenValue::to_str() const{
+        return thaw().to_str();
+    }
+
+    bool JSonFrozenValue::operator==(const JSonFrozenValue &rhs) const{
+        if (mNode->type != rhs.mNode->type)
+            return false;
+        switch(mNode->type){
+        case JSonType_Object:
+            // Members may be in any order, as with JSonObject.
+            if (size() != rhs.size())
+                return false;
+            for (size_type i = 0; i < size(); i++){
+                const JSonFrozen::_Node* other = rhs.mFrozen->_Find(rhs.mNode, key(i));
+                if (other == nullptr || member(i) != JSonFrozenValue(rhs.mFrozen, other))
+                    return false;
+            }
+            return true;
+        case JSonType_Array:
+            if (size() != rhs.size())
+                return false;
+            for (size_type i = 0; i < size(); i++){
+                if (member(i) != rhs.member(i))
+                    return false;
+            }
+            return true;
+        case JSonType_String:
+            return get<StringView>() == rhs.get<StringView>();
+        case JSonType_Number:
+            if (mNode->numberInt && rhs.mNode->numberInt)
+                return mNode->numberi == rhs.mNode->numberi;
+            return get<double>() == rhs.get<double>();
+        case JSonType_Bool:
+            return mNode->boolean == rhs.mNode->boolean;
+        default: break;
+        }
+        return true;
+    }
+
+
+    /* --------------------------------------------------------------------------
+    *  JSonFrozenHandle
+    *  -------------------------------------------------------------------------- */
+
+    JSonFrozenHandle::JSonFrozenHandle() : mCurrent(std::make_shared<const Snapshot>(Snapshot{pointer(), 0})){}
+
+    JSonFrozenHandle::JSonFrozenHandle(pointer document) : mCurrent(std::make_shared<const Snapshot>(Snapshot{std::move(document), 1})){}
+
+    JSonFrozenHandle::Snapshot JSonFrozenHandle::load() const{
+        return *std::atomic_load(&mCurrent);
+    }
+
+    std::uint64_t JSonFrozenHandle::version() const{
+        return std::atomic_load(&mCurrent)->version;
+    }
+
+    std::uint64_t JSonFrozenHandle::store(pointer document){
+        std::shared_ptr<const Snapshot> current = std::atomic_load(&mCurrent);
+        std::shared_ptr<const Snapshot> next;
+        do{
+            next = std::make_shared<const Snapshot>(Snapshot{document, current->version + 1});
+        } while (!std::atomic_compare_exchange_weak(&mCurrent, &current, next));
+        return next->version;
+    }
+
+    bool JSonFrozenHandle::compare_exchange(std::uint64_t expected, pointer document){
+        std::shared_ptr<const Snapshot> current = std::atomic_load(&mCurrent);
+        if (current->version != expected)
+            return false;
+        std::shared_ptr<const Snapshot> next = std::make_shared<const Snapshot>(Snapshot{std::move(document), expected + 1});
+        // A failed exchange loads the newer snapshot into current, and its version can only have moved on.
+        return std::atomic_compare_exchange_strong(&mCurrent, &current, next);
+    }
+
+} // End namespace "OYAJSon"
@@ -0,0 +1,315 @@
+#ifndef __OYAJSON_FROZEN_H__
+#define __OYAJSON_FROZEN_H__
+
+/*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014-2015 Bryan Miller
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+/*! Immutable, thread-safe documents for the OYAJSon library. */
+
+
+#include "OYAJSon.h"
+
+#include <memory>
+
+
+namespace OYAJSon {
+
+    class JSonFrozenValue;
+
+    /*! An immutable copy of a JSonValue, laid out for reading.
+
+        A JSonFrozen is created from a JSonValue with freeze() and can never be changed afterwards. Every value lives in
+        one flat table, the children of an Array or Object side by side, and every String and key in one block of text with
+        repeated Strings and keys stored once. Lookups never allocate memory, insert keys or touch a reference count.
+
+        Any number of threads may read the same JSonFrozen at once, without locking. Use JSonFrozenHandle to swap in a new
+        one while they do.
+
+        \code{.cpp}
+            std::shared_ptr<const JSonFrozen> config = freeze(parsed);
+
+            // Any thread...
+            JSonFrozenValue limits = config->root()["limits"];
+            int connections = limits["connections"].get<int>();
+        \endcode
+
+        A document may hold up to 2^32 values and 4GB of String and key text.
+    */
+    class JSonFrozen{
+    public:
+        /*! Creates a frozen copy of the given JSonValue.
+            @param value The JSonValue to copy. It is left untouched.
+            @throw std::length_error if the value is too large to freeze.
+        */
+        explicit JSonFrozen(const JSonValue &value);
+
+        /*! Returns the frozen value at the top of the document. */
+        JSonFrozenValue root() const;
+
+        /*! Returns the number of values in the document, including every Array and Object. */
+        size_type count() const;
+
+        /*! Returns the number of bytes of memory holding the document. */
+        size_type memory_used() const;
+
+    private:
+        JSonFrozen(const JSonFrozen&);
+        JSonFrozen& operator=(const JSonFrozen&);
+
+        // A value. Arrays and Objects hold the range of their children's nodes, Strings the range of their text.
+        struct _Node{
+            struct _Range{
+                std::uint32_t offset;
+                std::uint32_t size;
+            };
+            union{
+                _Range range;
+                double number;
+                long long numberi;
+                bool boolean;
+            };
+            std::uint32_t keys;     // Objects only: the position of their first member's key in mKeys.
+            std::uint8_t type;
+            bool numberInt;
+        };
+
+        // The key of an Object member. The members of a large Object are looked up by hash: order then holds the
+        // position of the member with the order-th smallest hash.
+        struct _Key{
+            std::uint32_t offset;
+            std::uint32_t size;
+            std::uint32_t hash;
+            std::uint32_t order;
+        };
+
+        // Viewed by default constructed JSonFrozenValues.
+        static const _Node NULL_NODE;
+
+        std::vector<_Node> mNodes;
+        std::vector<_Key> mKeys;
+        std::vector<char_type> mText;
+
+        const _Node* _Find(const _Node* object, const StringView &key) const;
+        StringView _Text(std::uint32_t offset, std::uint32_t size) const{return StringView(mText.data() + offset, size);}
+
+        friend class JSonFrozenValue;
+    };
+
+
+    /*! A read-only view of a value within a JSonFrozen.
+
+        Mirrors the const half of JSonValue: at(), operator[], has_key(), get<T>() and size() behave the same, throwing the
+        same JSonExceptions. A JSonFrozenValue is two pointers, cheap to copy and pass by value, and valid for as long as
+        the JSonFrozen it came from.
+
+        A default constructed JSonFrozenValue is a JSonType_Null belonging to no document.
+    */
+    class JSonFrozenValue{
+    public:
+        /*! Creates a view of a JSonType_Null. */
+        JSonFrozenValue();
+
+        /*! Returns true if the value is of the given JSonType. */
+        bool is(JSonType t) const;
+
+        /*! Returns the JSonType of the value. */
+        JSonType type() const;
+
+        /*! Returns the number of members of an Object, elements of an Array or characters of a String. Numbers and Bools
+            return 1, Nulls 0.
+        */
+        size_type size() const;
+
+        /*! Returns the value as the given type. Supports the same types as JSonValue::get().
+            @throw JSonException::ERR_INVALIDJSONTYPE if the value isn't of a matching type.
+
+            StringView and `const char_type*` results point into the JSonFrozen, and are valid for as long as it is.
+        */
+        template <typename T> T get() const;
+
+        /*! Returns the member of an Object with the given key.
+            @throw JSonException::ERR_INVALIDJSONTYPE if the value isn't an Object.
+            @throw JSonException::ERR_MISSINGKEY if the Object has no member with the key.
+        */
+        JSonFrozenValue at(const StringView &key) const;
+
+        /*! Returns the element of an Array at the given index.
+            @throw JSonException::ERR_INVALIDJSONTYPE if the value isn't an Array.
+            @throw JSonException::ERR_INDEXOUTOFBOUNDS if the index is beyond the end of the Array.
+        */
+        JSonFrozenValue at(size_type index) const;
+
+        /*! Same as at(key). Missing keys are never inserted. */
+        JSonFrozenValue operator[](const StringView &key) const{return at(key);}
+
+        /*! Same as at(index). */
+        JSonFrozenValue operator[](size_type index) const{return at(index);}
+
+        /*! Returns true if the value is an Object with a member with the given key. */
+        bool has_key(const StringView &key) const;
+
+        /*! Returns the key of an Object's member by position, in the order the members were in when frozen.
+            @throw JSonException::ERR_INVALIDJSONTYPE if the value isn't an Object.
+            @throw JSonException::ERR_INDEXOUTOFBOUNDS if the index is beyond the last member.
+        */
+        StringView key(size_type index) const;
+
+        /*! Returns an Object's member, or an Array's element, by position. Members are in the order they were in when
+            frozen, so `key(i)` is the key of `member(i)`.
+            @throw JSonException::ERR_INVALIDJSONTYPE if the value isn't an Object or Array.
+            @throw JSonException::ERR_INDEXOUTOFBOUNDS if the index is beyond the last member or element.
+        */
+        JSonFrozenValue member(size_type index) const;
+
+        /*! Returns a JSonValue copy of the value, which can be changed. */
+        JSonValue thaw() const;
+
+        /*! Returns the value as a JSon string, in the same format as JSonValue::to_str(). */
+        string_type to_str() const;
+
+        /*! Returns true if both views hold equal values, as JSonValue::operator== would. */
+        bool operator==(const JSonFrozenValue &rhs) const;
+        bool operator!=(const JSonFrozenValue &rhs) const{return !(*this == rhs);}
+
+    private:
+        const JSonFrozen* mFrozen;
+        const JSonFrozen::_Node* mNode;
+
+        JSonFrozenValue(const JSonFrozen* frozen, const JSonFrozen::_Node* node) : mFrozen(frozen), mNode(node){}
+        void _Expect(JSonType t) const;
+        template <typename T> T _Number() const;
+
+        friend class JSonFrozen;
+    };
+
+
+    /*! Freezes the given JSonValue.
+        @param value The JSonValue to copy. It is left untouched.
+        @return A shared, immutable copy of the value, ready to hand to any number of threads or a JSonFrozenHandle.
+        @throw std::length_error if the value is too large to freeze.
+    */
+    std::shared_ptr<const JSonFrozen> freeze(const JSonValue &value);
+
+
+    /*! A slot holding the current version of a JSonFrozen, swapped atomically.
+
+        Readers load() a snapshot: the document and its version number. The snapshot keeps its document alive however
+        many times it's replaced, so a reader sees one consistent document for as long as it holds on to the snapshot.
+        Writers freeze a new document and store() it, or compare_exchange() it to swap only if nobody else has since.
+
+        \code{.cpp}
+            JSonFrozenHandle config(freeze(parsed));
+
+            // Request threads...
+            JSonFrozenHandle::Snapshot current = config.load();
+            handle(request, current.document->root());
+
+            // The reloading thread...
+            config.store(freeze(reparsed));
+        \endcode
+
+        Every method may be called from any number of threads at once.
+    */
+    class JSonFrozenHandle{
+    public:
+        typedef std::shared_ptr<const JSonFrozen> pointer;
+
+        /*! A document and the version it was stored as. */
+        struct Snapshot{
+            pointer document;       ///< The document. nullptr if none has been stored.
+            std::uint64_t version;  ///< 0 for the empty handle, then 1 for the first document stored, 2 for the next...
+        };
+
+        /*! Creates a handle holding no document, at version 0. */
+        JSonFrozenHandle();
+
+        /*! Creates a handle holding the given document, at version 1. */
+        explicit JSonFrozenHandle(pointer document);
+
+        /*! Returns the current document and its version. */
+        Snapshot load() const;
+
+        /*! Returns the current version. */
+        std::uint64_t version() const;
+
+        /*! Replaces the document.
+            @param document The new document.
+            @return The version the new document was stored as.
+        */
+        std::uint64_t store(pointer document);
+
+        /*! Replaces the document, but only if the version is still the one given.
+            @param expected The version the new document was based on, usually from an earlier load().
+            @param document The new document.
+            @return true if the document was stored as version expected + 1, false if another was stored first.
+        */
+        bool compare_exchange(std::uint64_t expected, pointer document);
+
+    private:
+        JSonFrozenHandle(const JSonFrozenHandle&);
+        JSonFrozenHandle& operator=(const JSonFrozenHandle&);
+
+        // Only ever accessed through std::atomic_load() and friends.
+        std::shared_ptr<const Snapshot> mCurrent;
+    };
+
+
+    template <typename T> inline T JSonFrozenValue::_Number() const{
+        if (mNode->type != JSonType_Number)
+            throw JSonException::InvalidJSonType(JSonType_Number, static_cast<JSonType>(mNode->type));
+        return mNode->numberInt ? static_cast<T>(mNode->numberi) : static_cast<T>(mNode->number);
+    }
+
+    template<> inline double JSonFrozenValue::get<double>() const{return _Number<double>();}
+    template<> inline float JSonFrozenValue::get<float>() const{return _Number<float>();}
+    template<> inline int JSonFrozenValue::get<int>() const{return _Number<int>();}
+    template<> inline unsigned int JSonFrozenValue::get<unsigned int>() const{return _Number<unsigned int>();}
+    template<> inline long JSonFrozenValue::get<long>() const{return _Number<long>();}
+    template<> inline unsigned long JSonFrozenValue::get<unsigned long>() const{return _Number<unsigned long>();}
+    template<> inline long long JSonFrozenValue::get<long long>() const{return _Number<long long>();}
+    template<> inline unsigned long long JSonFrozenValue::get<unsigned long long>() const{return _Number<unsigned long long>();}
+
+    template<> inline bool JSonFrozenValue::get<bool>() const{
+        _Expect(JSonType_Bool);
+        return mNode->boolean;
+    }
+
+    template<> inline StringView JSonFrozenValue::get<StringView>() const{
+        _Expect(JSonType_String);
+        return mFrozen->_Text(mNode->range.offset, mNode->range.size);
+    }
+
+    template<> inline const char_type* JSonFrozenValue::get<const char_type*>() const{
+        _Expect(JSonType_String);
+        return mFrozen->mText.data() + mNode->range.offset;
+    }
+
+    template<> inline string_type JSonFrozenValue::get<string_type>() const{
+        _Expect(JSonType_String);
+        return string_type(mFrozen->mText.data() + mNode->range.offset, mNode->range.size);
+    }
+
+} // End namespace "OYAJSon"
+
+#endif // __OYAJSON_FROZEN_H__
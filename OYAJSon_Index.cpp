@@ -0,0 +1,529 @@
+/*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014-2015 Bryan Miller
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "OYAJSon.h"
+#include <cstring>
+
+// Defining OYAJSON_NO_SIMD builds the portable indexer only. OYAJSON_NO_AVX2 leaves out the AVX2 indexer.
+#if !defined(OYAJSON_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define OYAJSON_INDEX_SSE2
+#include <emmintrin.h>
+#endif
+
+// The AVX2 indexer is compiled alongside the others and picked at runtime, which needs GCC (4.9+) or Clang.
+#if defined(OYAJSON_INDEX_SSE2) && !defined(OYAJSON_NO_AVX2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OYAJSON_INDEX_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace OYAJSon {
+
+    // Number of bytes indexed by each call to _Refill(). Must be a multiple of 64.
+    static const size_type INDEX_WINDOW = 16 * 1024;
+    static const size_type INDEX_BLOCK = 64;
+
+    // One bit per byte of a 64 byte block, for each class of character the index cares about.
+    struct _BlockMasks{
+        std::uint64_t quote;
+        std::uint64_t backslash;
+        std::uint64_t op;           // { } [ ] , :
+        std::uint64_t whitespace;
+    };
+
+    // Classifies the given number of 64 byte blocks into masks.
+    typedef void (*_ClassifyFunc)(const char_type* data, size_type blocks, _BlockMasks* masks);
+
+    // Finds the first byte of the given bytes that isn't part of valid UTF-8.
+    typedef const char_type* (*_FindInvalidUtf8Func)(const char_type* data, size_type size);
+
+    inline unsigned int _TrailingZeros(std::uint64_t v){
+#if defined(__GNUC__)
+        return static_cast<unsigned int>(__builtin_ctzll(v));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long idx;
+        _BitScanForward64(&idx, v);
+        return static_cast<unsigned int>(idx);
+#else
+        unsigned int idx = 0;
+        while ((v & 1) == 0){
+            v >>= 1;
+            idx++;
+        }
+        return idx;
+#endif
+    }
+
+    // Each bit of the result is the xor of that bit and all bits below it. Turns a mask of quotes into a mask of the
+    // bytes between them.
+    inline std::uint64_t _PrefixXor(std::uint64_t v){
+        v ^= v << 1;
+        v ^= v << 2;
+        v ^= v << 4;
+        v ^= v << 8;
+        v ^= v << 16;
+        v ^= v << 32;
+        return v;
+    }
+
+
+/* --------------------------------------------------------------------------------------------
+ *  Classifiers
+ -------------------------------------------------------------------------------------------- */
+
+    void _ClassifyScalar(const char_type* data, size_type blocks, _BlockMasks* masks){
+        for (size_type b = 0; b < blocks; b++, data += INDEX_BLOCK){
+            _BlockMasks m = {0, 0, 0, 0};
+            for (unsigned int i = 0; i < INDEX_BLOCK; i++){
+                std::uint64_t bit = static_cast<std::uint64_t>(1) << i;
+                switch(data[i]){
+                case '"': m.quote |= bit; break;
+                case '\\': m.backslash |= bit; break;
+                case '{': case '}': case '[': case ']': case ',': case ':':
+                    m.op |= bit; break;
+                case ' ': case '\t': case '\n': case '\r':
+                    m.whitespace |= bit; break;
+                default: break;
+                }
+            }
+            masks[b] = m;
+        }
+    }
+
+#ifdef OYAJSON_INDEX_SSE2
+    void _ClassifySse2(const char_type* data, size_type blocks, _BlockMasks* masks){
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i comma = _mm_set1_epi8(',');
+        const __m128i colon = _mm_set1_epi8(':');
+        // '[' and ']' differ from '{' and '}' only by bit 0x20, so setting that bit catches both brackets of a kind.
+        const __m128i caseBit = _mm_set1_epi8(0x20);
+        const __m128i braceHead = _mm_set1_epi8('{');
+        const __m128i braceTail = _mm_set1_epi8('}');
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i newline = _mm_set1_epi8('\n');
+        const __m128i creturn = _mm_set1_epi8('\r');
+
+        for (size_type b = 0; b < blocks; b++, data += INDEX_BLOCK){
+            _BlockMasks m = {0, 0, 0, 0};
+            for (unsigned int i = 0; i < INDEX_BLOCK; i += 16){
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                __m128i folded = _mm_or_si128(v, caseBit);
+                __m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, braceHead), _mm_cmpeq_epi8(folded, braceTail)),
+                                          _mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, colon)));
+                __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)),
+                                          _mm_or_si128(_mm_cmpeq_epi8(v, newline), _mm_cmpeq_epi8(v, creturn)));
+
+                m.quote |= static_cast<std::uint64_t>(static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)))) << i;
+                m.backslash |= static_cast<std::uint64_t>(static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)))) << i;
+                m.op |= static_cast<std::uint64_t>(static_cast<unsigned int>(_mm_movemask_epi8(op))) << i;
+                m.whitespace |= static_cast<std::uint64_t>(static_cast<unsigned int>(_mm_movemask_epi8(ws))) << i;
+            }
+            masks[b] = m;
+        }
+    }
+#endif
+
+#ifdef OYAJSON_INDEX_AVX2
+    __attribute__((target("avx2")))
+    void _ClassifyAvx2(const char_type* data, size_type blocks, _BlockMasks* masks){
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i comma = _mm256_set1_epi8(',');
+        const __m256i colon = _mm256_set1_epi8(':');
+        const __m256i caseBit = _mm256_set1_epi8(0x20);
+        const __m256i braceHead = _mm256_set1_epi8('{');
+        const __m256i braceTail = _mm256_set1_epi8('}');
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i tab = _mm256_set1_epi8('\t');
+        const __m256i newline = _mm256_set1_epi8('\n');
+        const __m256i creturn = _mm256_set1_epi8('\r');
+
+        for (size_type b = 0; b < blocks; b++, data += INDEX_BLOCK){
+            _BlockMasks m = {0, 0, 0, 0};
+            for (unsigned int i = 0; i < INDEX_BLOCK; i += 32){
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                __m256i folded = _mm256_or_si256(v, caseBit);
+                __m256i op = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(folded, braceHead), _mm256_cmpeq_epi8(folded, braceTail)),
+                                             _mm256_or_si256(_mm256_cmpeq_epi8(v, comma), _mm256_cmpeq_epi8(v, colon)));
+                __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab)),
+                                             _mm256_or_si256(_mm256_cmpeq_epi8(v, newline), _mm256_cmpeq_epi8(v, creturn)));
+
+                m.quote |= static_cast<std::uint64_t>(static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)))) << i;
+                m.backslash |= static_cast<std::uint64_t>(static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash)))) << i;
+                m.op |= static_cast<std::uint64_t>(static_cast<unsigned int>(_mm256_movemask_epi8(op))) << i;
+                m.whitespace |= static_cast<std::uint64_t>(static_cast<unsigned int>(_mm256_movemask_epi8(ws))) << i;
+            }
+            masks[b] = m;
+        }
+    }
+#endif
+
+
+/* --------------------------------------------------------------------------------------------
+ *  UTF-8 Validators
+ -------------------------------------------------------------------------------------------- */
+
+    // Returns the length of the valid UTF-8 sequence at s, which has end - s bytes to it, or 0 if it isn't valid.
+    // Overlong encodings, surrogates (U+D800 to U+DFFF), and anything past U+10FFFF are invalid, as are cut short sequences.
+    inline size_type _Utf8Sequence(const unsigned char* s, const unsigned char* end){
+        unsigned char c = s[0];
+        if (c < 0x80)
+            return 1;
+
+        // Only the second byte of a sequence has a range narrower than any continuation byte's.
+        size_type len;
+        unsigned char low = 0x80;
+        unsigned char high = 0xBF;
+        if (c >= 0xC2 && c <= 0xDF){
+            len = 2;
+        } else if (c >= 0xE0 && c <= 0xEF){
+            len = 3;
+            if (c == 0xE0)
+                low = 0xA0;     // Overlong
+            else if (c == 0xED)
+                high = 0x9F;    // Surrogates
+        } else if (c >= 0xF0 && c <= 0xF4){
+            len = 4;
+            if (c == 0xF0)
+                low = 0x90;     // Overlong
+            else if (c == 0xF4)
+                high = 0x8F;    // Past U+10FFFF
+        } else {
+            return 0;
+        }
+
+        if (static_cast<size_type>(end - s) < len || s[1] < low || s[1] > high)
+            return 0;
+        for (size_type i = 2; i < len; i++){
+            if ((s[i] & 0xC0) != 0x80)
+                return 0;
+        }
+        return len;
+    }
+
+    const char_type* _FindInvalidUtf8Scalar(const char_type* data, size_type size){
+        const unsigned char* cur = reinterpret_cast<const unsigned char*>(data);
+        const unsigned char* end = cur + size;
+        while (cur != end){
+            // Skipping through ASCII eight bytes at a time.
+            if (end - cur >= 8){
+                std::uint64_t word;
+                std::memcpy(&word, cur, sizeof(word));
+                if ((word & 0x8080808080808080ULL) == 0){
+                    cur += 8;
+                    continue;
+                }
+            }
+            size_type len = _Utf8Sequence(cur, end);
+            if (len == 0)
+                return reinterpret_cast<const char_type*>(cur);
+            cur += len;
+        }
+        return data + size;
+    }
+
+#ifdef OYAJSON_INDEX_SSE2
+    // SSE2 has no byte shuffle to do lookups with, so only ASCII is skipped 16 bytes at a time. Anything else is checked
+    // a sequence at a time until the next ASCII run.
+    const char_type* _FindInvalidUtf8Sse2(const char_type* data, size_type size){
+        const char_type* cur = data;
+        const char_type* end = data + size;
+        while (end - cur >= 16){
+            if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cur))) == 0){
+                cur += 16;
+                continue;
+            }
+            const char_type* stop = cur + 16;
+            while (cur < stop){
+                size_type len = _Utf8Sequence(reinterpret_cast<const unsigned char*>(cur), reinterpret_cast<const unsigned char*>(end));
+                if (len == 0)
+                    return cur;
+                cur += len;
+            }
+        }
+        return _FindInvalidUtf8Scalar(cur, end - cur);
+    }
+#endif
+
+#ifdef OYAJSON_INDEX_AVX2
+    // Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte" (2021). Each byte is checked against
+    // the one before it through three 16 entry lookups: on the high and low nibble of the previous byte, and the high
+    // nibble of this one. Each lookup gives the errors the pair could be part of, one per bit, and only a pair matching
+    // in all three is in error. Third and fourth bytes of a sequence are checked separately, against the lead two and
+    // three bytes before them.
+    static const unsigned char UTF8_TOO_SHORT = 1 << 0;     // A lead byte not followed by a continuation byte.
+    static const unsigned char UTF8_TOO_LONG = 1 << 1;      // A continuation byte after ASCII.
+    static const unsigned char UTF8_OVERLONG_3 = 1 << 2;
+    static const unsigned char UTF8_TOO_LARGE = 1 << 3;     // Past U+10FFFF.
+    static const unsigned char UTF8_SURROGATE = 1 << 4;
+    static const unsigned char UTF8_OVERLONG_2 = 1 << 5;
+    static const unsigned char UTF8_TOO_LARGE_1000 = 1 << 6;
+    static const unsigned char UTF8_OVERLONG_4 = 1 << 6;
+    static const unsigned char UTF8_TWO_CONTS = 1 << 7;     // Two continuation bytes, which is only valid within a longer sequence.
+    static const unsigned char UTF8_CARRY = UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS;
+
+    static const unsigned char UTF8_BYTE_1_HIGH[16] = {
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+        UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+        UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+    };
+    static const unsigned char UTF8_BYTE_1_LOW[16] = {
+        UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+        UTF8_CARRY | UTF8_OVERLONG_2,
+        UTF8_CARRY,
+        UTF8_CARRY,
+        UTF8_CARRY | UTF8_TOO_LARGE,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+    };
+    static const unsigned char UTF8_BYTE_2_HIGH[16] = {
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+    };
+
+    __attribute__((target("avx2")))
+    const char_type* _FindInvalidUtf8Avx2(const char_type* data, size_type size){
+        const __m256i byte1High = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(UTF8_BYTE_1_HIGH)));
+        const __m256i byte1Low = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(UTF8_BYTE_1_LOW)));
+        const __m256i byte2High = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(UTF8_BYTE_2_HIGH)));
+        const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+        const __m256i continuationBit = _mm256_set1_epi8(static_cast<char>(0x80));
+        // Subtracting these (saturated) leaves 0x80 or more only in bytes leading a 3 or 4 byte sequence, respectively.
+        const __m256i thirdByteLead = _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80));
+        const __m256i fourthByteLead = _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80));
+        // Leaves nonzero only in the last 3 bytes, and only where they lead a sequence that can't end within 32 bytes.
+        const __m256i incompleteMax = _mm256_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+
+        __m256i prev = _mm256_setzero_si256();
+        __m256i prevIncomplete = _mm256_setzero_si256();
+        char_type padded[32];
+        for (size_type pos = 0; ; pos += 32){
+            // The final block is padded out with ASCII... even if empty, so a sequence cut short by the end is caught.
+            const bool last = (size - pos < 32);
+            __m256i input;
+            if (!last){
+                input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            } else {
+                std::memset(padded, 0, sizeof(padded));
+                if (size > pos)
+                    std::memcpy(padded, data + pos, size - pos);
+                input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(padded));
+            }
+
+            __m256i error;
+            if (_mm256_movemask_epi8(input) == 0){
+                error = prevIncomplete;
+            } else {
+                __m256i carried = _mm256_permute2x128_si256(prev, input, 0x21);
+                __m256i prev1 = _mm256_alignr_epi8(input, carried, 16 - 1);
+                __m256i prev2 = _mm256_alignr_epi8(input, carried, 16 - 2);
+                __m256i prev3 = _mm256_alignr_epi8(input, carried, 16 - 3);
+
+                __m256i special = _mm256_and_si256(
+                    _mm256_and_si256(_mm256_shuffle_epi8(byte1High, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), lowNibble)),
+                                     _mm256_shuffle_epi8(byte1Low, _mm256_and_si256(prev1, lowNibble))),
+                    _mm256_shuffle_epi8(byte2High, _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibble)));
+                __m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, thirdByteLead), _mm256_subs_epu8(prev3, fourthByteLead));
+                error = _mm256_xor_si256(_mm256_and_si256(must23, continuationBit), special);
+            }
+
+            if (!_mm256_testz_si256(error, error)){
+                // The error may be in a sequence started by the previous block. Backing up to its lead byte, the exact
+                // position is left to the scalar validator.
+                size_type start = pos;
+                for (size_type back = 1; back <= 3 && back <= pos; back++){
+                    unsigned char c = static_cast<unsigned char>(data[pos - back]);
+                    if (c < 0x80)
+                        break;
+                    if (c >= 0xC0){
+                        start = pos - back;
+                        break;
+                    }
+                }
+                return _FindInvalidUtf8Scalar(data + start, size - start);
+            }
+            if (last)
+                return data + size;
+            prevIncomplete = _mm256_subs_epu8(input, incompleteMax);
+            prev = input;
+        }
+    }
+#endif
+
+    struct _Classifier{
+        _ClassifyFunc classify;
+        _FindInvalidUtf8Func findInvalidUtf8;
+        const char* name;
+    };
+
+    _Classifier _SelectClassifier(){
+#ifdef OYAJSON_INDEX_AVX2
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")){
+            _Classifier c = {_ClassifyAvx2, _FindInvalidUtf8Avx2, "avx2"};
+            return c;
+        }
+#endif
+#ifdef OYAJSON_INDEX_SSE2
+        _Classifier c = {_ClassifySse2, _FindInvalidUtf8Sse2, "sse2"};
+#else
+        _Classifier c = {_ClassifyScalar, _FindInvalidUtf8Scalar, "scalar"};
+#endif
+        return c;
+    }
+
+    // The CPU is only checked once.
+    inline const _Classifier& _ActiveClassifier(){
+        static const _Classifier classifier = _SelectClassifier();
+        return classifier;
+    }
+
+    const char_type* JSonFindInvalidUtf8(const char_type* data, size_type size){
+        return _ActiveClassifier().findInvalidUtf8(data, size);
+    }
+
+
+/* --------------------------------------------------------------------------------------------
+ *  JSonStructuralIndex
+ -------------------------------------------------------------------------------------------- */
+
+    JSonStructuralIndex::JSonStructuralIndex() : mData(nullptr), mSize(0), mIndexed(0), mWindow(nullptr), mCount(0), mRead(0),
+                                                 mPrevInString(0), mPrevEscaped(0), mPrevScalar(0){}
+
+    void JSonStructuralIndex::reset(const char_type* data, size_type size){
+        mData = data;
+        mSize = size;
+        mIndexed = 0;
+        mWindow = data;
+        mCount = 0;
+        mRead = 0;
+        mPrevInString = 0;
+        mPrevEscaped = 0;
+        mPrevScalar = 0;
+
+        // A window can't hold more tokens than it has bytes.
+        size_type needed = std::min(INDEX_WINDOW, size + INDEX_BLOCK);
+        if (mPositions.size() < needed)
+            mPositions.resize(needed);
+    }
+
+    const char* JSonStructuralIndex::implementation(){
+        return _ActiveClassifier().name;
+    }
+
+    bool JSonStructuralIndex::_Refill(){
+        const _ClassifyFunc classify = _ActiveClassifier().classify;
+        const std::uint64_t evenBits = 0x5555555555555555ULL;
+        _BlockMasks masks[INDEX_WINDOW / INDEX_BLOCK];
+
+        while (mIndexed < mSize){
+            const char_type* window = mData + mIndexed;
+            size_type len = std::min(mSize - mIndexed, INDEX_WINDOW);
+            size_type blocks = len / INDEX_BLOCK;
+            classify(window, blocks, masks);
+            if (len % INDEX_BLOCK != 0){
+                // The last block is padded out with whitespace, which never makes it into the index.
+                char_type tail[INDEX_BLOCK];
+                std::memset(tail, ' ', INDEX_BLOCK);
+                std::memcpy(tail, window + blocks * INDEX_BLOCK, len % INDEX_BLOCK);
+                classify(tail, 1, masks + blocks);
+                blocks++;
+            }
+
+            // The carries are kept in locals so they can live in registers across the blocks.
+            std::uint64_t prevInString = mPrevInString;
+            std::uint64_t prevEscaped = mPrevEscaped;
+            std::uint64_t prevScalar = mPrevScalar;
+            std::uint32_t* out = mPositions.data();
+            size_type count = 0;
+            for (size_type b = 0; b < blocks; b++){
+                const _BlockMasks &m = masks[b];
+
+                // Finds the characters escaped by a backslash. Runs of backslashes escape every other character, so
+                // the parity of where each run starts decides which characters are escaped. A backslash ending the
+                // previous block escapes the first character of this one.
+                std::uint64_t backslash = m.backslash & ~prevEscaped;
+                std::uint64_t followsEscape = (backslash << 1) | prevEscaped;
+                std::uint64_t oddStarts = backslash & ~evenBits & ~followsEscape;
+                std::uint64_t evenSequences = oddStarts + backslash;
+                prevEscaped = (evenSequences < oddStarts) ? 1 : 0;
+                std::uint64_t escaped = (evenBits ^ (evenSequences << 1)) & followsEscape;
+
+                // Unescaped quotes, and the bytes they enclose (opening quote included, closing quote excluded).
+                std::uint64_t quote = m.quote & ~escaped;
+                std::uint64_t inString = _PrefixXor(quote) ^ prevInString;
+                prevInString = static_cast<std::uint64_t>(static_cast<std::int64_t>(inString) >> 63);
+
+                // Numbers and literals are indexed by their first character only.
+                std::uint64_t scalar = ~(m.op | m.whitespace | quote | inString);
+                std::uint64_t starts = scalar & ~((scalar << 1) | prevScalar);
+                prevScalar = scalar >> 63;
+
+                std::uint64_t tokens = (m.op & ~inString) | quote | starts;
+                std::uint32_t offset = static_cast<std::uint32_t>(b * INDEX_BLOCK);
+                while (tokens != 0){
+                    out[count++] = offset + _TrailingZeros(tokens);
+                    tokens &= tokens - 1;
+                }
+            }
+            mPrevInString = prevInString;
+            mPrevEscaped = prevEscaped;
+            mPrevScalar = prevScalar;
+
+            mWindow = window;
+            mIndexed += len;
+            mCount = count;
+            mRead = 0;
+            if (count > 0)
+                return true;
+        }
+        return false;
+    }
+
+}
+
@@ -0,0 +1,180 @@
+/*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014-2015 Bryan Miller
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "OYAJSon_NDJSon.h"
+#include <cstring>
+
+namespace OYAJSon {
+
+    // Number of records a thread claims from the batch at a time. Keeps the threads from fighting over mNext.
+    static const size_type RECORDS_PER_CLAIM = 32;
+
+    inline bool _IsBlankLine(const char_type* s, const char_type* e){
+        for (; s != e; s++){
+            if (*s != ' ' && *s != '\t' && *s != '\r')
+                return false;
+        }
+        return true;
+    }
+
+
+    NDJSonReader::NDJSonReader(size_type threads, size_type batchSize) : mBatchSize(batchSize > 0 ? batchSize : 1), mGeneration(0), mBusy(0), mQuit(false), mNext(0){
+        if (threads == 0)
+            threads = std::max<size_type>(std::thread::hardware_concurrency(), 1);
+        // The thread calling read() does its share of the parsing, so one less worker is needed.
+        for (size_type i = 1; i < threads; i++)
+            mWorkers.push_back(std::thread(&NDJSonReader::_Work, this));
+    }
+
+    NDJSonReader::~NDJSonReader(){
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mQuit = true;
+        }
+        mWake.notify_all();
+        for (std::vector<std::thread>::iterator i = mWorkers.begin(); i != mWorkers.end(); i++)
+            i->join();
+    }
+
+    size_type NDJSonReader::threads() const{
+        return mWorkers.size() + 1;
+    }
+
+    size_type NDJSonReader::read(const StringView &ndjson, const callback_type &callback){
+        return read(ndjson.data(), ndjson.size(), callback);
+    }
+
+    std::vector<NDJSonRecord> NDJSonReader::read_all(const StringView &ndjson){
+        std::vector<NDJSonRecord> records;
+        read(ndjson, [&records](NDJSonRecord &rec){
+            records.push_back(std::move(rec)); // The record is discarded once the callback returns.
+            return true;
+        });
+        return records;
+    }
+
+    size_type NDJSonReader::read(const char_type* data, size_type size, const callback_type &callback){
+        const char_type* cur = data;
+        const char_type* end = data + size;
+        size_type line = 0;
+        size_type index = 0;
+
+        while (cur != end){
+            // Splitting the next batch of records.
+            mLines.clear();
+            mRecords.clear();
+            while (cur != end && mLines.size() < mBatchSize){
+                const char_type* eol = static_cast<const char_type*>(std::memchr(cur, '\n', end - cur));
+                if (eol == nullptr)
+                    eol = end;
+                line++;
+
+                const char_type* last = eol;
+                if (last != cur && *(last-1) == '\r')
+                    last--;
+                if (!_IsBlankLine(cur, last)){
+                    mLines.push_back(StringView(cur, last - cur));
+                    mRecords.push_back(NDJSonRecord());
+                    mRecords.back().index = index++;
+                    mRecords.back().line = line;
+                }
+                cur = (eol == end) ? end : eol + 1;
+            }
+            if (mLines.empty())
+                break;
+
+            // Parsing the batch... the workers are woken to help, then waited on.
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mNext = 0;
+                mBusy = mWorkers.size();
+                mGeneration++;
+            }
+            mWake.notify_all();
+            _ParseBatch();
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mFinished.wait(lock, [this]{return mBusy == 0;});
+            }
+
+            for (std::vector<NDJSonRecord>::iterator i = mRecords.begin(); i != mRecords.end(); i++){
+                if (!callback(*i)){
+                    mRecords.clear();
+                    return i->index + 1;
+                }
+            }
+        }
+
+        mRecords.clear();
+        return index;
+    }
+
+    void NDJSonReader::_Work(){
+        size_type generation = 0;
+        while (true){
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWake.wait(lock, [this, generation]{return mQuit || mGeneration != generation;});
+                if (mQuit)
+                    return;
+                generation = mGeneration;
+            }
+
+            _ParseBatch();
+
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (--mBusy == 0)
+                    mFinished.notify_one();
+            }
+        }
+    }
+
+    void NDJSonReader::_ParseBatch(){
+        JSonParser parser;
+        JSonValueBuilder builder;
+        size_type count = mLines.size();
+
+        while (true){
+            size_type first = mNext.fetch_add(RECORDS_PER_CLAIM);
+            if (first >= count)
+                return;
+            size_type last = std::min(first + RECORDS_PER_CLAIM, count);
+
+            for (size_type i = first; i < last; i++){
+                NDJSonRecord &rec = mRecords[i];
+                JSonParseResult result = parser.try_parse(mLines[i], builder);
+                rec.error = result.code;
+                if (result){
+                    rec.value = std::move(builder.value());
+                } else {
+                    rec.value = nullptr;
+                    rec.message = std::move(result.message);
+                }
+                builder.reset();
+            }
+        }
+    }
+
+} // End namespace "OYAJSon"
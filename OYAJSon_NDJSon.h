@@ -0,0 +1,141 @@
+#ifndef __OYAJSON_NDJSON_H__
+#define __OYAJSON_NDJSON_H__
+
+/*
+* The MIT License (MIT)
+*
+* Copyright (c) 2014-2015 Bryan Miller
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+/*! Newline delimited JSon (NDJSon) support for the OYAJSon library. */
+
+
+#include "OYAJSon.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+namespace OYAJSon {
+
+    /*! A single record read from an NDJSon string. */
+    struct NDJSonRecord{
+        size_type index;        ///< The record's position within the NDJSon string, starting at 0. Blank lines are not records.
+        size_type line;         ///< The line the record was found on, starting at 1.
+        JSonValue value;        ///< The parsed record. JSonType_Null if the record could not be parsed.
+        unsigned int error;     ///< 0 if the record parsed, otherwise the JSonException::ERR_PARSE_* code of the error found in it.
+        string_type message;    ///< The message of the error found in the record, if any.
+
+        /*! Returns true if the record was parsed without error. */
+        bool ok() const{return error == 0;}
+    };
+
+
+    /*! Reads newline delimited JSon (NDJSon), parsing the records across a pool of worker threads.
+
+        Every non-blank line of an NDJSon string is a record, and each record must be a valid JSon string as accepted by
+        JSonValue::parse(). Lines may end in either "\n" or "\r\n".
+
+        Records are split from the NDJSon string in batches, the batch is parsed in parallel, then each record is handed to
+        the callback __in the order it appears__ in the NDJSon string. Records that fail to parse are handed to the callback
+        as well, with the error filled in, so a bad record never aborts the rest of the batch.
+
+        \code{.cpp}
+            NDJSonReader reader; // One worker per hardware thread.
+            reader.read(buffer, buffer_size, [](NDJSonRecord &rec){
+                if (!rec.ok()){
+                    std::cerr << "Line " << rec.line << ": " << rec.message << std::endl;
+                    return true; // Keep going.
+                }
+                process(rec.value);
+                return true;
+            });
+        \endcode
+
+        The worker threads are started by the constructor and kept for the life of the NDJSonReader, so a single reader
+        should be reused for many NDJSon strings. A NDJSonReader may only be used by one thread at a time.
+    */
+    class NDJSonReader{
+    public:
+        /*! Callback given each record. Return false to stop reading. */
+        typedef std::function<bool(NDJSonRecord&)> callback_type;
+
+        /*! Creates a NDJSonReader.
+            @param threads The total number of threads used to parse records, including the calling thread. 0 [default] uses
+                   one thread per hardware thread.
+            @param batchSize The number of records split and parsed at a time [default: 4096]. Larger batches keep the
+                   workers busier at the cost of holding more parsed records in memory.
+        */
+        explicit NDJSonReader(size_type threads=0, size_type batchSize=4096);
+        ~NDJSonReader();
+
+        /*! Parses every record in the given NDJSon buffer, handing them to the callback in order.
+            @param data Pointer to the start of the NDJSon string. The buffer does not need to be null terminated.
+            @param size The number of characters in the buffer.
+            @param callback Called with each record, in order.
+            @return The number of records handed to the callback.
+        */
+        size_type read(const char_type* data, size_type size, const callback_type &callback);
+
+        /*! Parses every record in the given NDJSon string, handing them to the callback in order.
+            @param ndjson A StringView of the NDJSon string.
+            @param callback Called with each record, in order.
+            @return The number of records handed to the callback.
+        */
+        size_type read(const StringView &ndjson, const callback_type &callback);
+
+        /*! Parses every record in the given NDJSon string.
+            @param ndjson A StringView of the NDJSon string.
+            @return All of the records, in order.
+        */
+        std::vector<NDJSonRecord> read_all(const StringView &ndjson);
+
+        /*! Returns the total number of threads used to parse records, including the calling thread. */
+        size_type threads() const;
+
+    private:
+        NDJSonReader(const NDJSonReader&);
+        NDJSonReader& operator=(const NDJSonReader&);
+
+        size_type mBatchSize;
+        std::vector<std::thread> mWorkers;
+
+        std::mutex mMutex;
+        std::condition_variable mWake;      // Signals the workers a new batch is ready (or it's time to quit).
+        std::condition_variable mFinished;  // Signals the reader every worker is done with the batch.
+        size_type mGeneration;
+        size_type mBusy;
+        bool mQuit;
+
+        std::vector<StringView> mLines;
+        std::vector<NDJSonRecord> mRecords;
+        std::atomic<size_type> mNext;
+
+        void _Work();
+        void _ParseBatch();
+    };
+
+} // End namespace "OYAJSon"
+
+#endif // __OYAJSON_NDJSON_H__
@@ -1,9 +1,18 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <map>
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <thread>
 #include <assert.h>
 #include "../OYAJSon.h"
+#include "../OYAJSon_NDJSon.h"
+#include "../OYAJSon_Frozen.h"
 
 
 std::string load_file(const std::string &src){
@@ -153,6 +162,1744 @@ void Test03_ObjectViaSubscription(){
 }
 
 
+unsigned int parse_error_code(const std::string &src){
+    try{
+        OYAJSon::JSonValue v;
+        v.parse(src);
+    } catch (OYAJSon::JSonException &e){
+        return e.get_code();
+    }
+    return 0;
+}
+
+// Returns the code of the JSonException thrown by the given function, or 0 if nothing was thrown.
+template <typename F> unsigned int error_code(F f){
+    try{
+        f();
+    } catch (OYAJSon::JSonException &e){
+        return e.get_code();
+    }
+    return 0;
+}
+
+
+void Test04_ParseNested(){
+    std::cout << "TEST 04: Parse nested structures and malformed strings." << std::endl;
+    OYAJSon::JSonValue v;
+    v.parse(std::string(" \n\t{ \"a\" : [ 1 , -2.5e2 , { \"b\" : [ [], {} ] } ] ,\r\n"
+                        "\"s\" : \"x, y: {z}\\\" \\\\ \\n\", \"n\" : null, \"t\" : TRUE } "));
+
+    std::cout << "\tTesting nested values ... ";
+    assert(v.size() == 4);
+    assert(v["a"].size() == 3);
+    assert(v["a"][0].get<int>() == 1);
+    assert(v["a"][1].get<double>() == -250.0);
+    assert(v["a"][2]["b"][0].is(OYAJSon::JSonType_Array));
+    assert(v["a"][2]["b"][0].size() == 0);
+    assert(v["a"][2]["b"][1].is(OYAJSon::JSonType_Object));
+    assert(v["n"].is(OYAJSon::JSonType_Null));
+    assert(v["t"].get<bool>());
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting string content and escapes ... ";
+    assert(v["s"].get<std::string>() == "x, y: {z}\" \\ \n");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting malformed strings report the expected error codes ... ";
+    assert(parse_error_code("") == OYAJSon::JSonException::ERR_PARSE_INVALIDJSONCONTAINER);
+    assert(parse_error_code("\"str\"") == OYAJSon::JSonException::ERR_PARSE_INVALIDJSONCONTAINER);
+    assert(parse_error_code("{\"a\":1") == OYAJSon::JSonException::ERR_PARSE_UNCLOSEDSTURCTURE);
+    assert(parse_error_code("[1, 2") == OYAJSon::JSonException::ERR_PARSE_UNCLOSEDSTURCTURE);
+    assert(parse_error_code("[\"abc]") == OYAJSon::JSonException::ERR_PARSE_UNCLOSEDSTURCTURE);
+    assert(parse_error_code("{\"a\" 1}") == OYAJSon::JSonException::ERR_PARSE_MISSINGSYMBOL);
+    assert(parse_error_code("[1 2]") == OYAJSon::JSonException::ERR_PARSE_MISSINGSYMBOL);
+    assert(parse_error_code("[1, 2] x") == OYAJSon::JSonException::ERR_PARSE_INVALIDSYMBOL);
+    assert(parse_error_code("[1, ]") == OYAJSon::JSonException::ERR_PARSE_MISSINGVALUE);
+    assert(parse_error_code("{\"a\":}") == OYAJSon::JSonException::ERR_PARSE_MISSINGVALUE);
+    assert(parse_error_code("[1, bogus]") == OYAJSon::JSonException::ERR_PARSE_UNKNOWNVALUETYPE);
+    assert(parse_error_code("[01]") == OYAJSon::JSonException::ERR_PARSE_UNKNOWNVALUETYPE);
+    assert(parse_error_code("[\"\\q\"]") == OYAJSon::JSonException::ERR_PARSE_MALFORMED);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting a failed parse leaves the value untouched ... ";
+    OYAJSon::JSonValue untouched(5);
+    assert(parse_error_code("[1, 2") != 0);
+    try{ untouched.parse("[1, 2"); } catch (OYAJSon::JSonException&){}
+    assert(untouched.get<int>() == 5);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+void Test05_ParseInPlace(){
+    std::cout << "TEST 05: Parse JSon in place from caller owned buffers." << std::endl;
+
+    // The buffer is deliberately not null terminated, and holds junk after the JSon.
+    const char buffer[] = {'{', '"', 'k', '"', ':', '[', '1', ',', '2', ']', '}', 'X', 'X', 'X'};
+    OYAJSon::JSonValue v;
+
+    std::cout << "\tTesting parse of a pointer and length ... ";
+    v.parse(buffer, 11);
+    assert(v["k"].size() == 2);
+    assert(v["k"][1].get<int>() == 2);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting parse of a StringView ... ";
+    OYAJSon::StringView view(buffer, 11);
+    assert(view == OYAJSon::StringView("{\"k\":[1,2]}"));
+    OYAJSon::JSonValue vv;
+    vv.parse(view);
+    assert(vv["k"].size() == 2);
+    assert(parse_error_code(std::string(buffer, sizeof(buffer))) == OYAJSon::JSonException::ERR_PARSE_INVALIDSYMBOL);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting raw control characters within strings are preserved ... ";
+    v.parse("[\"tab\there\r\nnewline\"]");
+    assert(v[0].get<std::string>() == "tab\there\r\nnewline");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+// Records every event as a short token so the event order can be checked.
+class EventRecorder : public OYAJSon::JSonHandler{
+public:
+    std::string events;
+    bool start_object(){events += "{"; return true;}
+    bool key(const OYAJSon::StringView &key){events += key.str() + ":"; return true;}
+    bool end_object(){events += "}"; return true;}
+    bool start_array(){events += "["; return true;}
+    bool end_array(){events += "]"; return true;}
+    bool string(const OYAJSon::StringView &value){events += "s(" + value.str() + ")"; return true;}
+    bool number_int(long long value){events += "i"; return true;}
+    bool number_double(double value){events += "d"; return true;}
+    bool boolean(bool value){events += value ? "T" : "F"; return true;}
+    bool null(){events += "N"; return true;}
+};
+
+// Extracts a single top level string field, stopping the parser once it is found.
+class FieldExtractor : public OYAJSon::JSonHandler{
+public:
+    FieldExtractor(const char* name) : depth(0), name(name), matched(false){}
+    int depth;
+    OYAJSon::StringView name;
+    bool matched;
+    std::string found;
+    bool start_object(){depth++; return true;}
+    bool end_object(){depth--; return true;}
+    bool key(const OYAJSon::StringView &key){matched = (depth == 1 && key == name); return true;}
+    bool string(const OYAJSon::StringView &value){
+        if (!matched)
+            return true;
+        found = value.str();
+        return false;
+    }
+};
+
+
+void Test06_ParseEvents(){
+    std::cout << "TEST 06: Parse JSon into handler events." << std::endl;
+    std::string src = "{\"a\":[1,2.5,\"x\\ty\",true,false,null],\"b\":{}}";
+    OYAJSon::JSonParser parser;
+
+    std::cout << "\tTesting event order ... ";
+    EventRecorder rec;
+    assert(parser.parse(src, rec));
+    assert(rec.events == "{a:[ids(x\ty)TFN]b:{}}");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting a handler may stop the parser ... ";
+    FieldExtractor fe("id");
+    assert(!parser.parse(OYAJSon::StringView("{\"meta\":{\"id\":\"inner\"},\"id\":\"outer\",\"junk\":[}"), fe));
+    assert(fe.found == "outer");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting the JSonValueBuilder handler ... ";
+    OYAJSon::JSonValueBuilder builder;
+    assert(parser.parse(src, builder));
+    assert(builder.value()["a"].size() == 6);
+    assert(builder.value()["a"][2].get<std::string>() == "x\ty");
+    assert(builder.value()["b"].is(OYAJSon::JSonType_Object));
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+void Test07_PushParser(){
+    std::cout << "TEST 07: Parse JSon handed over in chunks." << std::endl;
+    std::string src = "{\"Key_A\":\"Hel\\\"lo\",\"Key_B\":[true,-12.5e1,123456,null,{\"x\":[]}]}";
+    OYAJSon::JSonValue expected;
+    expected.parse(src);
+
+    std::cout << "\tTesting one character at a time ... ";
+    OYAJSon::JSonValueBuilder builder;
+    OYAJSon::JSonPushParser parser(builder);
+    for (std::string::size_type i = 0; i < src.size(); i++)
+        assert(parser.feed(src.data() + i, 1));
+    assert(parser.finish());
+    assert(builder.value() == expected);
+    assert(builder.value()["Key_A"].get<std::string>() == "Hel\"lo");
+    assert(builder.value()["Key_B"][1].get<double>() == -125.0);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting events match a single pass parse ... ";
+    EventRecorder whole, chunked;
+    OYAJSon::JSonParser().parse(src, whole);
+    OYAJSon::JSonPushParser eventParser(chunked);
+    eventParser.feed(OYAJSon::StringView(src.data(), 14)); // Splits the escape sequence.
+    eventParser.feed(OYAJSon::StringView(src.data() + 14, 22)); // Splits -12.5e1
+    eventParser.feed(OYAJSon::StringView(src.data() + 36, src.size() - 36));
+    assert(eventParser.finish());
+    assert(chunked.events == whole.events);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting an incomplete JSon string is reported by finish() ... ";
+    eventParser.reset();
+    assert(eventParser.feed("[1, [2, ", 8));
+    unsigned int code = 0;
+    try{ eventParser.finish(); } catch (OYAJSon::JSonException &e){ code = e.get_code(); }
+    assert(code == OYAJSon::JSonException::ERR_PARSE_UNCLOSEDSTURCTURE);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting a JSon string ending in a scalar fails as a single pass parse does ... ";
+    const char* truncated[] = {"{\"r\":truex", "[tru", "[-", "[1.5e", "[12", "{\"r\":null"};
+    for (const char* s : truncated){
+        EventRecorder single, pushed;
+        unsigned int expectedCode = 0;
+        try{ OYAJSon::JSonParser().parse(s, std::strlen(s), single); } catch (OYAJSon::JSonException &e){ expectedCode = e.get_code(); }
+        OYAJSon::JSonPushParser truncatedParser(pushed);
+        assert(truncatedParser.feed(s, std::strlen(s)));
+        code = 0;
+        try{ truncatedParser.finish(); } catch (OYAJSon::JSonException &e){ code = e.get_code(); }
+        assert(expectedCode != 0 && code == expectedCode);
+        assert(pushed.events == single.events);
+    }
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+void Test08_NDJSonReader(){
+    std::cout << "TEST 08: Read newline delimited JSon." << std::endl;
+    std::string src;
+    for (int i = 0; i < 200; i++){
+        if (i == 57)
+            src += "{\"id\": 57, \"broken\": [}\n";
+        else
+            src += "{\"id\": " + std::to_string(i) + ", \"tags\": [\"a\", \"b\"]}\r\n";
+        if (i % 50 == 0)
+            src += "   \n"; // Blank lines are not records.
+    }
+
+    std::cout << "\tTesting records are given in order ... ";
+    OYAJSon::NDJSonReader reader(4, 16);
+    assert(reader.threads() == 4);
+    int expected = 0;
+    OYAJSon::size_type lastLine = 0;
+    OYAJSon::size_type count = reader.read(src, [&](OYAJSon::NDJSonRecord &rec){
+        assert(rec.index == static_cast<OYAJSon::size_type>(expected));
+        assert(rec.line > lastLine);
+        lastLine = rec.line;
+        if (expected == 57){
+            assert(!rec.ok());
+            assert(rec.error != 0);
+            assert(rec.line == 60);
+        } else {
+            assert(rec.ok());
+            assert(rec.value["id"].get<int>() == expected);
+        }
+        expected++;
+        return true;
+    });
+    assert(count == 200);
+    assert(expected == 200);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting the callback may stop the reader ... ";
+    count = reader.read(src, [](OYAJSon::NDJSonRecord &rec){return rec.index < 20;});
+    assert(count == 21);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting read_all ... ";
+    std::vector<OYAJSon::NDJSonRecord> records = reader.read_all("[1]\n[2]\n[3]");
+    assert(records.size() == 3);
+    assert(records[2].value[0].get<int>() == 3);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+void Test09_ParseFile(){
+    std::cout << "TEST 09: Parse JSon straight from a file." << std::endl;
+    const std::string path = "oyajson_test09.json";
+    {
+        std::ofstream f(path);
+        f << "{\"name\": \"mapped\", \"values\": [1, 2, 3]}\n";
+    }
+
+    std::cout << "\tTesting a mapped file exposes the file contents ... ";
+    {
+        OYAJSon::JSonMappedFile file(path);
+        assert(file.is_open());
+        assert(file.view() == OYAJSon::StringView(load_file(path)));
+    }
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting parse_file ... ";
+    OYAJSon::JSonValue v;
+    v.parse_file(path);
+    assert(v["name"].get<std::string>() == "mapped");
+    assert(v["values"][2].get<int>() == 3);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting an empty file is reported as invalid JSon ... ";
+    {
+        std::ofstream f(path, std::ios::trunc);
+    }
+    unsigned int code = 0;
+    try{ v.parse_file(path); } catch (OYAJSon::JSonException &e){ code = e.get_code(); }
+    assert(code == OYAJSon::JSonException::ERR_PARSE_INVALIDJSONCONTAINER);
+    assert(v["name"].get<std::string>() == "mapped");
+    std::remove(path.c_str());
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting a missing file throws ... ";
+    code = 0;
+    try{ v.parse_file(path); } catch (OYAJSon::JSonException &e){ code = e.get_code(); }
+    assert(code == OYAJSon::JSonException::ERR_FILE_UNREADABLE);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+// Finds the tokens of a JSon string one character at a time, as JSonStructuralIndex should.
+std::vector<std::size_t> naive_tokens(const std::string &src){
+    std::vector<std::size_t> tokens;
+    bool inString = false, escaped = false, inScalar = false;
+    for (std::size_t i = 0; i < src.size(); i++){
+        char c = src[i];
+        if (inString){
+            if (escaped)
+                escaped = false;
+            else if (c == '\\')
+                escaped = true;
+            else if (c == '"'){
+                inString = false;
+                tokens.push_back(i);
+            }
+            continue;
+        }
+        bool scalar = false;
+        switch(c){
+        case '"': inString = true; tokens.push_back(i); break;
+        case '{': case '}': case '[': case ']': case ',': case ':': tokens.push_back(i); break;
+        case ' ': case '\t': case '\n': case '\r': break;
+        default:
+            scalar = true;
+            if (!inScalar)
+                tokens.push_back(i);
+        }
+        inScalar = scalar;
+    }
+    return tokens;
+}
+
+void Test10_StructuralIndex(){
+    std::cout << "TEST 10: Index the structure of JSon strings." << std::endl;
+    std::cout << "\tIndexing with " << OYAJSon::JSonStructuralIndex::implementation() << std::endl;
+
+    std::cout << "\tTesting the index of a small JSon string ... ";
+    std::string src = "{\"a\\\"b\": [1, -2.5e3, true], \"c\":null}";
+    OYAJSon::JSonStructuralIndex index;
+    index.reset(src.data(), src.size());
+    std::string tokens;
+    for (const char* tok = index.next(); tok != nullptr; tok = index.next())
+        tokens += *tok;
+    assert(tokens == "{\"\":[1,-,t],\"\":n}");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting escapes and strings across block boundaries ... ";
+    for (std::size_t pad = 0; pad < 140; pad += 3){
+        for (int slashes = 0; slashes < 6; slashes++){
+            std::string s = std::string(pad, ' ') + "[\"" + std::string(pad % 70, 'x') + std::string(slashes, '\\');
+            if (slashes % 2 == 1)
+                s += "\"";
+            s += "\", 12, \"" + std::string(slashes * 13, '\\') + "\", {\"k\": false}]";
+            std::vector<std::size_t> expected = naive_tokens(s);
+
+            index.reset(s.data(), s.size());
+            std::vector<std::size_t> found;
+            for (const char* tok = index.next(); tok != nullptr; tok = index.next())
+                found.push_back(tok - s.data());
+            assert(found == expected);
+        }
+    }
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting a large JSon string indexed over several windows ... ";
+    src = "[";
+    for (int i = 0; i < 5000; i++)
+        src += "{\"id\": " + std::to_string(i) + ", \"text\": \"line\\n\\\\ \\\"quoted\\\"\"},\n";
+    src += "\"tail\"]";
+    index.reset(src.data(), src.size());
+    std::vector<std::size_t> found;
+    for (const char* tok = index.next(); tok != nullptr; tok = index.next())
+        found.push_back(tok - src.data());
+    assert(found == naive_tokens(src));
+
+    OYAJSon::JSonValue v;
+    v.parse(src);
+    assert(v.size() == 5001);
+    assert(v[4999]["text"].get<std::string>() == "line\n\\ \"quoted\"");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+void Test11_ParseNumbers(){
+    std::cout << "TEST 11: Parse numbers." << std::endl;
+
+    std::cout << "\tTesting integers stay integers up to the limits of a long long ... ";
+    EventRecorder rec;
+    OYAJSon::JSonParser parser;
+    std::string src = "[0, -0, 42, -9223372036854775808, 9223372036854775807, 9223372036854775808, 123456789012345678901234]";
+    parser.parse(src, rec);
+    assert(rec.events == "[idiiidd]");
+
+    OYAJSon::JSonValue v;
+    v.parse(src);
+    assert(v[3].get<long long>() == std::numeric_limits<long long>::min());
+    assert(v[4].get<long long>() == std::numeric_limits<long long>::max());
+    assert(v[5].get<double>() == 9223372036854775808.0);
+    assert(v[6].get<double>() == 1.2345678901234568e23);
+    assert(v[1].get<double>() == 0.0 && std::signbit(v[1].get<double>()));
+    assert(OYAJSon::JSonValue().parse("[-0,0]").to_str() == "[-0.0,0]");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting numbers beyond the range of a double are rejected ... ";
+    const char* outOfRange[] = {"[1e400]", "[-1e309]", "[179769313486231590000e289]", "{\"a\":[1, 2e99999999]}"};
+    for (const char* s : outOfRange){
+        assert(parse_error_code(s) == OYAJSon::JSonException::ERR_PARSE_NUMBEROUTOFRANGE);
+        OYAJSon::JSonTape tape;
+        std::string source = s;
+        assert(error_code([&](){ tape.parse(source).root().to_value(); }) == OYAJSon::JSonException::ERR_PARSE_NUMBEROUTOFRANGE);
+    }
+    v.parse("[1.7976931348623157e308, -1.7976931348623157e308, 1e-400, -1e-400]");
+    assert(v[0].get<double>() == std::numeric_limits<double>::max() && v[1].get<double>() == -std::numeric_limits<double>::max());
+    assert(v[2].get<double>() == 0.0 && v[3].get<double>() == 0.0 && std::signbit(v[3].get<double>()));
+    assert(OYAJSon::JSonValue().parse(v.to_str()) == v);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting doubles are the closest to their decimal value ... ";
+    v.parse("[0.1, -2.5e-3, 1E+2, 0.30000000000000004, 2.2250738585072014e-308, 4.9406564584124654e-324, "
+            "1.7976931348623157e308, 9007199254740993, 1.00000000000000011102230246251565404236316680908203125, 1e-400]");
+    assert(v[0].get<double>() == 0.1);
+    assert(v[1].get<double>() == -0.0025);
+    assert(v[2].get<double>() == 100.0);
+    assert(v[3].get<double>() == 0.1 + 0.2);
+    assert(v[4].get<double>() == std::numeric_limits<double>::min());
+    assert(v[5].get<double>() == std::numeric_limits<double>::denorm_min());
+    assert(v[6].get<double>() == std::numeric_limits<double>::max());
+    assert(v[7].get<long long>() == 9007199254740993LL);
+    assert(v[8].get<double>() == 1.0); // Exactly half way, so rounds to even.
+    assert(v[9].get<double>() == 0.0);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting numbers are checked against the JSon grammar ... ";
+    const char* invalid[] = {"[01]", "[1.]", "[.5]", "[-]", "[1e]", "[1e+]", "[+1]", "[0x10]", "[1.5.2]", "[--1]", "[1-2]"};
+    for (std::size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+        assert(parse_error_code(invalid[i]) == OYAJSon::JSonException::ERR_PARSE_UNKNOWNVALUETYPE);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+void Test12_SerializeNumbers(){
+    std::cout << "TEST 12: Serialize numbers." << std::endl;
+
+    std::cout << "\tTesting integers ... ";
+    assert(OYAJSon::JSonValue(0).serialize("") == "0");
+    assert(OYAJSon::JSonValue(-42).serialize("") == "-42");
+    assert(OYAJSon::JSonValue(std::numeric_limits<long long>::min()).serialize("") == "-9223372036854775808");
+    assert(OYAJSon::JSonValue(std::numeric_limits<long long>::max()).serialize("") == "9223372036854775807");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting doubles are written with the fewest digits ... ";
+    assert(OYAJSon::JSonValue(0.1).serialize("") == "0.1");
+    assert(OYAJSon::JSonValue(0.1 + 0.2).serialize("") == "0.30000000000000004");
+    assert(OYAJSon::JSonValue(-1.5).serialize("") == "-1.5");
+    assert(OYAJSon::JSonValue(100.0).serialize("") == "100.0");
+    assert(OYAJSon::JSonValue(0.0001).serialize("") == "0.0001");
+    assert(OYAJSon::JSonValue(1e-5).serialize("") == "1e-5");
+    assert(OYAJSon::JSonValue(1e21).serialize("") == "1e21");
+    assert(OYAJSon::JSonValue(std::numeric_limits<double>::max()).serialize("") == "1.7976931348623157e308");
+    assert(OYAJSon::JSonValue(std::numeric_limits<double>::denorm_min()).serialize("") == "5e-324");
+    assert(OYAJSon::JSonValue(-0.0).serialize("") == "-0.0");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting NaN and infinity are written as null ... ";
+    assert(OYAJSon::JSonValue(std::numeric_limits<double>::quiet_NaN()).serialize("") == "null");
+    assert(OYAJSon::JSonValue(-std::numeric_limits<double>::infinity()).serialize("") == "null");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting doubles survive a round trip through parse() ... ";
+    OYAJSon::JSonValue arr(OYAJSon::JSonType_Array);
+    double d = 1.0 / 3.0;
+    for (int i = 0; i < 2000; i++){
+        OYAJSon::JSonValue n(d);
+        arr.push_back(n);
+        d *= -1.7;
+        if (i % 400 == 0)
+            d = 1e-300 / (i + 1);
+    }
+    OYAJSon::JSonValue back;
+    back.parse(arr.serialize(""));
+    for (OYAJSon::size_type i = 0; i < arr.size(); i++)
+        assert(back[i].get<double>() == arr[i].get<double>());
+    assert(back.serialize("") == arr.serialize(""));
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+void Test13_Writer(){
+    std::cout << "TEST 13: Write JSon into sinks." << std::endl;
+    OYAJSon::JSonValue v;
+    v.parse("{\"name\": \"writer\", \"list\": [1, 2.5, true, null, {}, []], \"nested\": {\"a\\\"b\": \"x/y\\n\"}}");
+
+    std::cout << "\tTesting output matches serialize() ... ";
+    std::string compact, pretty;
+    {
+        OYAJSon::JSonStringSink sink(compact);
+        OYAJSon::JSonWriter writer(sink);
+        writer.write(v);
+        writer.flush();
+    }
+    {
+        OYAJSon::JSonStringSink sink(pretty);
+        OYAJSon::JSonWriter writer(sink, "  ");
+        writer.write(v);
+    } // The destructor flushes.
+    assert(compact == v.serialize(""));
+    assert(pretty == v.serialize("  "));
+    assert(compact.find("\"a\\\"b\" : \"x\\/y\\n\"") != std::string::npos);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting the writer as a JSonHandler ... ";
+    std::string reformatted;
+    {
+        OYAJSon::JSonStringSink sink(reformatted);
+        OYAJSon::JSonWriter writer(sink, "  ");
+        OYAJSon::JSonParser parser;
+        parser.parse(compact, writer);
+        writer.flush();
+    }
+    assert(reformatted == pretty);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting large values spanning many buffers ... ";
+    OYAJSon::JSonValue big(OYAJSon::JSonType_Array);
+    for (int i = 0; i < 20000; i++){
+        OYAJSon::JSonValue item(OYAJSon::Object{{"id", i}, {"text", std::string(i % 97, 'z')}});
+        big.push_back(item);
+    }
+    std::ostringstream stream;
+    {
+        OYAJSon::JSonStreamSink sink(stream);
+        OYAJSon::JSonWriter writer(sink, "\t");
+        writer.write(big).flush();
+    }
+    assert(stream.str() == big.serialize("\t"));
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting a file descriptor sink ... ";
+    std::FILE* file = std::tmpfile();
+    assert(file != nullptr);
+    {
+        OYAJSon::JSonFdSink sink(fileno(file));
+        OYAJSon::JSonWriter writer(sink);
+        writer.write(big).flush();
+    }
+    std::rewind(file);
+    std::string fromFile;
+    char buffer[4096];
+    std::size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+        fromFile.append(buffer, read);
+    std::fclose(file);
+    assert(fromFile == big.serialize(""));
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting a failing sink throws ... ";
+    std::ostringstream broken;
+    broken.setstate(std::ios::badbit);
+    unsigned int code = 0;
+    try{
+        OYAJSon::JSonStreamSink sink(broken);
+        OYAJSon::JSonWriter writer(sink);
+        writer.write(v).flush();
+    } catch (OYAJSon::JSonException &e){ code = e.get_code(); }
+    assert(code == OYAJSon::JSonException::ERR_WRITE_FAILED);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+void Test14_ValueLayout(){
+    std::cout << "TEST 14: Compact JSonValue layout, copies and shares." << std::endl;
+
+    std::cout << "\tTesting JSonValue is 16 bytes ... ";
+    assert(sizeof(OYAJSon::JSonValue) == 16);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting copies are deep ... ";
+    OYAJSon::JSonValue a;
+    a.parse("{\"list\": [1, \"two\", {\"three\": 3}], \"name\": \"a\"}");
+    OYAJSon::JSonValue b = a;
+    b["list"][2]["three"] = 30;
+    b["name"] = std::string("b");
+    assert(a["list"][2]["three"].get<int>() == 3);
+    assert(a["name"].get<std::string>() == "a");
+    OYAJSon::JSonValue c;
+    c = a;
+    assert(c == a);
+    c["list"].get_array().clear();
+    assert(a["list"].size() == 3);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting numbers compare by value ... ";
+    assert(OYAJSon::JSonValue(-1) == OYAJSon::JSonValue(-1));
+    assert(OYAJSon::JSonValue(-1) != OYAJSon::JSonValue(1));
+    assert(OYAJSon::JSonValue(1) == OYAJSon::JSonValue(1.0));
+    assert(OYAJSon::JSonValue(-2.5) != OYAJSon::JSonValue(-2));
+    OYAJSon::JSonValue numbers, same;
+    numbers.parse("{\"list\": [-1, 1, 2.5, -9223372036854775807], \"n\": -42}");
+    same.parse("{\"n\": -42.0, \"list\": [-1.0, 1, 2.5, -9223372036854775807]}");
+    OYAJSon::JSonValue numbersCopy = numbers;
+    assert(numbers == numbersCopy && numbers == same);
+    assert(numbers.get_object() == same.get_object());
+    same["list"][3] = -9223372036854775806LL;
+    assert(numbers != same);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting share() aliases Arrays and Objects ... ";
+    OYAJSon::JSonValue shared = a.share();
+    shared["added"] = true;
+    assert(a.has_key("added"));
+    OYAJSon::JSonValue list = a["list"].share();
+    OYAJSon::JSonValue four(4);
+    list.push_back(four);
+    assert(a["list"].size() == 4);
+    OYAJSon::JSonValue copied = shared; // Copying a shared value does not share.
+    copied["only_copy"] = 1;
+    assert(!a.has_key("only_copy"));
+    a = nullptr; // The Object lives on while shared holds it.
+    assert(shared["list"].size() == 4 && list.size() == 4);
+    OYAJSon::JSonValue str(std::string("text"));
+    OYAJSon::JSonValue strShare = str.share();
+    strShare = std::string("changed");
+    assert(str.get<std::string>() == "text");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting moves leave the source null ... ";
+    OYAJSon::JSonValue moved(std::move(shared));
+    assert(shared.is(OYAJSon::JSonType_Null));
+    assert(moved.has_key("added"));
+    OYAJSon::JSonValue inner;
+    inner = std::move(moved["list"]);
+    assert(inner.size() == 4 && moved["list"].is(OYAJSon::JSonType_Null));
+    moved = std::move(moved["name"]); // Moving a value out of the Object being replaced.
+    assert(moved.get<std::string>() == "a");
+    OYAJSon::JSonValue nested(OYAJSon::JSonType_Array);
+    nested.push_back(inner);
+    nested = nested[0]; // Copying a value out of the Array being replaced.
+    assert(nested.size() == 4 && nested[1].get<std::string>() == "two");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+// JSonMemoryResource counting the memory it hands out from the heap.
+class CountingResource : public OYAJSon::JSonMemoryResource{
+public:
+    CountingResource() : allocations(0), outstanding(0){}
+    std::size_t allocations;
+    std::size_t outstanding;
+protected:
+    void* do_allocate(std::size_t size, std::size_t alignment){
+        allocations++;
+        outstanding += size;
+        return ::operator new(size);
+    }
+    void do_deallocate(void* p, std::size_t size, std::size_t alignment){
+        outstanding -= size;
+        ::operator delete(p);
+    }
+};
+
+void Test15_Document(){
+    std::cout << "TEST 15: Arena backed JSonDocument." << std::endl;
+    const char* json = "{\"name\": \"document\", \"list\": [1, 2.5, \"three\", [true, null]], "
+                       "\"nested\": {\"a\": {\"b\": \"c\"}}, \"name\": \"last wins\"}";
+    OYAJSon::JSonValue expected;
+    expected.parse(json);
+
+    std::cout << "\tTesting the document matches JSonValue::parse() ... ";
+    OYAJSon::JSonDocument doc;
+    doc.parse(json);
+    const OYAJSon::JSonValue& root = doc.root();
+    assert(root == expected);
+    assert(root.serialize("") == expected.serialize(""));
+    assert(root["name"].get<std::string>() == "last wins");
+    assert(root["list"][3][0].get<bool>());
+    assert(root.at("nested").at("a").at("b").get<std::string>() == "c");
+    assert(doc.arena().used() > 0 && doc.arena().blocks() == 1);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting const access never inserts ... ";
+    assert(error_code([&root](){root["missing"];}) == OYAJSon::JSonException::ERR_MISSINGKEY);
+    assert(error_code([&root](){root["list"][10];}) == OYAJSon::JSonException::ERR_INDEXOUTOFBOUNDS);
+    assert(!root.has_key("missing"));
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting values copied out outlive the document ... ";
+    OYAJSon::JSonValue copied = doc.root()["nested"];
+    doc.clear();
+    assert(doc.root().is(OYAJSon::JSonType_Null) && doc.arena().blocks() == 0);
+    assert(copied["a"]["b"].get<std::string>() == "c");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting changes made through mutable_root() ... ";
+    doc.parse(json);
+    doc.mutable_root()["added"] = std::string("a string long enough to live on the heap");
+    doc.mutable_root()["list"].get_array().push_back(copied);
+    assert(doc.root()["list"][4]["a"]["b"].get<std::string>() == "c");
+    doc.parse("{\"a key long enough to live on the heap itself\": [\"x\"]}"); // Replaces the changed tree.
+    assert(doc.root().has_key("a key long enough to live on the heap itself"));
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting a failed parse leaves the document empty ... ";
+    assert(error_code([&doc](){doc.parse("{\"a\": [1, 2");}) != 0);
+    assert(doc.root().is(OYAJSon::JSonType_Null) && doc.arena().used() == 0);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting the builder allocates from the given resource ... ";
+    CountingResource counter;
+    {
+        OYAJSon::JSonValueBuilder builder(&counter);
+        OYAJSon::JSonParser parser;
+        parser.parse(json, builder);
+        assert(builder.value() == expected);
+        assert(counter.allocations > 0 && counter.outstanding > 0);
+        OYAJSon::JSonValue independent = builder.value(); // Copies come from the heap.
+        builder.reset();
+        assert(counter.outstanding == 0);
+        assert(independent == expected);
+    }
+    OYAJSon::Array arr((OYAJSon::JSonAllocator<OYAJSon::JSonValue>(&counter)));
+    arr.push_back(OYAJSon::JSonValue(1));
+    assert(counter.outstanding > 0 && arr.get_allocator().resource() == &counter);
+    arr = OYAJSon::Array();
+    arr.shrink_to_fit();
+    assert(counter.outstanding == 0);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting arena blocks ... ";
+    OYAJSon::JSonArena arena(1024);
+    void* small = arena.allocate(10, 1);
+    void* aligned = arena.allocate(24, 16);
+    assert(reinterpret_cast<std::uintptr_t>(aligned) % 16 == 0 && small != aligned);
+    arena.allocate(100000); // Too big to share a block.
+    arena.allocate(10);
+    assert(arena.blocks() == 2 && arena.used() == 10 + 24 + 100000 + 10);
+    arena.release();
+    assert(arena.blocks() == 0 && arena.capacity() == 0);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+// Stateful standard allocator counting the bytes it has outstanding.
+template <typename T> struct CountingAllocator{
+    typedef T value_type;
+    std::size_t* live;
+
+    explicit CountingAllocator(std::size_t* l) : live(l){}
+    template <typename U> CountingAllocator(const CountingAllocator<U>& other) : live(other.live){}
+
+    T* allocate(std::size_t n){
+        *live += n * sizeof(T);
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, std::size_t n){
+        *live -= n * sizeof(T);
+        ::operator delete(p);
+    }
+    template <typename U> bool operator==(const CountingAllocator<U>& rhs) const{return live == rhs.live;}
+    template <typename U> bool operator!=(const CountingAllocator<U>& rhs) const{return live != rhs.live;}
+};
+
+void Test16_AllocatorResource(){
+    std::cout << "TEST 16: Values allocated through a standard allocator." << std::endl;
+    typedef OYAJSon::JSonAllocatorResource<CountingAllocator<char> > CountingResource;
+    const char* json = "{\"list\": [1, \"two\", {\"three\": [3]}], \"name\": \"allocated\"}";
+    OYAJSon::JSonValue expected;
+    expected.parse(json);
+
+    std::size_t live = 0;
+    CountingResource resource((CountingAllocator<char>(&live)));
+
+    std::cout << "\tTesting a document allocates its arena through the allocator ... ";
+    {
+        OYAJSon::JSonDocument doc(1024, &resource);
+        doc.parse(json);
+        assert(doc.root() == expected);
+        assert(live >= 1024);
+        doc.clear();
+        assert(live == 0);
+        doc.parse(json);
+    }
+    assert(live == 0);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting copies into a resource are allocated from it all the way down ... ";
+    {
+        OYAJSon::JSonValue v(expected, &resource);
+        assert(v == expected);
+        std::size_t copied = live;
+        assert(copied > 0);
+
+        OYAJSon::JSonValue onHeap = v; // Copies not given a resource come from the heap.
+        assert(onHeap == expected && live == copied);
+
+        OYAJSon::JSonValue element(std::string("follows the array"));
+        v["list"][2]["three"].get_array().push_back(element);
+        assert(live > copied);
+        v["list"][2]["three"].get_array().pop_back();
+        v["list"][2]["three"].get_array().shrink_to_fit();
+        v.insert("inserted", element);
+        assert(v["inserted"].get<std::string>() == "follows the array");
+
+        OYAJSon::JSonValue arr(OYAJSon::JSonType_Array, &resource);
+        arr.push_back(v);
+        assert(arr[0] == v);
+    }
+    assert(live == 0);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting resources compare by allocator ... ";
+    std::size_t other = 0;
+    CountingResource same((CountingAllocator<char>(&live)));
+    CountingResource different((CountingAllocator<char>(&other)));
+    assert(resource.is_equal(same) && !resource.is_equal(different));
+    assert(!resource.is_equal(*OYAJSon::JSonHeapResource()));
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+void Test17_ObjectMembers(){
+    std::cout << "TEST 17: Object members kept flat, in insertion order." << std::endl;
+
+    std::cout << "\tTesting members keep the order they were parsed and written in ... ";
+    const char* json = "{\"zebra\" : 1,\"apple\" : 2,\"mango\" : {\"b\" : true,\"a\" : null}}";
+    OYAJSon::JSonValue v;
+    v.parse(json);
+    assert(v.to_str() == json);
+    const OYAJSon::Object& obj = v.get_object();
+    OYAJSon::Object::const_iterator i = obj.begin();
+    assert(i->first == "zebra" && (i + 1)->first == std::string("apple") && (i + 2)->first.str() == "mango");
+    v["banana"] = 3;
+    assert(v.to_str() == "{\"zebra\" : 1,\"apple\" : 2,\"mango\" : {\"b\" : true,\"a\" : null},\"banana\" : 3}");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting repeated keys keep their first position and last value ... ";
+    v.parse("{\"a\":1,\"b\":2,\"a\":3}");
+    assert(v.size() == 2 && v["a"].get<int>() == 3);
+    assert(v.get_object().begin()->first == "a");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting lookups in Objects small and large ... ";
+    for (int count = 1; count <= 200; count += 13){
+        OYAJSon::JSonValue big(OYAJSon::JSonType_Object);
+        for (int k = 0; k < count; k++)
+            big["key" + std::to_string(k)] = k;
+        assert(big.size() == (std::size_t)count);
+        for (int k = 0; k < count; k++)
+            assert(big.at("key" + std::to_string(k)).get<int>() == k);
+        assert(!big.has_key("key" + std::to_string(count)) && !big.has_key(""));
+
+        // Erasing keeps the order of the remaining members, and every one of them can still be found.
+        OYAJSon::Object& members = big.get_object();
+        for (int k = 0; k < count; k += 3)
+            assert(members.erase("key" + std::to_string(k)) == 1);
+        int expect = 1;
+        for (OYAJSon::Object::iterator m = members.begin(); m != members.end(); m++, expect += (expect % 3 == 1) ? 1 : 2)
+            assert(m->second.get<int>() == expect && members.find(m->first) == m);
+        for (int k = 0; k < count; k++)
+            assert(members.count("key" + std::to_string(k)) == (k % 3 == 0 ? 0u : 1u));
+    }
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting Objects compare equal whatever the order of their members ... ";
+    OYAJSon::JSonValue left, right;
+    left.parse("{\"a\":1,\"b\":[1,2],\"c\":\"three\"}");
+    right.parse("{\"c\":\"three\",\"a\":1,\"b\":[1,2]}");
+    assert(left == right);
+    right["b"].get_array().push_back(left["a"]);
+    assert(left != right);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting keys are copied with their Object, wherever it's allocated ... ";
+    std::string longKey(100, 'k');
+    CountingResource counter;
+    {
+        OYAJSon::JSonValue heap(OYAJSon::JSonType_Object);
+        heap[longKey] = 1;
+        heap["short"] = 2;
+        OYAJSon::JSonValue copy(heap, &counter);
+        assert(counter.outstanding > 0 && copy == heap);
+        OYAJSon::JSonDocument doc;
+        doc.parse(heap.to_str());
+        assert(doc.root()[longKey].get<int>() == 1 && doc.root() == heap);
+    }
+    assert(counter.outstanding == 0);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+void Test18_KeyPool(){
+    std::cout << "TEST 18: Interning Object keys." << std::endl;
+
+    std::cout << "\tTesting a pool keeps one copy of each key ... ";
+    {
+        OYAJSon::JSonKeyPool pool;
+        OYAJSon::JSonKey a = pool.intern("name");
+        OYAJSon::JSonKey b = pool.intern(std::string("name"));
+        OYAJSon::JSonKey c = pool.intern("");
+        assert(a.data() == b.data() && a == b && a == "name" && c.empty());
+        assert(pool.size() == 2);
+        for (int i = 0; i < 1000; i++)
+            pool.intern("key" + std::to_string(i % 100));
+        assert(pool.size() == 102);
+        OYAJSon::JSonKey copy(a); // Copies own their characters.
+        assert(copy == a && copy.data() != a.data());
+    }
+    std::cout << "Success!" << std::endl;
+
+    std::string json = "[";
+    for (int i = 0; i < 100; i++)
+        json += (i ? "," : "") + std::string("{\"id\":") + std::to_string(i) + ",\"type\":\"event\",\"id\":" + std::to_string(i * 2) + "}";
+    json += "]";
+
+    std::cout << "\tTesting records built with a pool share their keys ... ";
+    OYAJSon::JSonValue copy;
+    {
+        OYAJSon::JSonKeyPool pool;
+        OYAJSon::JSonValueBuilder builder(nullptr, &pool);
+        OYAJSon::JSonParser parser;
+        parser.parse(json, builder);
+        OYAJSon::JSonValue records = std::move(builder.value());
+        assert(pool.size() == 2);
+
+        OYAJSon::JSonKey id = pool.intern("id");
+        for (OYAJSon::size_type i = 0; i < records.size(); i++){
+            const OYAJSon::Object& record = records[i].get_object();
+            assert(record.size() == 2 && record.begin()->first.data() == id.data());
+            assert(record.find(id)->second.get<int>() == (int)i * 2);
+            assert(record.find(std::string("type"))->first.data() == records[0].get_object().find("type")->first.data());
+        }
+        copy = records;
+        assert(copy[0].get_object().begin()->first.data() != id.data());
+    }
+    assert(copy.size() == 100 && copy[99]["id"].get<int>() == 198);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting a document interning its keys ... ";
+    OYAJSon::JSonDocument plain;
+    OYAJSon::JSonDocument interned(OYAJSon::JSonArena::DEFAULT_BLOCK_SIZE, nullptr, true);
+    plain.parse(json);
+    interned.parse(json);
+    assert(interned.root() == plain.root() && interned.root() == copy);
+    assert(interned.arena().used() < plain.arena().used());
+    OYAJSon::JSonKey type = interned.key_pool().intern("type");
+    assert(interned.key_pool().size() == 2);
+    assert(interned.root()[50].get_object().find(type)->second.get<std::string>() == "event");
+    interned.clear();
+    assert(interned.key_pool().size() == 0);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+void Test19_MoveSemantics(){
+    std::cout << "TEST 19: Building values by moving them." << std::endl;
+
+    std::cout << "\tTesting Arrays and Objects are taken over, not copied ... ";
+    OYAJSon::Array elements;
+    for (int i = 0; i < 100; i++)
+        elements.push_back(i);
+    const OYAJSon::JSonValue* first = &elements[0];
+    OYAJSon::JSonValue arr(std::move(elements));
+    assert(elements.empty() && arr.size() == 100 && &arr[0] == first);
+
+    OYAJSon::Object members;
+    members["list"] = arr;
+    const OYAJSon::JSonValue* list = &members["list"];
+    OYAJSon::JSonValue obj;
+    obj = std::move(members);
+    assert(members.empty() && &obj["list"] == list);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting insert, push_back and set take over rvalues ... ";
+    OYAJSon::JSonValue root(OYAJSon::JSonType_Object);
+    root.insert("numbers", std::move(arr));
+    const OYAJSon::JSonValue& numbers = root["numbers"];
+    assert(arr.is(OYAJSon::JSonType_Null) && &numbers[0] == first);
+
+    OYAJSon::JSonValue outer(OYAJSon::JSonType_Array);
+    outer.push_back(std::move(obj));
+    assert(obj.is(OYAJSon::JSonType_Null) && &outer[0]["list"] == list);
+    OYAJSon::JSonValue inner(std::string("inner"));
+    outer.insert(0, std::move(inner));
+    outer.insert(outer.get_array().begin(), OYAJSon::JSonValue(true));
+    assert(outer.size() == 3 && outer[0].get<bool>() && outer[1].get<std::string>() == "inner" && &outer[2]["list"] == list);
+
+    OYAJSon::JSonValue replaced;
+    replaced.set(std::move(outer));
+    assert(outer.is(OYAJSon::JSonType_Null) && &replaced[2]["list"] == list);
+
+    OYAJSon::JSonValue copy = root["numbers"];
+    const OYAJSon::JSonValue constant(copy);
+    root.insert("copy", constant); // Const values can be inserted, and are copied.
+    assert(root["copy"] == constant && &root["copy"][0] != &constant[0]);
+    bool threw = false;
+    try{
+        root.insert("copy", OYAJSon::JSonValue(1));
+    } catch (std::runtime_error &e){
+        threw = true;
+    }
+    assert(threw && root["copy"] == constant);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting emplace_back and emplace construct in place ... ";
+    OYAJSon::JSonValue built(OYAJSon::JSonType_Array);
+    built.emplace_back(5);
+    built.emplace_back(OYAJSon::JSonType_Object).emplace("name", std::string("example"));
+    built[1].emplace("tags", OYAJSon::JSonType_Array).emplace_back(true);
+    assert(built.size() == 2 && built[0].get<int>() == 5);
+    assert(built[1]["name"].get<std::string>() == "example" && built[1]["tags"][0].get<bool>());
+    assert(error_code([&](){ built.emplace("name", 1); }) == OYAJSon::JSonException::ERR_INVALIDJSONTYPE);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting a moved Object keeps allocating from its resource ... ";
+    CountingResource counter;
+    {
+        OYAJSon::Object inResource((OYAJSon::Object::allocator_type(&counter)));
+        inResource["key"] = std::string("a String long enough to be allocated");
+        OYAJSon::JSonValue taken(std::move(inResource));
+        assert(taken["key"].get<std::string>() == "a String long enough to be allocated");
+    }
+    assert(counter.allocations > 0 && counter.outstanding == 0);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+void Test20_StringAccess(){
+    std::cout << "TEST 20: Reading strings and keys without copying them." << std::endl;
+    OYAJSon::JSonValue message;
+    message.parse("{\"type\":\"login\",\"user\":\"someone@example.com\",\"retries\":3}");
+    const OYAJSon::JSonValue& cmessage = message;
+
+    std::cout << "\tTesting String values are viewed in place ... ";
+    OYAJSon::StringView type = cmessage["type"].get<OYAJSon::StringView>();
+    assert(type == "login" && type.size() == 5);
+    assert(type.data() == cmessage["type"].get<const char*>());
+    assert(std::string(cmessage["user"].get<const char*>()) == "someone@example.com");
+    assert(error_code([&](){ cmessage["retries"].get<OYAJSon::StringView>(); }) == OYAJSon::JSonException::ERR_INVALIDJSONTYPE);
+    assert(error_code([&](){ cmessage["retries"].get<const char*>(); }) == OYAJSon::JSonException::ERR_INVALIDJSONTYPE);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting keys are looked up from views ... ";
+    const char buffer[] = "user,type";
+    assert(cmessage.at(OYAJSon::StringView(buffer, 4)).get<std::string>() == "someone@example.com");
+    assert(cmessage.has_key(OYAJSon::StringView(buffer + 5, 4)) && !cmessage.has_key(OYAJSon::StringView(buffer, 3)));
+    assert(error_code([&](){ cmessage.at(OYAJSon::StringView(buffer, 9)); }) == OYAJSon::JSonException::ERR_MISSINGKEY);
+    assert(message[std::string("retries")].get<int>() == 3);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting const iteration over members ... ";
+    std::string keys;
+    for (OYAJSon::Object::const_iterator i = cmessage.begin<OYAJSon::Object::const_iterator>(); i != cmessage.end<OYAJSon::Object::const_iterator>(); i++){
+        OYAJSon::StringView key = i->first.view();
+        keys.append(key.data(), key.size()).append(",");
+    }
+    assert(keys == "type,user,retries,");
+    const OYAJSon::JSonValue list(OYAJSon::Array{1, 2, 3});
+    int sum = 0;
+    for (OYAJSon::Array::const_iterator i = list.begin<OYAJSon::Array::const_iterator>(); i != list.end<OYAJSon::Array::const_iterator>(); i++)
+        sum += i->get<int>();
+    assert(sum == 6);
+    assert(error_code([&](){ list.begin<OYAJSon::Object::const_iterator>(); }) == OYAJSon::JSonException::ERR_INVALIDJSONTYPE);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+
+void Test21_CopyOnWrite(){
+    std::cout << "TEST 21: Sharing copies until they are changed." << std::endl;
+    OYAJSon::JSonValue original;
+    original.parse("{\"users\":[{\"name\":\"Ann\",\"age\":31},{\"name\":\"Bob\",\"age\":42}],\"tags\":[\"a\",\"b\"]}");
+    const OYAJSon::JSonValue& corig = original;
+
+    std::cout << "\tTesting copies refer to the same storage ... ";
+    OYAJSon::JSonValue copy = original;
+    const OYAJSon::JSonValue& ccopy = copy;
+    assert(&ccopy["users"] == &corig["users"] && &ccopy["tags"][1] == &corig["tags"][1]);
+    OYAJSon::JSonValue other = original.copy();
+    assert(other == original && &static_cast<const OYAJSon::JSonValue&>(other)["users"] == &corig["users"]);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting a change copies only the path to it ... ";
+    copy["users"][1]["age"] = 43;
+    assert(corig["users"][1]["age"].get<int>() == 42 && ccopy["users"][1]["age"].get<int>() == 43);
+    assert(&ccopy["users"] != &corig["users"] && &ccopy["users"][0] != &corig["users"][0]);
+    assert(&ccopy["users"][0]["name"] == &corig["users"][0]["name"]);
+    assert(&ccopy["tags"][0] == &corig["tags"][0]);
+    original["tags"].push_back(std::string("c"));
+    assert(corig["tags"].size() == 3 && ccopy["tags"].size() == 2 && other["tags"].size() == 2);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting share() still refers to one value ... ";
+    OYAJSon::JSonValue shared = original["tags"].share();
+    OYAJSon::JSonValue snapshot = shared;
+    shared.push_back(std::string("d"));
+    assert(corig["tags"].size() == 4 && snapshot.size() == 3);
+    snapshot.push_back(std::string("e"));
+    assert(corig["tags"].size() == 4 && shared.size() == 4);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting references taken before a copy don't reach it ... ";
+    OYAJSon::JSonValue a;
+    a.parse("{\"list\":[1,2],\"deep\":{\"inner\":[1]},\"name\":\"a\"}");
+    OYAJSon::JSonValue& listRef = a["list"];
+    OYAJSon::JSonValue& innerRef = a["deep"]["inner"];
+    OYAJSon::JSonValue& nameRef = a.at("name");
+    OYAJSon::Array::iterator first = listRef.begin<OYAJSon::Array::iterator>();
+    OYAJSon::JSonValue b = a;
+    *first = 10;
+    listRef.push_back(3);
+    innerRef.push_back(2);
+    nameRef = std::string("changed");
+    assert(a["list"].size() == 3 && a["list"][0].get<int>() == 10);
+    assert(a["deep"]["inner"].size() == 2);
+    assert(a["name"].get<std::string>() == "changed");
+    assert(b.to_str() == "{\"list\" : [1,2],\"deep\" : {\"inner\" : [1]},\"name\" : \"a\"}");
+    OYAJSon::JSonValue c = a; // Lent containers are copied a level at a time; what's beneath is still shared.
+    const OYAJSon::JSonValue& ca = a;
+    const OYAJSon::JSonValue& cc = c;
+    assert(&cc["list"] != &ca["list"] && &cc["name"] != &ca["name"]);
+    OYAJSon::JSonValue untouched;
+    untouched.parse("{\"x\":{\"y\":[1]}}");
+    OYAJSon::JSonValue& x = untouched["x"];
+    OYAJSon::JSonValue d = untouched;
+    const OYAJSon::JSonValue& cu = untouched;
+    const OYAJSon::JSonValue& cd = d;
+    assert(&cd["x"] != &cu["x"] && &cd["x"]["y"] == &cu["x"]["y"]);
+    x["y"].push_back(2);
+    assert(d["x"]["y"].size() == 1 && untouched["x"]["y"].size() == 2);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting copies are changed independently across threads ... ";
+    OYAJSon::JSonValue base(OYAJSon::JSonType_Array);
+    for (int i = 0; i < 64; i++)
+        base.push_back(OYAJSon::Array{i});
+    std::vector<OYAJSon::JSonValue> copies(4, base);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < copies.size(); t++)
+        threads.push_back(std::thread([&copies, t](){
+            for (int i = 0; i < 64; i++)
+                copies[t][i].push_back(static_cast<int>(t));
+        }));
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+    for (size_t t = 0; t < copies.size(); t++)
+        assert(copies[t][63].size() == 2 && copies[t][63][1].get<int>() == static_cast<int>(t));
+    assert(base[63].size() == 1);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting values copied out of a document are its own ... ";
+    OYAJSon::JSonDocument doc;
+    doc.parse("{\"list\":[1,2,3]}");
+    OYAJSon::JSonValue list = doc.root()["list"];
+    doc.clear();
+    list.push_back(4);
+    assert(list.size() == 4 && list[0].get<int>() == 1);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+void Test22_Frozen(){
+    std::cout << "TEST 22: Freezing values for concurrent readers." << std::endl;
+    OYAJSon::JSonValue config;
+    config.parse("{\"name\":\"api\",\"port\":8080,\"ratio\":0.5,\"debug\":false,\"owner\":null,"
+                 "\"hosts\":[{\"name\":\"a\",\"weight\":1},{\"name\":\"b\",\"weight\":2}]}");
+    OYAJSon::JSonValue wide(OYAJSon::JSonType_Object);
+    for (int i = 0; i < 200; i++)
+        wide.insert("key" + std::to_string(i), i);
+    config.insert("wide", wide);
+
+    std::cout << "\tTesting frozen values read the same as the original ... ";
+    std::shared_ptr<const OYAJSon::JSonFrozen> frozen = OYAJSon::freeze(config);
+    OYAJSon::JSonFrozenValue root = frozen->root();
+    assert(root.is(OYAJSon::JSonType_Object) && root.size() == 7);
+    assert(root["name"].get<std::string>() == "api" && root["name"].get<OYAJSon::StringView>() == "api");
+    assert(root["port"].get<int>() == 8080 && root["ratio"].get<double>() == 0.5 && !root["debug"].get<bool>());
+    assert(root["owner"].is(OYAJSon::JSonType_Null) && root["hosts"].size() == 2);
+    assert(root["hosts"][1]["weight"].get<long long>() == 2 && std::string(root["hosts"][0]["name"].get<const char*>()) == "a");
+    for (int i = 0; i < 200; i++)
+        assert(root["wide"]["key" + std::to_string(i)].get<int>() == i);
+    assert(!root["wide"].has_key("key200") && !root["name"].has_key("key0"));
+    assert(root.key(5) == "hosts" && root.member(5) == root["hosts"]);
+    assert(root.thaw() == config && root.to_str() == config.to_str());
+    assert(frozen->count() == 1 + 7 + 2 * 3 + 200);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting lookups throw like JSonValue's ... ";
+    assert(error_code([&](){ root.at("missing"); }) == OYAJSon::JSonException::ERR_MISSINGKEY);
+    assert(error_code([&](){ root["hosts"][2]; }) == OYAJSon::JSonException::ERR_INDEXOUTOFBOUNDS);
+    assert(error_code([&](){ root["port"]["x"]; }) == OYAJSon::JSonException::ERR_INVALIDJSONTYPE);
+    assert(error_code([&](){ root["port"].get<std::string>(); }) == OYAJSon::JSonException::ERR_INVALIDJSONTYPE);
+    assert(OYAJSon::JSonFrozenValue().is(OYAJSon::JSonType_Null) && OYAJSon::JSonFrozenValue().size() == 0);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting the frozen copy is independent and compact ... ";
+    config["name"] = std::string("changed");
+    assert(root["name"].get<std::string>() == "api");
+    const char* first = root["hosts"][0]["name"].get<const char*>();
+    assert(root["hosts"][1]["name"].get<OYAJSon::StringView>().data() != first);
+    assert(root["hosts"][0].key(0).data() == root.key(0).data());
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting many threads read while the handle is swapped ... ";
+    OYAJSon::JSonFrozenHandle handle(frozen);
+    assert(handle.version() == 1 && handle.load().document == frozen);
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++)
+        readers.push_back(std::thread([&handle, &failed](){
+            for (int i = 0; i < 2000; i++){
+                OYAJSon::JSonFrozenHandle::Snapshot current = handle.load();
+                OYAJSon::JSonFrozenValue r = current.document->root();
+                long long port = current.version == 1 ? 8080 : 8000 + static_cast<long long>(current.version);
+                if (r["wide"]["key150"].get<int>() != 150 || r["port"].get<long long>() != port)
+                    failed = true;
+            }
+        }));
+    for (int v = 2; v <= 50; v++){
+        OYAJSon::JSonValue next = config;
+        next["port"] = 8000 + v;
+        assert(handle.store(OYAJSon::freeze(next)) == static_cast<std::uint64_t>(v));
+    }
+    for (size_t t = 0; t < readers.size(); t++)
+        readers[t].join();
+    assert(!failed);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting compare_exchange only swaps the expected version ... ";
+    OYAJSon::JSonFrozenHandle::Snapshot seen = handle.load();
+    assert(seen.version == 50 && seen.document->root()["port"].get<int>() == 8050);
+    assert(handle.compare_exchange(50, OYAJSon::freeze(OYAJSon::JSonValue(1))));
+    assert(!handle.compare_exchange(50, OYAJSon::freeze(OYAJSon::JSonValue(2))));
+    assert(handle.version() == 51 && handle.load().document->root().get<int>() == 1);
+    assert(seen.document->root()["port"].get<int>() == 8050);
+    OYAJSon::JSonFrozenHandle empty;
+    assert(empty.version() == 0 && !empty.load().document);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+void Test23_Selector(){
+    std::cout << "TEST 23: Parsing only the values selected by JSON Pointers." << std::endl;
+    const std::string message =
+        "{\"meta\":{\"id\":\"m-1\",\"trace\":{\"spans\":[1,2,{\"deep\":[[]]}]}},"
+        "\"payload\":{\"items\":[{\"name\":\"pen\",\"price\":1.5,\"tags\":[\"a\",\"}\"]},{\"price\":2,\"name\":\"ink\\\"\"}],"
+        "\"notes\":\"skip \\\"me\\\" ]}\",\"a/b\":{\"c~d\":true}},\"list\":[10,20,30]}";
+
+    std::cout << "\tTesting selected values are parsed and the rest left out ... ";
+    OYAJSon::JSonValue picked;
+    picked.parse(message, OYAJSon::JSonSelector({"/meta/id", "/payload/items/*/price"}));
+    OYAJSon::JSonValue expected;
+    expected.parse("{\"meta\":{\"id\":\"m-1\"},\"payload\":{\"items\":[{\"price\":1.5},{\"price\":2}]}}");
+    assert(picked == expected);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting indexes, escapes, and whole subtrees ... ";
+    picked.parse(message, OYAJSon::JSonSelector({"/list/1", "/payload/a~1b/c~0d", "/meta/trace"}));
+    expected.parse("{\"meta\":{\"trace\":{\"spans\":[1,2,{\"deep\":[[]]}]}},\"payload\":{\"a/b\":{\"c~d\":true}},\"list\":[20]}");
+    assert(picked == expected);
+    picked.parse(message, OYAJSon::JSonSelector({"/payload/items/1"}));
+    assert(picked["payload"]["items"].size() == 1 && picked["payload"]["items"][0]["name"].get<std::string>() == "ink\"");
+    OYAJSon::JSonValue whole, all;
+    whole.parse(message);
+    all.parse(message, OYAJSon::JSonSelector({""}));
+    assert(all == whole);
+    picked.parse(message, OYAJSon::JSonSelector({"/missing/x", "/list/01", "/meta/id/x"}));
+    expected.parse("{\"meta\":{},\"list\":[]}"); // Containers on the way to a pointer are kept even when it leads nowhere.
+    assert(picked == expected);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting skipped values are never decoded ... ";
+    struct Counter : public OYAJSon::JSonHandler{
+        int strings = 0, keys = 0;
+        bool key(const OYAJSon::StringView &key){keys++; return true;}
+        bool string(const OYAJSon::StringView &value){strings++; return true;}
+    } counter;
+    OYAJSon::JSonParser parser;
+    assert(parser.parse(message, counter, OYAJSon::JSonSelector({"/meta/id"})));
+    assert(counter.keys == 2 && counter.strings == 1);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting malformed strings and pointers are still caught ... ";
+    OYAJSon::JSonSelector selector({"/a"});
+    assert(error_code([&](){ picked.parse("{\"a\":1,\"b\":[1,2}", selector); }) == OYAJSon::JSonException::ERR_PARSE_UNCLOSEDSTURCTURE);
+    assert(error_code([&](){ picked.parse("{\"b\":[[1,2],\"a\":1}", selector); }) == OYAJSon::JSonException::ERR_PARSE_UNCLOSEDSTURCTURE);
+    assert(error_code([&](){ picked.parse("{\"b\":\"open}", selector); }) == OYAJSon::JSonException::ERR_PARSE_UNCLOSEDSTURCTURE);
+    assert(error_code([&](){ picked.parse("{\"b\" 1}", selector); }) == OYAJSon::JSonException::ERR_PARSE_MISSINGSYMBOL);
+    assert(error_code([&](){ picked.parse("{\"a\":1} x", selector); }) == OYAJSon::JSonException::ERR_PARSE_INVALIDSYMBOL);
+    bool threw = false;
+    try{ selector.add("no/slash"); } catch (std::invalid_argument&){ threw = true; }
+    assert(threw && selector.size() == 1);
+    threw = false;
+    try{ selector.add("/bad~2"); } catch (std::invalid_argument&){ threw = true; }
+    assert(threw && selector.size() == 1);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+void Test24_Tape(){
+    std::cout << "TEST 24: Reading values straight from a tape." << std::endl;
+    const std::string body =
+        "{\"user\":{\"id\":\"u-42\",\"name\":\"Ann \\\"A\\\" Lee\"},\"items\":[{\"sku\":\"x\",\"price\":1.25,\"qty\":2},"
+        "{\"sku\":\"y\",\"price\":10,\"qty\":1}],\"flags\":[true,false,null],\"big\":-9223372036854775808,"
+        "\"tab\\tkey\":\"v\", \"empty\":{}, \"none\":[]}";
+    OYAJSon::JSonTape tape;
+
+    std::cout << "\tTesting values are read as JSonValue would ... ";
+    tape.parse(body);
+    OYAJSon::JSonCursor root = tape.root();
+    assert(root.is(OYAJSon::JSonType_Object) && root.size() == 7);
+    assert(root["user"]["id"].get<OYAJSon::StringView>() == "u-42");
+    assert(root["user"]["name"].get<std::string>() == "Ann \"A\" Lee" && root["user"]["name"].size() == 11);
+    assert(std::string(root["user"]["id"].get<const char*>()) == "u-42");
+    assert(root["items"][1]["price"].get<int>() == 10 && root["items"][0]["price"].get<double>() == 1.25);
+    assert(root["big"].get<long long>() == std::numeric_limits<long long>::min());
+    assert(root["flags"][0].get<bool>() && !root["flags"][1].get<bool>() && root["flags"][2].is(OYAJSon::JSonType_Null));
+    assert(root["tab\tkey"].get<std::string>() == "v" && root.has_key("empty") && !root.has_key("emptyx"));
+    assert(root["empty"].size() == 0 && root["none"].size() == 0 && root["none"].begin() == root["none"].end());
+    OYAJSon::JSonValue value;
+    value.parse(body);
+    assert(root.to_value() == value && root.to_str() == value.to_str());
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting iteration over members and elements ... ";
+    std::string keys;
+    for (OYAJSon::JSonCursor::iterator i = root.begin(); i != root.end(); i++)
+        keys += i.key().str() + ",";
+    assert(keys == "user,items,flags,big,tab\tkey,empty,none,");
+    double total = 0;
+    for (OYAJSon::JSonCursor::iterator i = root["items"].begin(); i != root["items"].end(); ++i)
+        total += (*i)["price"].get<double>() * (*i)["qty"].get<int>();
+    assert(total == 12.5);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting repeated keys read as JSonValue::parse reads them ... ";
+    const std::string repeated = "{\"a\":1,\"b\":{\"c\":[1],\"c\":[2,3]},\"\\u0061\":3}";
+    OYAJSon::JSonTape repeatedTape;
+    OYAJSon::JSonCursor dup = repeatedTape.parse(repeated).root();
+    OYAJSon::JSonValue parsed;
+    parsed.parse(repeated);
+    assert(dup["a"].get<int>() == parsed["a"].get<int>() && dup["a"].get<int>() == 3);
+    assert(dup["b"]["c"].size() == parsed["b"]["c"].size() && dup["b"]["c"][1].get<int>() == 3);
+    assert(dup.to_value() == parsed && dup.to_str() == parsed.to_str());
+    assert(dup.to_str() == "{\"a\" : 3,\"b\" : {\"c\" : [2,3]}}");
+    assert(dup.size() == 3 && parsed.size() == 2); // Members are counted as written.
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting lookups throw like JSonValue's ... ";
+    assert(error_code([&](){ root.at("missing"); }) == OYAJSon::JSonException::ERR_MISSINGKEY);
+    assert(error_code([&](){ root["items"][2]; }) == OYAJSon::JSonException::ERR_INDEXOUTOFBOUNDS);
+    assert(error_code([&](){ root["user"][0]; }) == OYAJSon::JSonException::ERR_INVALIDJSONTYPE);
+    assert(error_code([&](){ root["big"].get<std::string>(); }) == OYAJSon::JSonException::ERR_INVALIDJSONTYPE);
+    assert(error_code([&](){ root["big"].begin(); }) == OYAJSon::JSonException::ERR_INVALIDJSONTYPE);
+    assert(OYAJSon::JSonCursor().is(OYAJSon::JSonType_Null) && OYAJSon::JSonTape().root().is(OYAJSon::JSonType_Null));
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting structure is checked as JSonParser does ... ";
+    const char* bad[] = {"", "5", "{\"a\":1", "{\"a\" 1}", "{\"a\":}", "[1,]", "[1 2]", "{\"a\":1} x", "{\"a\":\"open}", "{\"a\":nope}", "[1}"};
+    for (size_t b = 0; b < sizeof(bad) / sizeof(bad[0]); b++){
+        OYAJSon::JSonParser parser;
+        OYAJSon::JSonHandler ignore;
+        unsigned int expected = error_code([&](){ parser.parse(bad[b], ignore); });
+        assert(expected != 0 && error_code([&](){ tape.parse(bad[b]); }) == expected);
+    }
+    assert(tape.root().is(OYAJSon::JSonType_Null));
+    tape.parse("[1.5e, \"\\q\", 2]"); // Numbers and escapes are only checked when read.
+    assert(tape.root()[2].get<int>() == 2);
+    assert(error_code([&](){ tape.root()[0].get<double>(); }) == OYAJSon::JSonException::ERR_PARSE_UNKNOWNVALUETYPE);
+    assert(error_code([&](){ tape.root()[1].get<std::string>(); }) == OYAJSon::JSonException::ERR_PARSE_MALFORMED);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+void Test25_Reuse(){
+    std::cout << "TEST 25: Reusing memory from one parse to the next." << std::endl;
+    std::string message = "{\"id\":7,\"items\":[";
+    for (int i = 0; i < 2000; i++)
+        message += (i > 0 ? "," : "") + std::string("{\"name\":\"item\\t") + std::to_string(i) + "\",\"price\":" + std::to_string(i) + ".5}";
+    message += "]}";
+
+    std::cout << "\tTesting an arena reset keeps its memory ... ";
+    CountingResource upstream;
+    OYAJSon::JSonArena arena(1024, &upstream);
+    for (int i = 0; i < 100; i++)
+        arena.allocate(100);
+    OYAJSon::size_type capacity = arena.capacity();
+    assert(arena.blocks() > 1);
+    arena.reset();
+    assert(arena.used() == 0 && upstream.outstanding == 0);
+    for (int i = 0; i < 100; i++)
+        arena.allocate(100);
+    std::size_t allocations = upstream.allocations;
+    assert(arena.blocks() == 1 && arena.capacity() >= capacity);
+    arena.reset();
+    for (int i = 0; i < 100; i++)
+        arena.allocate(100);
+    assert(upstream.allocations == allocations && arena.blocks() == 1);
+    arena.release();
+    assert(upstream.outstanding == 0 && arena.capacity() == 0);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting a document stops allocating once warmed up ... ";
+    CountingResource docUpstream;
+    OYAJSon::JSonDocument doc(OYAJSon::JSonArena::DEFAULT_BLOCK_SIZE, &docUpstream);
+    doc.parse(message);
+    doc.parse(message);
+    allocations = docUpstream.allocations;
+    for (int i = 0; i < 10; i++){
+        doc.parse(message);
+        assert(doc.root()["items"][1999]["name"].get<std::string>() == "item\t1999");
+    }
+    assert(docUpstream.allocations == allocations && doc.arena().blocks() == 1);
+    assert(error_code([&](){ doc.parse("{\"a\":[1,2"); }) == OYAJSon::JSonException::ERR_PARSE_UNCLOSEDSTURCTURE);
+    assert(doc.root().is(OYAJSon::JSonType_Null));
+    doc.parse(message);
+    assert(docUpstream.allocations == allocations && doc.root()["id"].get<int>() == 7);
+    doc.reset();
+    assert(doc.root().is(OYAJSon::JSonType_Null) && doc.arena().capacity() > 0 && docUpstream.outstanding > 0);
+    doc.clear();
+    assert(doc.arena().capacity() == 0 && docUpstream.outstanding == 0);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting documents with interned keys and changed trees reset cleanly ... ";
+    OYAJSon::JSonDocument interned(OYAJSon::JSonArena::DEFAULT_BLOCK_SIZE, nullptr, true);
+    for (int i = 0; i < 3; i++){
+        interned.parse(message);
+        assert(interned.key_pool().size() == 4);
+        interned.mutable_root()["extra"] = std::string("heap");
+    }
+    interned.reset();
+    assert(interned.key_pool().size() == 0);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting JSonValue::parse is unaffected by a failed parse ... ";
+    OYAJSon::JSonValue value;
+    value.parse(message);
+    assert(error_code([&](){ value.parse("{\"a\":[1,{\"b\":2}"); }) == OYAJSon::JSonException::ERR_PARSE_UNCLOSEDSTURCTURE);
+    assert(value["items"].size() == 2000);
+    value.parse("{\"a\":[1]}");
+    assert(value.to_str() == "{\"a\" : [1]}");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+void Test26_TryParse(){
+    std::cout << "TEST 26: Parsing without exceptions." << std::endl;
+
+    std::cout << "\tTesting a valid string parses ... ";
+    OYAJSon::JSonValue value;
+    OYAJSon::JSonParseResult result = value.try_parse(std::string("{\"a\":[1,2],\"b\":\"x\"}"));
+    assert(result && result.ok() && result.code == 0 && result.message.empty());
+    assert(value["a"][1].get<int>() == 2 && value["b"].get<std::string>() == "x");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting errors match those parse throws ... ";
+    const char* malformed[] = {"", "  7", "{\"a\":1} x", "{\"a\" 1}", "{\"a\":}", "[1 2]", "[1,]", "{\"a\":[1,2}",
+                               "[\"abc", "[\"a\\q\"]", "[tru]", "[-]", "{1:2}", "[1,{\"a\":[2,{\"b\":3}]"};
+    for (const char* src : malformed){
+        unsigned int code = 0;
+        std::string message;
+        try{ OYAJSon::JSonValue().parse(src); } catch (const OYAJSon::JSonException &e){ code = e.get_code(); message = e.what(); }
+        result = value.try_parse(std::string(src));
+        assert(!result && result.code == code && result.message == message);
+    }
+    assert(value["b"].get<std::string>() == "x");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting errors are located ... ";
+    std::string src = "{\n  \"a\": 1,\n  \"b\": tru\n}";
+    result = value.try_parse(src);
+    assert(result.code == OYAJSon::JSonException::ERR_PARSE_UNKNOWNVALUETYPE);
+    assert(result.offset == src.find("tru") && result.line == 3 && result.column == 8);
+    result = value.try_parse(std::string("[1,,2]"));
+    assert(result.code == OYAJSon::JSonException::ERR_PARSE_MISSINGVALUE && result.offset == 3 && result.line == 1 && result.column == 4);
+    result = value.try_parse(std::string("[\"a\\qb\"]"));
+    assert(result.code == OYAJSon::JSonException::ERR_PARSE_MALFORMED && result.offset == 3);
+    src = "{\"a\":[1,2\n";
+    result = value.try_parse(src);
+    assert(result.code == OYAJSon::JSonException::ERR_PARSE_UNCLOSEDSTURCTURE && result.offset == src.size());
+    assert(result.line == 2 && result.column == 1);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting JSonParser and JSonDocument ... ";
+    struct Stopper : public OYAJSon::JSonHandler{
+        bool number_int(long long){return false;}
+    } stopper;
+    OYAJSon::JSonParser parser;
+    assert(parser.try_parse(std::string("[1,"), stopper).ok());
+    result = parser.try_parse(std::string("[\"a\",x]"), stopper);
+    assert(result.code == OYAJSon::JSonException::ERR_PARSE_UNKNOWNVALUETYPE && result.offset == 5);
+    OYAJSon::JSonSelector selector({"/b"});
+    OYAJSon::JSonValueBuilder builder;
+    result = parser.try_parse(std::string("{\"a\":[1,2]],\"b\":2}"), builder, selector);
+    assert(result.code == OYAJSon::JSonException::ERR_PARSE_MISSINGSYMBOL && result.offset == 10);
+    builder.reset();
+
+    OYAJSon::JSonDocument doc;
+    assert(doc.try_parse(std::string("{\"a\":[1,2]}")).ok() && doc.root()["a"].size() == 2);
+    result = doc.try_parse(std::string("{\"a\":[1,2]"));
+    assert(result.code == OYAJSon::JSonException::ERR_PARSE_UNCLOSEDSTURCTURE && doc.root().is(OYAJSon::JSonType_Null));
+    assert(doc.try_parse(std::string("{\"a\":3}")).ok() && doc.root()["a"].get<int>() == 3);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+void Test27_Limits(){
+    std::cout << "TEST 27: Parse limits and deep nesting." << std::endl;
+    auto nested = [](std::size_t depth){ return std::string(depth, '[') + std::string(depth, ']'); };
+
+    std::cout << "\tTesting nesting is bounded by max_depth ... ";
+    OYAJSon::JSonParser parser(OYAJSon::JSonParseLimits(8));
+    OYAJSon::JSonValueBuilder builder;
+    assert(parser.limits().max_depth == 8 && parser.limits().max_size == OYAJSon::JSonParseLimits::NO_LIMIT);
+    assert(parser.try_parse(nested(8), builder).ok());
+    assert(builder.value()[0][0][0][0][0][0][0].size() == 0);
+    builder.reset();
+    OYAJSon::JSonParseResult result = parser.try_parse(std::string("{\"a\":[[{\"b\":[[[[[1]]]]]}]]}"), builder);
+    assert(result.code == OYAJSon::JSonException::ERR_PARSE_TOODEEP && result.offset == 16);
+    builder.reset();
+    assert(error_code([&](){ parser.parse(nested(9), builder); }) == OYAJSon::JSonException::ERR_PARSE_TOODEEP);
+    builder.reset();
+    assert(parser.try_parse(std::string("[[1],[2]]"), builder).ok() && builder.value().to_str() == "[[1],[2]]");
+    builder.reset();
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting JSonValue::parse uses the default depth ... ";
+    OYAJSon::JSonValue value;
+    value.parse(nested(OYAJSon::JSonParseLimits::DEFAULT_MAX_DEPTH));
+    assert(error_code([&](){ value.parse(nested(OYAJSon::JSonParseLimits::DEFAULT_MAX_DEPTH + 1)); }) == OYAJSon::JSonException::ERR_PARSE_TOODEEP);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting deep nesting doesn't use the call stack ... ";
+    OYAJSon::JSonParser unlimited(OYAJSon::JSonParseLimits(OYAJSon::JSonParseLimits::NO_LIMIT));
+    OYAJSon::JSonHandler ignore;
+    assert(unlimited.try_parse(nested(1000000), ignore).ok());
+    result = unlimited.try_parse(std::string(1000000, '[') + "1" + std::string(999999, ']'), ignore);
+    assert(result.code == OYAJSon::JSonException::ERR_PARSE_UNCLOSEDSTURCTURE && result.offset == 2000000);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting strings are bounded by max_size ... ";
+    parser.set_limits(OYAJSon::JSonParseLimits(OYAJSon::JSonParseLimits::DEFAULT_MAX_DEPTH, 9));
+    assert(parser.try_parse(std::string("[1,2,3,4]"), builder).ok());
+    builder.reset();
+    result = parser.try_parse(std::string("[1,2,3,45]"), builder);
+    assert(result.code == OYAJSon::JSonException::ERR_PARSE_TOOLARGE && result.offset == 9);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting selectors and documents keep to the limits ... ";
+    parser.set_limits(OYAJSon::JSonParseLimits(4));
+    OYAJSon::JSonSelector selector({"/a/0"});
+    assert(parser.try_parse(std::string("{\"a\":[[[1]]],\"b\":[[[2]]]}"), builder, selector).ok());
+    builder.reset();
+    result = parser.try_parse(std::string("{\"a\":[1],\"b\":[[[[2]]]]}"), builder, selector);
+    assert(result.code == OYAJSon::JSonException::ERR_PARSE_TOODEEP && result.offset == 16);
+    builder.reset();
+    result = parser.try_parse(std::string("{\"a\":[[[[1]]]]}"), builder, selector);
+    assert(result.code == OYAJSon::JSonException::ERR_PARSE_TOODEEP && result.offset == 8);
+    builder.reset();
+
+    OYAJSon::JSonDocument doc;
+    doc.set_limits(OYAJSon::JSonParseLimits(2));
+    assert(doc.limits().max_depth == 2);
+    assert(doc.try_parse(std::string("{\"a\":[1]}")).ok());
+    assert(error_code([&](){ doc.parse("{\"a\":[[1]]}"); }) == OYAJSon::JSonException::ERR_PARSE_TOODEEP);
+    assert(doc.root().is(OYAJSon::JSonType_Null));
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting push parsers keep to the limits ... ";
+    OYAJSon::JSonPushParser push(builder);
+    assert(push.limits().max_depth == OYAJSon::JSonParseLimits::DEFAULT_MAX_DEPTH);
+    assert(error_code([&](){ push.feed(nested(1000000)); }) == OYAJSon::JSonException::ERR_PARSE_TOODEEP);
+    builder.reset();
+    push.reset();
+    push.set_limits(OYAJSon::JSonParseLimits(3, 12));
+    assert(push.feed(std::string("[[[1],")) && push.feed(std::string("[2]]]")) && push.finish());
+    assert(builder.value().to_str() == "[[[1],[2]]]");
+    builder.reset();
+    push.reset();
+    assert(push.feed(std::string("[[")));
+    assert(error_code([&](){ push.feed(std::string("[[1]]]]")); }) == OYAJSon::JSonException::ERR_PARSE_TOODEEP);
+    builder.reset();
+    push.reset();
+    assert(push.feed(std::string("[1,2,3,")));
+    assert(error_code([&](){ push.feed(std::string("4,5,6]")); }) == OYAJSon::JSonException::ERR_PARSE_TOOLARGE);
+    builder.reset();
+    OYAJSon::JSonPushParser limited(builder, OYAJSon::JSonParseLimits(1));
+    assert(limited.limits().max_depth == 1);
+    assert(error_code([&](){ limited.feed(std::string("{\"a\":{}}")); }) == OYAJSon::JSonException::ERR_PARSE_TOODEEP);
+    builder.reset();
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting tapes keep to the limits ... ";
+    OYAJSon::JSonTape tape;
+    std::string deep = nested(1000000);
+    assert(error_code([&](){ tape.parse(deep); }) == OYAJSon::JSonException::ERR_PARSE_TOODEEP);
+    assert(tape.root().is(OYAJSon::JSonType_Null));
+    std::string shallow = nested(OYAJSon::JSonParseLimits::DEFAULT_MAX_DEPTH);
+    assert(tape.parse(shallow).root().to_str() == shallow);
+    tape.set_limits(OYAJSon::JSonParseLimits(2, 8));
+    assert(tape.limits().max_depth == 2 && tape.limits().max_size == 8);
+    std::string fits = "[[1],[]]";
+    std::string tooDeep = "[[[]]]";
+    std::string tooLarge = "[[1],[2]]";
+    assert(tape.parse(fits).root()[0][0].get<int>() == 1);
+    assert(error_code([&](){ tape.parse(tooDeep); }) == OYAJSon::JSonException::ERR_PARSE_TOODEEP);
+    assert(error_code([&](){ tape.parse(tooLarge); }) == OYAJSon::JSonException::ERR_PARSE_TOOLARGE);
+    OYAJSon::JSonTape limitedTape(OYAJSon::JSonParseLimits(1));
+    assert(error_code([&](){ limitedTape.parse(fits); }) == OYAJSon::JSonException::ERR_PARSE_TOODEEP);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
+void Test28_Unicode(){
+    std::cout << "TEST 28: Unicode escapes and UTF-8 validation." << std::endl;
+
+    std::cout << "\tTesting \\u escapes decode to UTF-8 ... ";
+    OYAJSon::JSonValue value;
+    value.parse("[\"caf\\u00e9\", \"\\u20AC5\", \"\\uD83D\\uDE00!\", \"a\\u0000b\", \"\\u0041\\n\\u00C9\"]");
+    assert(value[0].get<std::string>() == "caf\xc3\xa9");
+    assert(value[1].get<std::string>() == "\xe2\x82\xac" "5");
+    assert(value[2].get<std::string>() == "\xf0\x9f\x98\x80!");
+    assert(value[3].get<std::string>() == std::string("a\0b", 3));
+    assert(value[4].get<std::string>() == "A\n\xc3\x89");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting invalid \\u escapes are rejected ... ";
+    const char* escapes[] = {"[\"\\uD83D\"]", "[\"\\uD83Dx\"]", "[\"\\uD83D\\n\"]", "[\"\\uD83D\\u0041\"]", "[\"\\uDE00\"]",
+                             "[\"\\u12G4\"]", "[\"\\u12\"]", "[\"ab\\u\"]"};
+    for (const char* src : escapes){
+        OYAJSon::JSonParseResult result = value.try_parse(std::string(src));
+        assert(result.code == OYAJSon::JSonException::ERR_PARSE_MALFORMED && result.offset == std::string(src).find('\\'));
+    }
+    assert(parse_error_code("[\"\\u12") == OYAJSon::JSonException::ERR_PARSE_UNCLOSEDSTURCTURE);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting control characters are written back as escapes ... ";
+    value.parse("[\"\\u0001\\u001f\\t\"]");
+    assert(value.to_str() == "[\"\\u0001\\u001f\\t\"]");
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting invalid UTF-8 is rejected ... ";
+    value.parse("{\"\xc3\xa9t\xc3\xa9\":\"\xe6\x97\xa5\xe6\x9c\xac \xf0\x9f\x98\x80\"}");
+    assert(value["\xc3\xa9t\xc3\xa9"].get<std::string>() == "\xe6\x97\xa5\xe6\x9c\xac \xf0\x9f\x98\x80");
+    const char* encodings[] = {"[\"\xff\"]", "[\"\xc0\xaf\"]", "[\"\xed\xa0\x80\"]", "[\"\xf4\x90\x80\x80\"]", "[\"\xe2\x82\"]", "[\"\x80\"]", "[1]\xe2\x82"};
+    for (const char* src : encodings){
+        OYAJSon::JSonParseResult result = value.try_parse(std::string(src));
+        assert(result.code == OYAJSon::JSonException::ERR_PARSE_INVALIDENCODING);
+        assert(result.offset == std::string(src).find_first_of("\x80\xaf\xc0\xe2\xed\xf4\xff"));
+    }
+    std::string text;
+    for (int i = 0; i < 100; i++)
+        text += "ascii \xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80 ";
+    assert(OYAJSon::JSonFindInvalidUtf8(text.data(), text.size()) == text.data() + text.size());
+    for (std::size_t at : {std::size_t(0), std::size_t(31), std::size_t(32), std::size_t(776), text.size() - 1}){
+        std::string broken = text;
+        broken[at] = '\xf8';
+        assert(OYAJSon::JSonFindInvalidUtf8(broken.data(), broken.size()) == broken.data() + at);
+    }
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting escapes and UTF-8 split across chunks ... ";
+    std::string src = "{\"k\\u00e9\":[\"x\\uD83D\\uDE00y\",\"\xf0\x9f\x98\x80\xc3\xa9\\\\\"]}";
+    OYAJSon::JSonValue expected;
+    expected.parse(src);
+    for (std::size_t split = 0; split <= src.size(); split++){
+        OYAJSon::JSonValueBuilder builder;
+        OYAJSon::JSonPushParser parser(builder);
+        parser.feed(src.data(), split);
+        parser.feed(src.data() + split, src.size() - split);
+        parser.finish();
+        assert(builder.value() == expected);
+    }
+    for (std::size_t split = 1; split < 6; split++){
+        OYAJSon::JSonValueBuilder builder;
+        OYAJSon::JSonPushParser parser(builder);
+        std::string bad = "[\"\xe2\x82\x41\"]";
+        assert(error_code([&](){ parser.feed(bad.data(), split); parser.feed(bad.data() + split, bad.size() - split); parser.finish(); }) ==
+               OYAJSon::JSonException::ERR_PARSE_INVALIDENCODING);
+    }
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTesting JSonTape decodes and validates the same way ... ";
+    OYAJSon::JSonTape tape;
+    tape.parse(src);
+    assert(tape.root()["k\xc3\xa9"][0].get<std::string>() == "x\xf0\x9f\x98\x80y");
+    assert(tape.root()["k\xc3\xa9"][1].get<std::string>() == "\xf0\x9f\x98\x80\xc3\xa9\\");
+    assert(error_code([&](){ tape.parse(std::string("[\"\xc0\xaf\"]")); }) == OYAJSon::JSonException::ERR_PARSE_INVALIDENCODING);
+    std::string lone = "[\"\\uDE00\"]";
+    tape.parse(lone);
+    assert(error_code([&](){ tape.root()[0].get<std::string>(); }) == OYAJSon::JSonException::ERR_PARSE_MALFORMED);
+    std::cout << "Success!" << std::endl;
+
+    std::cout << "\tTEST COMPLETE" << std::endl << std::endl;
+}
+
 int main()
 {
     std::cout << "Tests for ObsidianBlk's Yet Another JSon library (" << OYAJSON_VERSION << ")" << std::endl;
@@ -160,6 +1907,31 @@ int main()
     Test01_CreateInstance();
     Test02_ParseInstance();
     Test03_ObjectViaSubscription();
+    Test04_ParseNested();
+    Test05_ParseInPlace();
+    Test06_ParseEvents();
+    Test07_PushParser();
+    Test08_NDJSonReader();
+    Test09_ParseFile();
+    Test10_StructuralIndex();
+    Test11_ParseNumbers();
+    Test12_SerializeNumbers();
+    Test13_Writer();
+    Test14_ValueLayout();
+    Test15_Document();
+    Test16_AllocatorResource();
+    Test17_ObjectMembers();
+    Test18_KeyPool();
+    Test19_MoveSemantics();
+    Test20_StringAccess();
+    Test21_CopyOnWrite();
+    Test22_Frozen();
+    Test23_Selector();
+    Test24_Tape();
+    Test25_Reuse();
+    Test26_TryParse();
+    Test27_Limits();
+    Test28_Unicode();
 
     std::cout << "------------ All Test Completed ------------" << std::endl << std::endl;
     return 0;
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+#
+# Generates OYAJSon_NumberTables.h, the tables used to convert between decimal strings and doubles.
+#
+#   POW5_128    - 5^q for q in [-342, 308], normalized and truncated to 128 bits (reciprocals rounded up for q < 0).
+#                 Used by the Eisel-Lemire conversion from decimal to double.
+#   CACHED_POW10 - 10^k for every 8th k in [-300, 324], as a normalized 64 bit significand and binary exponent.
+#                 Used by the Grisu2 conversion from double to decimal.
+#
+# Usage: number_tables.py [base path]
+
+import os
+import sys
+
+POW5_MIN = -342
+POW5_MAX = 308
+
+POW10_MIN = -300
+POW10_MAX = 324
+POW10_STEP = 8
+
+
+def pow5_128(q):
+    if q >= 0:
+        p = 5 ** q
+        while p < (1 << 127):
+            p *= 2
+        while p >= (1 << 128):
+            p //= 2
+        return p
+
+    p = 5 ** -q
+    z = p.bit_length()
+    if q >= -27:
+        c = 2 ** (z + 127) // p + 1
+    else:
+        c = 2 ** (2 * z + 128) // p + 1
+        while c >= (1 << 128):
+            c //= 2
+    return c
+
+
+def cached_pow10(k):
+    # Returns (f, e) with 10^k ~= f * 2^e and 2^63 <= f < 2^64, f rounded to nearest.
+    if k >= 0:
+        p = 10 ** k
+        e = p.bit_length() - 64
+        if e >= 0:
+            f = (p + (1 << e >> 1)) >> e if e > 0 else p
+        else:
+            f = p << -e
+    else:
+        d = 10 ** -k
+        e = -d.bit_length() - 63
+        f = ((1 << -e) + d // 2) // d
+    if f >= (1 << 64):
+        f >>= 1
+        e += 1
+    return f, e
+
+
+def main():
+    base = sys.argv[1] if len(sys.argv) > 1 else os.getcwd()
+    path = os.path.join(base, "OYAJSon_NumberTables.h")
+
+    lines = []
+    lines.append("/* This is an automatically generated file. Do not modify! */")
+    lines.append("/* Generated by scripts/number_tables.py */")
+    lines.append("#ifndef __OYAJSON_NUMBERTABLES_H__")
+    lines.append("#define __OYAJSON_NUMBERTABLES_H__")
+    lines.append("")
+    lines.append("#include <cstdint>")
+    lines.append("")
+    lines.append("namespace OYAJSon {")
+    lines.append("")
+    lines.append("    static const int POW5_128_MIN = %d;" % POW5_MIN)
+    lines.append("    static const int POW5_128_MAX = %d;" % POW5_MAX)
+    lines.append("")
+    lines.append("    // 5^q for q in [POW5_128_MIN, POW5_128_MAX], as pairs of (high, low) 64 bit words.")
+    lines.append("    static const std::uint64_t POW5_128[] = {")
+    for q in range(POW5_MIN, POW5_MAX + 1):
+        c = pow5_128(q)
+        lines.append("        0x%016xULL, 0x%016xULL, // 5^%d" % (c >> 64, c & 0xFFFFFFFFFFFFFFFF, q))
+    lines.append("    };")
+    lines.append("")
+    lines.append("    static const int CACHED_POW10_MIN = %d;" % POW10_MIN)
+    lines.append("    static const int CACHED_POW10_STEP = %d;" % POW10_STEP)
+    lines.append("")
+    lines.append("    struct _CachedPower{")
+    lines.append("        std::uint64_t f;")
+    lines.append("        int e;")
+    lines.append("        int k;")
+    lines.append("    };")
+    lines.append("")
+    lines.append("    // 10^k ~= f * 2^e for every CACHED_POW10_STEP'th k from CACHED_POW10_MIN.")
+    lines.append("    static const _CachedPower CACHED_POW10[] = {")
+    for k in range(POW10_MIN, POW10_MAX + 1, POW10_STEP):
+        f, e = cached_pow10(k)
+        lines.append("        {0x%016xULL, %d, %d}," % (f, e, k))
+    lines.append("    };")
+    lines.append("")
+    lines.append("}")
+    lines.append("")
+    lines.append("#endif")
+
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+    print("FILE %s GENERATED SUCCESSFULLY" % path)
+
+
+if __name__ == "__main__":
+    main()